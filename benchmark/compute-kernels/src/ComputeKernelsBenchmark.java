@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class ComputeKernelsBenchmark {
+    private static final int SIZE = 1024;
+
+    private static final double[] doubles1 = new double[SIZE];
+    private static final double[] doubles2 = new double[SIZE];
+    private static final float[] floats = new float[SIZE];
+    private static final int[] ints = new int[SIZE];
+
+    static {
+        for (int i = 0; i < SIZE; ++i) {
+            doubles1[i] = i * 0.5;
+            doubles2[i] = (SIZE - i) * 0.25;
+            floats[i] = i * 0.125f;
+            ints[i] = i * 0x9e3779b9;
+        }
+    }
+
+    public void timeDotProduct(int count) {
+        double result = 0.0;
+        for (int i = 0; i < count; ++i) {
+            result += $noinline$dotProduct(doubles1, doubles2);
+        }
+        if (result == 42.0) {
+            System.out.println(result);
+        }
+    }
+
+    public void timeTwoAccumulatorSum(int count) {
+        float result = 0.0f;
+        for (int i = 0; i < count; ++i) {
+            result += $noinline$twoAccumulatorSum(floats);
+        }
+        if (result == 42.0f) {
+            System.out.println(result);
+        }
+    }
+
+    public void timePolynomial(int count) {
+        double result = 0.0;
+        for (int i = 0; i < count; ++i) {
+            result += $noinline$polynomial(doubles1);
+        }
+        if (result == 42.0) {
+            System.out.println(result);
+        }
+    }
+
+    public void timeMix(int count) {
+        int result = 0;
+        for (int i = 0; i < count; ++i) {
+            result += $noinline$mix(ints);
+        }
+        if (result == 42) {
+            System.out.println(result);
+        }
+    }
+
+    public void timeDivide(int count) {
+        double result = 0.0;
+        for (int i = 0; i < count; ++i) {
+            result += $noinline$divide(doubles1, doubles2);
+        }
+        if (result == 42.0) {
+            System.out.println(result);
+        }
+    }
+
+    private static double $noinline$dotProduct(double[] a, double[] b) {
+        double sum = 0.0;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    private static float $noinline$twoAccumulatorSum(float[] a) {
+        float sum1 = 0.0f;
+        float sum2 = 0.0f;
+        for (int i = 0; i + 1 < a.length; i += 2) {
+            sum1 += a[i] * a[i];
+            sum2 += a[i + 1] * a[i + 1];
+        }
+        return sum1 + sum2;
+    }
+
+    private static double $noinline$polynomial(double[] a) {
+        double sum = 0.0;
+        for (int i = 0; i < a.length; ++i) {
+            double x = a[i];
+            sum += ((0.5 * x + 0.25) * x + 0.125) * x + 1.0;
+        }
+        return sum;
+    }
+
+    private static int $noinline$mix(int[] a) {
+        int h1 = 0x12345678;
+        int h2 = 0x9abcdef0;
+        for (int i = 0; i < a.length; ++i) {
+            h1 ^= a[i];
+            h1 = Integer.rotateLeft(h1 * 0xcc9e2d51, 15) * 0x1b873593;
+            h2 += a[a.length - 1 - i];
+            h2 = (h2 ^ (h2 >>> 16)) * 0x85ebca6b;
+        }
+        return h1 ^ h2;
+    }
+
+    private static double $noinline$divide(double[] a, double[] b) {
+        double sum = 0.0;
+        for (int i = 0; i < a.length; ++i) {
+            sum += a[i] / b[i] + a[i] * b[i];
+        }
+        return sum;
+    }
+}
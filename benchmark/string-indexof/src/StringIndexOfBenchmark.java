@@ -113,6 +113,59 @@ public class StringIndexOfBenchmark {
         }
     }
 
+    // Long strings exercise the vectorized scan rather than its setup cost. The search
+    // char is last, so the whole string is scanned.
+    public static final String longCompressed = makeLongString('0', '_');
+    public static final String longUncompressed = makeLongString('\u0100', '\u2020');
+    public static final String longCompressedCopy = new String(longCompressed.toCharArray());
+    public static final String longUncompressedCopy = new String(longUncompressed.toCharArray());
+
+    public void timeIndexOfLongCompressed(int count) {
+        final char c = '_';
+        String s = longCompressed;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeIndexOfLongUncompressed(int count) {
+        final char c = '\u2020';
+        String s = longUncompressed;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeEqualsLongCompressed(int count) {
+        String s1 = longCompressed;
+        String s2 = longCompressedCopy;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s1, s2);
+        }
+    }
+
+    public void timeEqualsLongUncompressed(int count) {
+        String s1 = longUncompressed;
+        String s2 = longUncompressedCopy;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s1, s2);
+        }
+    }
+
+    private static String makeLongString(char first, char last) {
+        char[] chars = new char[1000];
+        for (int i = 0; i < chars.length; ++i) {
+            chars[i] = (char) (first + (i % 26));
+        }
+        chars[chars.length - 1] = last;
+        return new String(chars);
+    }
+
+    static boolean $noinline$equals(String s1, String s2) {
+        if (doThrow) { throw new Error(); }
+        return s1.equals(s2);
+    }
+
     static int $noinline$indexOf(String s, char c) {
         if (doThrow) { throw new Error(); }
         return s.indexOf(c);
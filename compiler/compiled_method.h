@@ -81,6 +81,8 @@ class CompiledCode {
     return storage_;
   }
 
+  void ReleaseQuickCode();
+
   template <typename BitFieldType>
   typename BitFieldType::value_type GetPackedField() const {
     return BitFieldType::Decode(packed_fields_);
@@ -98,7 +100,7 @@ class CompiledCode {
   CompiledMethodStorage* const storage_;
 
   // Used to store the compiled code.
-  const LengthPrefixedArray<uint8_t>* const quick_code_;
+  const LengthPrefixedArray<uint8_t>* quick_code_;
 
   uint32_t packed_fields_;
 };
@@ -145,6 +147,13 @@ class CompiledMethod final : public CompiledCode {
 
   ArrayRef<const linker::LinkerPatch> GetPatches() const;
 
+  // Release the code and linker patches once they have been written out. The compiled
+  // method then looks like it has no code; only the vmap table and CFI remain usable.
+  void ReleaseCodeAndPatches();
+
+  // Release the vmap table and CFI once they have been written out.
+  void ReleaseVmapTableAndCFIInfo();
+
  private:
   static constexpr size_t kIsIntrinsicLsb = kNumberOfCompiledCodePackedBits;
   static constexpr size_t kIsIntrinsicSize = 1u;
@@ -155,11 +164,11 @@ class CompiledMethod final : public CompiledCode {
   using IsIntrinsicField = BitField<bool, kIsIntrinsicLsb, kIsIntrinsicSize>;
 
   // For quick code, holds code infos which contain stack maps, inline information, and etc.
-  const LengthPrefixedArray<uint8_t>* const vmap_table_;
+  const LengthPrefixedArray<uint8_t>* vmap_table_;
   // For quick code, a FDE entry for the debug_frame section.
-  const LengthPrefixedArray<uint8_t>* const cfi_info_;
+  const LengthPrefixedArray<uint8_t>* cfi_info_;
   // For quick code, linker patches needed by the method.
-  const LengthPrefixedArray<linker::LinkerPatch>* const patches_;
+  const LengthPrefixedArray<linker::LinkerPatch>* patches_;
 };
 
 }  // namespace art
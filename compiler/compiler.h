@@ -19,6 +19,7 @@
 
 #include "base/mutex.h"
 #include "base/os.h"
+#include "compilation_kind.h"
 #include "dex/invoke_type.h"
 
 namespace art {
@@ -28,6 +29,7 @@ struct CodeItem;
 }  // namespace dex
 namespace jit {
 class JitCodeCache;
+struct JitCompilationEvent;
 class JitLogger;
 class JitMemoryRegion;
 }  // namespace jit
@@ -75,9 +77,9 @@ class Compiler {
                           jit::JitCodeCache* code_cache ATTRIBUTE_UNUSED,
                           jit::JitMemoryRegion* region ATTRIBUTE_UNUSED,
                           ArtMethod* method ATTRIBUTE_UNUSED,
-                          bool baseline ATTRIBUTE_UNUSED,
-                          bool osr ATTRIBUTE_UNUSED,
-                          jit::JitLogger* jit_logger ATTRIBUTE_UNUSED)
+                          CompilationKind compilation_kind ATTRIBUTE_UNUSED,
+                          jit::JitLogger* jit_logger ATTRIBUTE_UNUSED,
+                          jit::JitCompilationEvent* compilation_event ATTRIBUTE_UNUSED)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     return false;
   }
@@ -51,6 +51,8 @@ class CompiledMethodStorage {
     return SwapAllocator<void>(swap_space_.get());
   }
 
+  // The Release*() functions drop a reference obtained from the corresponding Deduplicate*()
+  // function. Deduplicated data is freed when its last reference is released.
   const LengthPrefixedArray<uint8_t>* DeduplicateCode(const ArrayRef<const uint8_t>& code);
   void ReleaseCode(const LengthPrefixedArray<uint8_t>* code);
 
@@ -91,8 +93,8 @@ class CompiledMethodStorage {
   const LengthPrefixedArray<T>* AllocateOrDeduplicateArray(const ArrayRef<const T>& data,
                                                            DedupeSetType* dedupe_set);
 
-  template <typename T>
-  void ReleaseArrayIfNotDeduplicated(const LengthPrefixedArray<T>* array);
+  template <typename T, typename DedupeSetType>
+  void ReleaseOrDereferenceArray(const LengthPrefixedArray<T>* array, DedupeSetType* dedupe_set);
 
   // DeDuplication data structures.
   template <typename ContentType>
@@ -64,6 +64,7 @@ CompilerOptions::CompilerOptions()
       dump_timings_(false),
       dump_pass_timings_(false),
       dump_stats_(false),
+      dump_jit_events_(false),
       top_k_profile_threshold_(kDefaultTopKProfileThreshold),
       profile_compilation_info_(nullptr),
       verbose_methods_(),
@@ -75,10 +76,12 @@ CompilerOptions::CompilerOptions()
       force_determinism_(false),
       deduplicate_code_(true),
       count_hotness_in_compiled_code_(false),
+      profile_branches_(false),
       resolve_startup_const_strings_(false),
       initialize_app_image_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
+      image_dictionary_size_(0u),
       register_allocation_strategy_(RegisterAllocator::kRegisterAllocatorDefault),
       passes_to_run_(nullptr) {
 }
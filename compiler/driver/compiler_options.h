@@ -334,10 +334,20 @@ class CompilerOptions final {
     return dump_stats_;
   }
 
+  // Whether the JIT writes the compilation event log, see JitLogger.
+  bool GetDumpJitEvents() const {
+    return dump_jit_events_;
+  }
+
   bool CountHotnessInCompiledCode() const {
     return count_hotness_in_compiled_code_;
   }
 
+  // Whether baseline compiled code records the outcome of branches in the ProfilingInfo.
+  bool ProfileBranches() const {
+    return profile_branches_;
+  }
+
   bool ResolveStartupConstStrings() const {
     return resolve_startup_const_strings_;
   }
@@ -354,6 +364,14 @@ class CompilerOptions final {
     max_image_block_size_ = size;
   }
 
+  uint32_t ImageDictionarySize() const {
+    return image_dictionary_size_;
+  }
+
+  void SetImageDictionarySize(uint32_t size) {
+    image_dictionary_size_ = size;
+  }
+
   bool InitializeAppImageClasses() const {
     return initialize_app_image_classes_;
   }
@@ -400,6 +418,7 @@ class CompilerOptions final {
   bool dump_timings_;
   bool dump_pass_timings_;
   bool dump_stats_;
+  bool dump_jit_events_;
 
   // When using a profile file only the top K% of the profiled samples will be compiled.
   double top_k_profile_threshold_;
@@ -433,6 +452,10 @@ class CompilerOptions final {
   // won't be atomic for performance reasons, so we accept races, just like in interpreter.
   bool count_hotness_in_compiled_code_;
 
+  // Whether baseline compiled code should count taken and not taken branches. Only set by
+  // the JIT, for the instruction sets that implement it.
+  bool profile_branches_;
+
   // Whether we eagerly resolve all of the const strings that are loaded from startup methods in the
   // profile.
   bool resolve_startup_const_strings_;
@@ -447,6 +470,10 @@ class CompilerOptions final {
   // Maximum solid block size in the generated image.
   uint32_t max_image_block_size_;
 
+  // Maximum size of the dictionary shared by the zstd compressed blocks of an image.
+  // Zero if no dictionary should be used.
+  uint32_t image_dictionary_size_;
+
   RegisterAllocator::Strategy register_allocation_strategy_;
 
   // If not null, specifies optimization passes which will be run instead of defaults.
@@ -85,6 +85,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
   map.AssignIfExists(Base::MaxImageBlockSize, &options->max_image_block_size_);
+  map.AssignIfExists(Base::ImageDictionarySize, &options->image_dictionary_size_);
 
   if (map.Exists(Base::DumpTimings)) {
     options->dump_timings_ = true;
@@ -98,6 +99,10 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_stats_ = true;
   }
 
+  if (map.Exists(Base::DumpJitEvents)) {
+    options->dump_jit_events_ = true;
+  }
+
   return true;
 }
 
@@ -161,6 +166,9 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define({"--dump-stats"})
           .IntoKey(Map::DumpStats)
 
+      .Define({"--dump-jit-events"})
+          .IntoKey(Map::DumpJitEvents)
+
       .Define("--debuggable")
           .IntoKey(Map::Debuggable)
 
@@ -208,7 +216,11 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
 
       .Define("--max-image-block-size=_")
           .template WithType<unsigned int>()
-          .IntoKey(Map::MaxImageBlockSize);
+          .IntoKey(Map::MaxImageBlockSize)
+
+      .Define("--image-dictionary-size=_")
+          .template WithType<unsigned int>()
+          .IntoKey(Map::ImageDictionarySize);
 }
 
 #pragma GCC diagnostic pop
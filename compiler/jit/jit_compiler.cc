@@ -33,6 +33,7 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/jit_logger.h"
+#include "jit/profiling_info.h"
 
 namespace art {
 namespace jit {
@@ -70,6 +71,9 @@ void JitCompiler::ParseCompilerOptions() {
   } else {
     DCHECK_EQ(instruction_set, kRuntimeISA);
   }
+  // Branch profiles drive the block layout of optimized code.
+  compiler_options_->profile_branches_ =
+      (instruction_set == InstructionSet::kArm64) || (instruction_set == InstructionSet::kX86_64);
   std::unique_ptr<const InstructionSetFeatures> instruction_set_features;
   for (const std::string& option : runtime->GetCompilerOptions()) {
     VLOG(compiler) << "JIT compiler option " << option;
@@ -107,9 +111,14 @@ void JitCompiler::ParseCompilerOptions() {
   }
   compiler_options_->instruction_set_features_ = std::move(instruction_set_features);
 
-  if (compiler_options_->GetGenerateDebugInfo()) {
+  if (compiler_options_->GetGenerateDebugInfo() || compiler_options_->GetDumpJitEvents()) {
     jit_logger_.reset(new JitLogger());
-    jit_logger_->OpenLog();
+    if (compiler_options_->GetGenerateDebugInfo()) {
+      jit_logger_->OpenLog();
+    }
+    if (compiler_options_->GetDumpJitEvents()) {
+      jit_logger_->OpenEventLog();
+    }
   }
 }
 
@@ -155,16 +164,20 @@ JitCompiler::JitCompiler() {
 }
 
 JitCompiler::~JitCompiler() {
-  if (compiler_options_->GetGenerateDebugInfo()) {
+  if (jit_logger_ != nullptr) {
     jit_logger_->CloseLog();
+    jit_logger_->CloseEventLog();
   }
 }
 
-bool JitCompiler::CompileMethod(
-    Thread* self, JitMemoryRegion* region, ArtMethod* method, bool baseline, bool osr) {
+bool JitCompiler::CompileMethod(Thread* self,
+                                JitMemoryRegion* region,
+                                ArtMethod* method,
+                                CompilationKind compilation_kind,
+                                uint64_t queue_wait_ns) {
   SCOPED_TRACE << "JIT compiling "
                << method->PrettyMethod()
-               << " (baseline=" << baseline << ", osr=" << osr << ")";
+               << " (kind=" << compilation_kind << ")";
 
   DCHECK(!method->IsProxyMethod());
   DCHECK(method->GetDeclaringClass()->IsResolved());
@@ -174,6 +187,16 @@ bool JitCompiler::CompileMethod(
   self->AssertNoPendingException();
   Runtime* runtime = Runtime::Current();
 
+  std::unique_ptr<JitCompilationEvent> event;
+  if (jit_logger_ != nullptr && jit_logger_->IsEventLogEnabled()) {
+    event.reset(new JitCompilationEvent(method->PrettyMethod(), compilation_kind));
+    event->queue_wait_ns = queue_wait_ns;
+    ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+    if (info != nullptr) {
+      event->number_of_deoptimizations = info->GetNumberOfDeoptimizations();
+    }
+  }
+
   // Do the compilation.
   bool success = false;
   {
@@ -181,12 +204,17 @@ bool JitCompiler::CompileMethod(
     JitCodeCache* const code_cache = runtime->GetJit()->GetCodeCache();
     uint64_t start_ns = NanoTime();
     success = compiler_->JitCompile(
-        self, code_cache, region, method, baseline, osr, jit_logger_.get());
+        self, code_cache, region, method, compilation_kind, jit_logger_.get(), event.get());
     uint64_t duration_ns = NanoTime() - start_ns;
     VLOG(jit) << "Compilation of "
               << method->PrettyMethod()
               << " took "
               << PrettyDuration(duration_ns);
+    if (event != nullptr) {
+      event->success = success;
+      event->compile_time_ns = duration_ns;
+      jit_logger_->WriteEventLog(*event);
+    }
   }
 
   // Trim maps to reduce memory usage.
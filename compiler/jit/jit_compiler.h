@@ -39,8 +39,11 @@ class JitCompiler : public JitCompilerInterface {
   virtual ~JitCompiler();
 
   // Compilation entrypoint. Returns whether the compilation succeeded.
-  bool CompileMethod(
-      Thread* self, JitMemoryRegion* region, ArtMethod* method, bool baseline, bool osr)
+  bool CompileMethod(Thread* self,
+                     JitMemoryRegion* region,
+                     ArtMethod* method,
+                     CompilationKind compilation_kind,
+                     uint64_t queue_wait_ns)
       REQUIRES_SHARED(Locks::mutator_lock_) override;
 
   const CompilerOptions& GetCompilerOptions() const {
@@ -304,5 +304,143 @@ void JitLogger::CloseJitDumpLog() {
   }
 }
 
+//  File format of jit-events-PID.log:
+//
+//  +--------------------------------+
+//  |  JitEventLogHeader             |
+//  +--------------------------------+
+//  |  record                        |
+//  |  record                        |
+//  |  ...                           |
+//  +--------------------------------+
+//
+//  Each record starts with a one byte JitEventLogRecord kind. All integers following
+//  the kind are unsigned LEB128, and all strings are referenced by the identifier of a
+//  previous kString record:
+//
+//  kString:       id, length, UTF-8 bytes (without terminating null)
+//  kCompilation:  timestamp (ns since the header), thread id, method name, compilation kind,
+//                 success, queue wait (ns), compile time (ns), code size,
+//                 number of deoptimizations,
+//                 number of passes, followed by (pass name, time in ns) for each pass,
+//                 number of inlining decisions, followed by
+//                 (depth, inlined, callee name, failure reason or 0) for each decision.
+//
+struct JitEventLogHeader {
+  uint32_t magic_;          // Characters "AJEV"
+  uint32_t version_;        // Format version
+  uint32_t process_id_;     // Process ID of the JIT compiler
+  uint32_t reserved_;       // Reserved, currently not used
+  uint64_t time_stamp_;     // CLOCK_MONOTONIC timestamp when the header is generated
+  static const uint32_t kMagic = 0x56454A41;  // "AJEV"
+  static const uint32_t kVersion = 1;
+};
+
+enum class JitEventLogRecord : uint8_t {
+  kString = 1,
+  kCompilation = 2,
+};
+
+static void AppendUnsignedLeb128(std::vector<uint8_t>* buffer, uint64_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80;
+    }
+    buffer->push_back(byte);
+  } while (value != 0);
+}
+
+void JitLogger::OpenEventLog() {
+  std::string pid_str = std::to_string(getpid());
+  OpenEventLog(std::string(kLogPrefix) + "/jit-events-" + pid_str + ".log");
+}
+
+void JitLogger::OpenEventLog(const std::string& filename) {
+  event_log_file_.reset(OS::CreateEmptyFileWriteOnly(filename.c_str()));
+  if (event_log_file_ == nullptr) {
+    LOG(ERROR) << "Could not create JIT event log at " << filename;
+    return;
+  }
+
+  JitEventLogHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic_ = JitEventLogHeader::kMagic;
+  header.version_ = JitEventLogHeader::kVersion;
+  header.process_id_ = static_cast<uint32_t>(getpid());
+  event_log_start_ns_ = art::NanoTime();
+  header.time_stamp_ = event_log_start_ns_;
+  if (!event_log_file_->WriteFully(reinterpret_cast<const char*>(&header), sizeof(header))) {
+    LOG(WARNING) << "Failed to write JIT event log header.";
+  }
+}
+
+uint32_t JitLogger::InternEventLogString(const std::string& str, std::vector<uint8_t>* buffer) {
+  auto it = event_log_strings_.find(str);
+  if (it != event_log_strings_.end()) {
+    return it->second;
+  }
+  // Identifier 0 is reserved for "no string".
+  uint32_t id = event_log_strings_.size() + 1u;
+  event_log_strings_.emplace(str, id);
+  buffer->push_back(static_cast<uint8_t>(JitEventLogRecord::kString));
+  AppendUnsignedLeb128(buffer, id);
+  AppendUnsignedLeb128(buffer, str.size());
+  buffer->insert(buffer->end(), str.begin(), str.end());
+  return id;
+}
+
+void JitLogger::WriteEventLog(const JitCompilationEvent& event) {
+  if (event_log_file_ == nullptr) {
+    return;
+  }
+  uint64_t time_stamp = art::NanoTime() - event_log_start_ns_;
+  MutexLock mu(Thread::Current(), event_log_lock_);
+  // String records must precede the compilation record using them, so we collect them
+  // in `buffer` while building the compilation record in `record`.
+  std::vector<uint8_t> buffer;
+  std::vector<uint8_t> record;
+  record.push_back(static_cast<uint8_t>(JitEventLogRecord::kCompilation));
+  AppendUnsignedLeb128(&record, time_stamp);
+  AppendUnsignedLeb128(&record, static_cast<uint32_t>(art::GetTid()));
+  AppendUnsignedLeb128(&record, InternEventLogString(event.method_name, &buffer));
+  AppendUnsignedLeb128(&record, static_cast<uint32_t>(event.compilation_kind));
+  AppendUnsignedLeb128(&record, event.success ? 1u : 0u);
+  AppendUnsignedLeb128(&record, event.queue_wait_ns);
+  AppendUnsignedLeb128(&record, event.compile_time_ns);
+  AppendUnsignedLeb128(&record, event.code_size);
+  AppendUnsignedLeb128(&record, event.number_of_deoptimizations);
+  AppendUnsignedLeb128(&record, event.pass_timings.size());
+  for (const JitCompilationEvent::PassTiming& pass : event.pass_timings) {
+    AppendUnsignedLeb128(&record, InternEventLogString(pass.pass_name, &buffer));
+    AppendUnsignedLeb128(&record, pass.duration_ns);
+  }
+  AppendUnsignedLeb128(&record, event.inlining_decisions.size());
+  for (const JitCompilationEvent::InliningDecision& decision : event.inlining_decisions) {
+    AppendUnsignedLeb128(&record, decision.depth);
+    AppendUnsignedLeb128(&record, decision.inlined ? 1u : 0u);
+    AppendUnsignedLeb128(&record, InternEventLogString(decision.callee, &buffer));
+    uint32_t reason_id = 0u;
+    if (decision.has_failure_reason) {
+      std::ostringstream reason;
+      reason << decision.failure_reason;
+      reason_id = InternEventLogString(reason.str(), &buffer);
+    }
+    AppendUnsignedLeb128(&record, reason_id);
+  }
+  buffer.insert(buffer.end(), record.begin(), record.end());
+  if (!event_log_file_->WriteFully(buffer.data(), buffer.size())) {
+    LOG(WARNING) << "Failed to write JIT event log record.";
+  }
+}
+
+void JitLogger::CloseEventLog() {
+  if (event_log_file_ != nullptr) {
+    UNUSED(event_log_file_->Flush());
+    UNUSED(event_log_file_->Close());
+  }
+}
+
 }  // namespace jit
 }  // namespace art
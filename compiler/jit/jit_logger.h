@@ -18,10 +18,15 @@
 #define ART_COMPILER_JIT_JIT_LOGGER_H_
 
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/mutex.h"
 #include "base/os.h"
+#include "compilation_kind.h"
 #include "compiled_method.h"
+#include "optimizing/optimizing_compiler_stats.h"
 
 namespace art {
 
@@ -29,6 +34,39 @@ class ArtMethod;
 
 namespace jit {
 
+// Information collected during one JIT compilation, written to the compilation
+// event log (see JitLogger below) once the compilation is done.
+struct JitCompilationEvent {
+  struct PassTiming {
+    const char* pass_name;
+    uint64_t duration_ns;
+  };
+
+  struct InliningDecision {
+    // Depth of the inliner that took the decision, 0 for calls of the compiled method.
+    size_t depth;
+    bool inlined;
+    std::string callee;
+    // Last reason the inliner reported for not inlining, if any.
+    bool has_failure_reason;
+    MethodCompilationStat failure_reason;
+  };
+
+  JitCompilationEvent(std::string name, CompilationKind kind)
+      : method_name(std::move(name)), compilation_kind(kind) {}
+
+  std::string method_name;
+  CompilationKind compilation_kind;
+  bool success = false;
+  uint64_t queue_wait_ns = 0;
+  uint64_t compile_time_ns = 0;
+  size_t code_size = 0;
+  uint16_t number_of_deoptimizations = 0;
+  std::vector<PassTiming> pass_timings;
+  // Inlining decisions, in the order the inliner tried the calls (callers first).
+  std::vector<InliningDecision> inlining_decisions;
+};
+
 //
 // JitLogger supports two approaches of perf profiling.
 //
@@ -86,26 +124,57 @@ namespace jit {
 //       - Make sure above small ELF files are available for 'perf annotate' tool to access,
 //         so that jitted code can be displayed in assembly view.
 //
+// Independently of perf profiling, JitLogger can write a compilation event log:
+//     The jit-events-PID.log file contains one record per JIT compilation, with the
+//     time the method waited in the compilation queue, the time spent in each optimizing
+//     pass, the inlining decisions and their reasons, the code size and the number of
+//     deoptimizations of the method. The log is summarized on host by
+//     tools/jit-event-summary.py.
+//
+//     Command line Example:
+//       $ dalvikvm -Xcompiler-option --dump-jit-events -cp <classpath> Test
+//       $ tools/jit-event-summary.py /tmp/jit-events-PID.log
+//
 class JitLogger {
  public:
-    JitLogger() : code_index_(0), marker_address_(nullptr) {}
+    JitLogger()
+        : perf_logs_enabled_(false),
+          code_index_(0),
+          marker_address_(nullptr),
+          event_log_lock_("JIT event log lock"),
+          event_log_start_ns_(0) {}
 
     void OpenLog() {
+      perf_logs_enabled_ = true;
       OpenPerfMapLog();
       OpenJitDumpLog();
     }
 
     void WriteLog(const void* ptr, size_t code_size, ArtMethod* method)
         REQUIRES_SHARED(Locks::mutator_lock_) {
-      WritePerfMapLog(ptr, code_size, method);
-      WriteJitDumpLog(ptr, code_size, method);
+      if (perf_logs_enabled_) {
+        WritePerfMapLog(ptr, code_size, method);
+        WriteJitDumpLog(ptr, code_size, method);
+      }
     }
 
     void CloseLog() {
-      ClosePerfMapLog();
-      CloseJitDumpLog();
+      if (perf_logs_enabled_) {
+        ClosePerfMapLog();
+        CloseJitDumpLog();
+      }
     }
 
+    // For the compilation event log.
+    void OpenEventLog();
+    // Open the compilation event log at `filename`, instead of the default location.
+    void OpenEventLog(const std::string& filename);
+    bool IsEventLogEnabled() const {
+      return event_log_file_ != nullptr;
+    }
+    void WriteEventLog(const JitCompilationEvent& event) REQUIRES(!event_log_lock_);
+    void CloseEventLog();
+
  private:
     // For perf-map profiling
     void OpenPerfMapLog();
@@ -124,11 +193,22 @@ class JitLogger {
     void WriteJitDumpHeader();
     void WriteJitDumpDebugInfo();
 
+    uint32_t InternEventLogString(const std::string& str, std::vector<uint8_t>* buffer)
+        REQUIRES(event_log_lock_);
+
+    bool perf_logs_enabled_;
     std::unique_ptr<File> perf_file_;
     std::unique_ptr<File> jit_dump_file_;
     uint64_t code_index_;
     void* marker_address_;
 
+    // Compilation threads write their events concurrently.
+    Mutex event_log_lock_;
+    std::unique_ptr<File> event_log_file_;
+    uint64_t event_log_start_ns_;
+    // Strings already written to the event log, with their identifiers.
+    std::unordered_map<std::string, uint32_t> event_log_strings_ GUARDED_BY(event_log_lock_);
+
     DISALLOW_COPY_AND_ASSIGN(JitLogger);
 };
 
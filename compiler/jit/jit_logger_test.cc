@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_logger.h"
+
+#include <sstream>
+
+#include "base/unix_file/fd_file.h"
+#include "base/utils.h"
+#include "common_runtime_test.h"
+
+namespace art {
+namespace jit {
+
+class JitLoggerTest : public CommonRuntimeTest {
+ protected:
+  // Reads the content of the event log, and checks its header.
+  std::vector<uint8_t> ReadEventLog(const std::string& filename) {
+    std::unique_ptr<File> file(OS::OpenFileForReading(filename.c_str()));
+    CHECK(file != nullptr);
+    std::vector<uint8_t> data(file->GetLength());
+    CHECK(file->ReadFully(data.data(), data.size()));
+    CHECK_GE(data.size(), kHeaderSize);
+    EXPECT_EQ(0x56454A41u, ReadU32(data, 0u));  // "AJEV"
+    EXPECT_EQ(1u, ReadU32(data, 4u));
+    EXPECT_EQ(static_cast<uint32_t>(getpid()), ReadU32(data, 8u));
+    EXPECT_EQ(0u, ReadU32(data, 12u));
+    return data;
+  }
+
+  static uint32_t ReadU32(const std::vector<uint8_t>& data, size_t offset) {
+    uint32_t value;
+    memcpy(&value, data.data() + offset, sizeof(value));
+    return value;
+  }
+
+  // Reads the next unsigned LEB128 of the log.
+  uint64_t ReadUleb128(const std::vector<uint8_t>& data) {
+    uint64_t result = 0u;
+    for (uint32_t shift = 0u; ; shift += 7u) {
+      CHECK_LT(pos_, data.size());
+      uint8_t byte = data[pos_++];
+      result |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+      if ((byte & 0x80u) == 0u) {
+        return result;
+      }
+    }
+  }
+
+  // Reads a string record, and returns its identifier.
+  uint64_t ExpectStringRecord(const std::vector<uint8_t>& data, const std::string& expected) {
+    EXPECT_EQ(kStringRecord, data[pos_++]);
+    uint64_t id = ReadUleb128(data);
+    uint64_t length = ReadUleb128(data);
+    CHECK_LE(pos_ + length, data.size());
+    EXPECT_EQ(expected, std::string(data.begin() + pos_, data.begin() + pos_ + length));
+    pos_ += length;
+    return id;
+  }
+
+  static constexpr size_t kHeaderSize = 24u;
+  static constexpr uint8_t kStringRecord = 1u;
+  static constexpr uint8_t kCompilationRecord = 2u;
+
+  size_t pos_ = kHeaderSize;
+};
+
+TEST_F(JitLoggerTest, EventLogFormat) {
+  ScratchFile log;
+  JitLogger logger;
+  logger.OpenEventLog(log.GetFilename());
+  ASSERT_TRUE(logger.IsEventLogEnabled());
+
+  JitCompilationEvent event("int Main.foo(int)", CompilationKind::kOptimized);
+  event.success = true;
+  event.queue_wait_ns = 1000u;
+  event.compile_time_ns = 300000u;
+  event.code_size = 200u;
+  event.number_of_deoptimizations = 2u;
+  event.pass_timings.push_back({"GVN", 150u});
+  event.pass_timings.push_back({"dead_code_elimination", 10u});
+  event.inlining_decisions.push_back({0u,
+                                      /* inlined= */ true,
+                                      "int Main.bar()",
+                                      /* has_failure_reason= */ false,
+                                      MethodCompilationStat::kAttemptBytecodeCompilation});
+  event.inlining_decisions.push_back({1u,
+                                      /* inlined= */ false,
+                                      "int Main.baz()",
+                                      /* has_failure_reason= */ true,
+                                      MethodCompilationStat::kNotInlinedInstructionBudget});
+  logger.WriteEventLog(event);
+
+  // A second compilation of the same method only references the strings already written.
+  JitCompilationEvent failed_event("int Main.foo(int)", CompilationKind::kBaseline);
+  logger.WriteEventLog(failed_event);
+  logger.CloseEventLog();
+
+  std::vector<uint8_t> data = ReadEventLog(log.GetFilename());
+
+  // The first record writes the strings it uses before the compilation.
+  uint64_t method_id = ExpectStringRecord(data, "int Main.foo(int)");
+  uint64_t gvn_id = ExpectStringRecord(data, "GVN");
+  uint64_t dce_id = ExpectStringRecord(data, "dead_code_elimination");
+  uint64_t bar_id = ExpectStringRecord(data, "int Main.bar()");
+  uint64_t baz_id = ExpectStringRecord(data, "int Main.baz()");
+  std::ostringstream reason;
+  reason << MethodCompilationStat::kNotInlinedInstructionBudget;
+  uint64_t reason_id = ExpectStringRecord(data, reason.str());
+  EXPECT_EQ(1u, method_id);
+  EXPECT_EQ(6u, reason_id);
+
+  EXPECT_EQ(kCompilationRecord, data[pos_++]);
+  ReadUleb128(data);  // Time stamp.
+  EXPECT_EQ(static_cast<uint64_t>(GetTid()), ReadUleb128(data));
+  EXPECT_EQ(method_id, ReadUleb128(data));
+  EXPECT_EQ(static_cast<uint64_t>(CompilationKind::kOptimized), ReadUleb128(data));
+  EXPECT_EQ(1u, ReadUleb128(data));
+  EXPECT_EQ(1000u, ReadUleb128(data));
+  EXPECT_EQ(300000u, ReadUleb128(data));
+  EXPECT_EQ(200u, ReadUleb128(data));
+  EXPECT_EQ(2u, ReadUleb128(data));
+  EXPECT_EQ(2u, ReadUleb128(data));
+  EXPECT_EQ(gvn_id, ReadUleb128(data));
+  EXPECT_EQ(150u, ReadUleb128(data));
+  EXPECT_EQ(dce_id, ReadUleb128(data));
+  EXPECT_EQ(10u, ReadUleb128(data));
+  EXPECT_EQ(2u, ReadUleb128(data));
+  EXPECT_EQ(0u, ReadUleb128(data));
+  EXPECT_EQ(1u, ReadUleb128(data));
+  EXPECT_EQ(bar_id, ReadUleb128(data));
+  EXPECT_EQ(0u, ReadUleb128(data));
+  EXPECT_EQ(1u, ReadUleb128(data));
+  EXPECT_EQ(0u, ReadUleb128(data));
+  EXPECT_EQ(baz_id, ReadUleb128(data));
+  EXPECT_EQ(reason_id, ReadUleb128(data));
+
+  EXPECT_EQ(kCompilationRecord, data[pos_++]);
+  ReadUleb128(data);  // Time stamp.
+  ReadUleb128(data);  // Thread id.
+  EXPECT_EQ(method_id, ReadUleb128(data));
+  EXPECT_EQ(static_cast<uint64_t>(CompilationKind::kBaseline), ReadUleb128(data));
+  for (size_t i = 0; i != 7u; ++i) {
+    // Failure, timings, code size, deoptimizations, passes and inlining decisions.
+    EXPECT_EQ(0u, ReadUleb128(data));
+  }
+  EXPECT_EQ(data.size(), pos_);
+}
+
+}  // namespace jit
+}  // namespace art
@@ -550,7 +550,8 @@ class BCEVisitor : public HGraphVisitor {
     }
     // We should never deoptimize from an osr method, otherwise we might wrongly optimize
     // code dominated by the deoptimization.
-    if (!GetGraph()->IsCompilingOsr()) {
+    if (!GetGraph()->IsCompilingOsr() &&
+        !GetGraph()->IsSpeculationDisabled(DeoptimizationKind::kBlockBCE)) {
       AddComparesWithDeoptimization(block);
     }
   }
@@ -1663,6 +1664,11 @@ class BCEVisitor : public HGraphVisitor {
       if (GetGraph()->IsCompilingOsr()) {
         return false;
       }
+      // Do not speculate again if loop-based deoptimization failed for this method.
+      if (GetGraph()->IsSpeculationDisabled(DeoptimizationKind::kLoopBoundsBCE) ||
+          GetGraph()->IsSpeculationDisabled(DeoptimizationKind::kLoopNullBCE)) {
+        return false;
+      }
       // A try boundary preheader is hard to handle.
       // TODO: remove this restriction.
       if (loop->GetPreHeader()->GetLastInstruction()->IsTryBoundary()) {
@@ -309,6 +309,14 @@ bool CodeGenerator::GoesToNextBlock(HBasicBlock* current, HBasicBlock* next) con
   return GetNextBlockToEmit() == FirstNonEmptyBlock(next);
 }
 
+bool CodeGenerator::IsProfilingBranch(HIf* if_instr) const {
+  // Note: PrepareForRegisterAllocation does not emit the condition of such a branch at
+  // its use site.
+  return GetGraph()->IsCompilingBaseline() &&
+         GetCompilerOptions().ProfileBranches() &&
+         !if_instr->InputAt(0)->IsConstant();
+}
+
 HBasicBlock* CodeGenerator::GetNextBlockToEmit() const {
   for (size_t i = current_block_index_ + 1; i < block_order_->size(); ++i) {
     HBasicBlock* block = (*block_order_)[i];
@@ -389,7 +397,8 @@ void CodeGenerator::Compile(CodeAllocator* allocator) {
                                    core_spill_mask_,
                                    fpu_spill_mask_,
                                    GetGraph()->GetNumberOfVRegs(),
-                                   GetGraph()->IsCompilingBaseline());
+                                   GetGraph()->IsCompilingBaseline(),
+                                   GetGraph()->IsCompilingFastTier());
 
   size_t frame_start = GetAssembler()->CodeSize();
   GenerateFrameEntry();
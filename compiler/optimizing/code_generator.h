@@ -198,6 +198,10 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   HBasicBlock* FirstNonEmptyBlock(HBasicBlock* block) const;
   bool GoesToNextBlock(HBasicBlock* current, HBasicBlock* next) const;
 
+  // Whether the code generated for `if_instr` counts the outcome of the branch in the
+  // BranchCache of the ProfilingInfo. The condition is then materialized in a register.
+  bool IsProfilingBranch(HIf* if_instr) const;
+
   size_t GetStackSlotOfParameter(HParameterValue* parameter) const {
     // Note that this follows the current calling convention.
     return GetFrameSize()
@@ -1140,7 +1140,8 @@ void CodeGeneratorARM64::MaybeIncrementHotness(bool is_frame_entry) {
     __ Strh(counter, MemOperand(method, ArtMethod::HotnessCountOffset().Int32Value()));
   }
 
-  if (GetGraph()->IsCompilingBaseline() && !Runtime::Current()->IsAotCompiler()) {
+  if ((GetGraph()->IsCompilingBaseline() || GetGraph()->IsCompilingFastTier()) &&
+      !Runtime::Current()->IsAotCompiler()) {
     ScopedObjectAccess soa(Thread::Current());
     ProfilingInfo* info = GetGraph()->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
     if (info != nullptr) {
@@ -3572,9 +3573,38 @@ void InstructionCodeGeneratorARM64::VisitIf(HIf* if_instr) {
   if (codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor)) {
     false_target = nullptr;
   }
+  MaybeIncrementBranchCounter(if_instr);
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
+void InstructionCodeGeneratorARM64::MaybeIncrementBranchCounter(HIf* if_instr) {
+  if (!codegen_->IsProfilingBranch(if_instr)) {
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ProfilingInfo* info = GetGraph()->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
+  BranchCache* cache = (info != nullptr) ? info->GetBranchCache(if_instr->GetDexPc()) : nullptr;
+  if (cache == nullptr) {
+    return;
+  }
+  static_assert(BranchCache::TrueOffset().Int32Value() ==
+                    BranchCache::FalseOffset().Int32Value() + 2,
+                "The condition indexes the counts");
+  uint64_t address = reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+  UseScratchRegisterScope temps(GetVIXLAssembler());
+  Register temp = temps.AcquireX();
+  Register counter = temps.AcquireW();
+  Register condition = InputRegisterAt(if_instr, 0).X();
+  vixl::aarch64::Label done;
+  __ Mov(temp, address);
+  __ Ldrh(counter, MemOperand(temp, condition, LSL, 1));
+  __ Add(counter, counter, 1);
+  // Saturate at the maximum value of uint16_t.
+  __ Tbnz(counter, 16, &done);
+  __ Strh(counter, MemOperand(temp, condition, LSL, 1));
+  __ Bind(&done);
+}
+
 void LocationsBuilderARM64::VisitDeoptimize(HDeoptimize* deoptimize) {
   LocationSummary* locations = new (GetGraph()->GetAllocator())
       LocationSummary(deoptimize, LocationSummary::kCallOnSlowPath);
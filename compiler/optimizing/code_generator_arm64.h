@@ -361,6 +361,7 @@ class InstructionCodeGeneratorARM64 : public InstructionCodeGenerator {
   void GenerateFcmp(HInstruction* instruction);
 
   void HandleShift(HBinaryOperation* instr);
+  void MaybeIncrementBranchCounter(HIf* if_instr);
   void GenerateTestAndBranch(HInstruction* instruction,
                              size_t condition_input_index,
                              vixl::aarch64::Label* true_target,
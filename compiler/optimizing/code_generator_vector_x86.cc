@@ -226,10 +226,17 @@ void InstructionCodeGeneratorX86::VisitVecReduce(HVecReduce* instruction) {
           __ phaddd(dst, dst);
           break;
         case HVecReduce::kMin:
-        case HVecReduce::kMax:
-          // Historical note: We've had a broken implementation here. b/117863065
-          // Do not draw on the old code if we ever want to bring MIN/MAX reduction back.
-          LOG(FATAL) << "Unsupported reduction type.";
+        case HVecReduce::kMax: {
+          // Fold the upper half onto the lower half, then the odd lane onto the even lane.
+          XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+          bool is_min = instruction->GetReductionKind() == HVecReduce::kMin;
+          __ movaps(dst, src);
+          __ pshufd(tmp, dst, Immediate(0x4E));
+          is_min ? __ pminsd(dst, tmp) : __ pmaxsd(dst, tmp);
+          __ pshufd(tmp, dst, Immediate(0xB1));
+          is_min ? __ pminsd(dst, tmp) : __ pmaxsd(dst, tmp);
+          break;
+        }
       }
       break;
     case DataType::Type::kInt64: {
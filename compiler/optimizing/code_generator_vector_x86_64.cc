@@ -25,6 +25,17 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// Returns true if the vector operation spans a full 256-bit YMM register (AVX2).
+static bool IsWideVector(HVecOperation* instruction) {
+  return instruction->GetVectorNumberOfBytes() == 32u;
+}
+
+// Returns the number of lanes the vector operation keeps in the low 128 bits.
+static size_t XmmVectorLength(HVecOperation* instruction) {
+  return IsWideVector(instruction) ? instruction->GetVectorLength() / 2
+                                   : instruction->GetVectorLength();
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -59,12 +70,49 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
 
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
-  // Shorthand for any type of zero.
+  // Shorthand for any type of zero (the VEX encoding also clears the upper YMM half).
   if (IsZeroBitPattern(instruction->InputAt(0))) {
     cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
     return;
   }
 
+  if (IsWideVector(instruction)) {
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastb(ydst, dst);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastw(ydst, dst);
+        break;
+      case DataType::Type::kInt32:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastd(ydst, dst);
+        break;
+      case DataType::Type::kInt64:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
+        __ vpbroadcastq(ydst, dst);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastss(ydst, dst);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastsd(ydst, dst);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
+
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -144,17 +192,17 @@ void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* in
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(4u, XmmVectorLength(instruction));
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ false);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(2u, XmmVectorLength(instruction));
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ true);
       break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
+      DCHECK_LE(2u, XmmVectorLength(instruction));
+      DCHECK_LE(XmmVectorLength(instruction), 4u);
       DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
       break;
     default:
@@ -187,10 +235,11 @@ static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation
 
 void LocationsBuilderX86_64::VisitVecReduce(HVecReduce* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Long reduction or min/max require a temporary.
+  // Long reduction, min/max or folding a YMM register require a temporary.
   if (instruction->GetPackedType() == DataType::Type::kInt64 ||
       instruction->GetReductionKind() == HVecReduce::kMin ||
-      instruction->GetReductionKind() == HVecReduce::kMax) {
+      instruction->GetReductionKind() == HVecReduce::kMax ||
+      IsWideVector(instruction)) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
   }
 }
@@ -199,6 +248,44 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    // Fold the upper 128-bit lane onto the lower one, then reduce within the XMM register.
+    XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+    __ vextracti128(tmp, YmmRegister(src), Immediate(1));
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        switch (instruction->GetReductionKind()) {
+          case HVecReduce::kSum:
+            __ vpaddd(dst, src, tmp);
+            __ phaddd(dst, dst);
+            __ phaddd(dst, dst);
+            break;
+          case HVecReduce::kMin:
+          case HVecReduce::kMax: {
+            bool is_min = instruction->GetReductionKind() == HVecReduce::kMin;
+            __ movaps(dst, src);
+            is_min ? __ pminsd(dst, tmp) : __ pmaxsd(dst, tmp);
+            __ pshufd(tmp, dst, Immediate(0x4E));
+            is_min ? __ pminsd(dst, tmp) : __ pmaxsd(dst, tmp);
+            __ pshufd(tmp, dst, Immediate(0xB1));
+            is_min ? __ pminsd(dst, tmp) : __ pmaxsd(dst, tmp);
+            break;
+          }
+        }
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(instruction->GetReductionKind(), HVecReduce::kSum);
+        __ vpaddq(dst, src, tmp);
+        __ movaps(tmp, dst);
+        __ punpckhqdq(tmp, tmp);
+        __ paddq(dst, tmp);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -209,10 +296,17 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
           __ phaddd(dst, dst);
           break;
         case HVecReduce::kMin:
-        case HVecReduce::kMax:
-          // Historical note: We've had a broken implementation here. b/117863065
-          // Do not draw on the old code if we ever want to bring MIN/MAX reduction back.
-          LOG(FATAL) << "Unsupported reduction type.";
+        case HVecReduce::kMax: {
+          // Fold the upper half onto the lower half, then the odd lane onto the even lane.
+          XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+          bool is_min = instruction->GetReductionKind() == HVecReduce::kMin;
+          __ movaps(dst, src);
+          __ pshufd(tmp, dst, Immediate(0x4E));
+          is_min ? __ pminsd(dst, tmp) : __ pmaxsd(dst, tmp);
+          __ pshufd(tmp, dst, Immediate(0xB1));
+          is_min ? __ pminsd(dst, tmp) : __ pmaxsd(dst, tmp);
+          break;
+        }
       }
       break;
     case DataType::Type::kInt64: {
@@ -248,6 +342,10 @@ void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
   if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    if (IsWideVector(instruction)) {
+      __ vcvtdq2ps(YmmRegister(dst), YmmRegister(src));
+      return;
+    }
     DCHECK_EQ(4u, instruction->GetVectorLength());
     __ cvtdq2ps(dst, src);
   } else {
@@ -263,6 +361,42 @@ void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpxor(ydst, ydst, ydst);
+        __ vpsubb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpxor(ydst, ydst, ydst);
+        __ vpsubw(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt32:
+        __ vpxor(ydst, ydst, ydst);
+        __ vpsubd(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt64:
+        __ vpxor(ydst, ydst, ydst);
+        __ vpsubq(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vxorps(ydst, ydst, ydst);
+        __ vsubps(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vxorpd(ydst, ydst, ydst);
+        __ vsubpd(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -314,6 +448,29 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        __ vpabsd(ydst, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vpcmpeqb(ydst, ydst, ydst);  // all ones
+        __ vpsrld(ydst, ydst, Immediate(1));
+        __ vandps(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vpcmpeqb(ydst, ydst, ydst);  // all ones
+        __ vpsrlq(ydst, ydst, Immediate(1));
+        __ vandpd(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -355,6 +512,41 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool: {  // special case boolean-not
+        YmmRegister ytmp(locations->GetTemp(0).AsFpuRegister<XmmRegister>());
+        __ vpxor(ydst, ydst, ydst);
+        __ vpcmpeqb(ytmp, ytmp, ytmp);  // all ones
+        __ vpsubb(ydst, ydst, ytmp);  // 32 x one
+        __ vpxor(ydst, ydst, ysrc);
+        break;
+      }
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpcmpeqb(ydst, ydst, ydst);  // all ones
+        __ vpxor(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vpcmpeqb(ydst, ydst, ydst);  // all ones
+        __ vxorps(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vpcmpeqb(ydst, ydst, ydst);  // all ones
+        __ vxorpd(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool: {  // special case boolean-not
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -452,6 +644,37 @@ void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpaddb(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpaddw(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kInt32:
+        __ vpaddd(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kInt64:
+        __ vpaddq(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vaddps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vaddpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -494,6 +717,28 @@ void InstructionCodeGeneratorX86_64::VisitVecSaturationAdd(HVecSaturationAdd* in
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpaddusb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt8:
+        __ vpaddsb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint16:
+        __ vpaddusw(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt16:
+        __ vpaddsw(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -529,6 +774,22 @@ void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruct
 
   DCHECK(instruction->IsRounded());
 
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpavgb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint16:
+        __ vpavgw(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -559,6 +820,37 @@ void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpsubb(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsubw(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kInt32:
+        __ vpsubd(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kInt64:
+        __ vpsubq(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vsubps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vsubpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -601,6 +893,28 @@ void InstructionCodeGeneratorX86_64::VisitVecSaturationSub(HVecSaturationSub* in
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpsubusb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt8:
+        __ vpsubsb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint16:
+        __ vpsubusw(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt16:
+        __ vpsubsw(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -639,6 +953,30 @@ void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpmullw(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kInt32:
+        __ vpmulld(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vmulps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vmulpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -678,6 +1016,23 @@ void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        __ vdivps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vdivpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -702,6 +1057,34 @@ void InstructionCodeGeneratorX86_64::VisitVecMin(HVecMin* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpminub(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt8:
+        __ vpminsb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint16:
+        __ vpminuw(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt16:
+        __ vpminsw(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint32:
+        __ vpminud(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt32:
+        __ vpminsd(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -751,6 +1134,34 @@ void InstructionCodeGeneratorX86_64::VisitVecMax(HVecMax* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+        __ vpmaxub(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt8:
+        __ vpmaxsb(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint16:
+        __ vpmaxuw(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt16:
+        __ vpmaxsw(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kUint32:
+        __ vpmaxud(ydst, ydst, ysrc);
+        break;
+      case DataType::Type::kInt32:
+        __ vpmaxsd(ydst, ydst, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -806,6 +1217,32 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpand(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vandps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vandpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -847,6 +1284,32 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpandn(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vandnps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vandnpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -888,6 +1351,32 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpor(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vorps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vorpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -929,6 +1418,32 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsWideVector(instruction)) {
+    YmmRegister ysrc(src);
+    YmmRegister yother_src(other_src);
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vpxor(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat32:
+        __ vxorps(ydst, yother_src, ysrc);
+        break;
+      case DataType::Type::kFloat64:
+        __ vxorpd(ydst, yother_src, ysrc);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -982,6 +1497,25 @@ void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsllw(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpslld(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        __ vpsllq(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1011,6 +1545,22 @@ void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsraw(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpsrad(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1036,6 +1586,25 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    YmmRegister ydst(dst);
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsrlw(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpsrld(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        __ vpsrlq(ydst, ydst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1094,7 +1663,7 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
 
   DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
 
-  // Zero out all other elements first.
+  // Zero out all other elements first (the VEX encoding also clears the upper YMM half).
   bool cpu_has_avx = CpuHasAvxFeatureFlag();
   cpu_has_avx ? __ vxorps(dst, dst, dst) : __ xorps(dst, dst);
 
@@ -1113,19 +1682,19 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
       LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(4u, XmmVectorLength(instruction));
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(2u, XmmVectorLength(instruction));
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());  // is 64-bit
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
+      DCHECK_EQ(4u, XmmVectorLength(instruction));
       __ movss(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
+      DCHECK_EQ(2u, XmmVectorLength(instruction));
       __ movsd(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     default:
@@ -1190,8 +1759,13 @@ void InstructionCodeGeneratorX86_64::VisitVecDotProd(HVecDotProd* instruction) {
   XmmRegister right = locations->InAt(2).AsFpuRegister<XmmRegister>();
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+      if (IsWideVector(instruction)) {
+        __ vpmaddwd(YmmRegister(tmp), YmmRegister(left), YmmRegister(right));
+        __ vpaddd(YmmRegister(acc), YmmRegister(acc), YmmRegister(tmp));
+        break;
+      }
+      DCHECK_EQ(4u, instruction->GetVectorLength());
       if (!cpu_has_avx) {
         __ movaps(tmp, right);
         __ pmaddwd(tmp, left);
@@ -1268,6 +1842,30 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
   XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    DCHECK(!instruction->IsStringCharAt());
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vmovdqu(YmmRegister(reg), address);
+        break;
+      case DataType::Type::kFloat32:
+        __ vmovups(YmmRegister(reg), address);
+        break;
+      case DataType::Type::kFloat64:
+        __ vmovupd(YmmRegister(reg), address);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
@@ -1327,6 +1925,29 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
   XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  if (IsWideVector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+        __ vmovdqu(address, YmmRegister(reg));
+        break;
+      case DataType::Type::kFloat32:
+        __ vmovups(address, YmmRegister(reg));
+        break;
+      case DataType::Type::kFloat64:
+        __ vmovupd(address, YmmRegister(reg));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
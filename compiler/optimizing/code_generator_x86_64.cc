@@ -998,6 +998,7 @@ HInvokeStaticOrDirect::DispatchInfo CodeGeneratorX86_64::GetSupportedInvokeStati
 void CodeGeneratorX86_64::GenerateStaticOrDirectCall(
     HInvokeStaticOrDirect* invoke, Location temp, SlowPathCode* slow_path) {
   // All registers are assumed to be correctly set up.
+  MaybeEmitVZeroUpper();
 
   Location callee_method = temp;  // For all kinds except kRecursive, callee will be in temp.
   switch (invoke->GetMethodLoadKind()) {
@@ -1097,6 +1098,7 @@ void CodeGeneratorX86_64::GenerateStaticOrDirectCall(
 
 void CodeGeneratorX86_64::GenerateVirtualCall(
     HInvokeVirtual* invoke, Location temp_in, SlowPathCode* slow_path) {
+  MaybeEmitVZeroUpper();
   CpuRegister temp = temp_in.AsRegister<CpuRegister>();
   size_t method_offset = mirror::Class::EmbeddedVTableEntryOffset(
       invoke->GetVTableIndex(), kX86_64PointerSize).SizeValue();
@@ -1299,7 +1301,9 @@ size_t CodeGeneratorX86_64::RestoreCoreRegister(size_t stack_index, uint32_t reg
 }
 
 size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (GetGraph()->HasSIMD() && HasWideSIMDRegisters()) {
+    __ vmovups(Address(CpuRegister(RSP), stack_index), YmmRegister(reg_id));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   } else {
     __ movsd(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
@@ -1308,7 +1312,9 @@ size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32
 }
 
 size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
-  if (GetGraph()->HasSIMD()) {
+  if (GetGraph()->HasSIMD() && HasWideSIMDRegisters()) {
+    __ vmovups(YmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
+  } else if (GetGraph()->HasSIMD()) {
     __ movups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   } else {
     __ movsd(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
@@ -1316,6 +1322,14 @@ size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uin
   return GetSlowPathFPWidth();
 }
 
+void CodeGeneratorX86_64::MaybeEmitVZeroUpper() {
+  // Clear the upper halves of the YMM registers before leaving code that may have used them,
+  // to avoid the AVX-SSE transition penalty in the callee or caller.
+  if (GetGraph()->HasSIMD() && HasWideSIMDRegisters()) {
+    __ vzeroupper();
+  }
+}
+
 void CodeGeneratorX86_64::InvokeRuntime(QuickEntrypointEnum entrypoint,
                                         HInstruction* instruction,
                                         uint32_t dex_pc,
@@ -1335,6 +1349,7 @@ void CodeGeneratorX86_64::InvokeRuntimeWithoutRecordingPcInfo(int32_t entry_poin
 }
 
 void CodeGeneratorX86_64::GenerateInvokeRuntime(int32_t entry_point_offset) {
+  MaybeEmitVZeroUpper();
   __ gs()->call(Address::Absolute(entry_point_offset, /* no_rip= */ true));
 }
 
@@ -1413,7 +1428,8 @@ void CodeGeneratorX86_64::MaybeIncrementHotness(bool is_frame_entry) {
     __ Bind(&overflow);
   }
 
-  if (GetGraph()->IsCompilingBaseline() && !Runtime::Current()->IsAotCompiler()) {
+  if ((GetGraph()->IsCompilingBaseline() || GetGraph()->IsCompilingFastTier()) &&
+      !Runtime::Current()->IsAotCompiler()) {
     ScopedObjectAccess soa(Thread::Current());
     ProfilingInfo* info = GetGraph()->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
     if (info != nullptr) {
@@ -1526,6 +1542,7 @@ void CodeGeneratorX86_64::GenerateFrameExit() {
       }
     }
   }
+  MaybeEmitVZeroUpper();
   __ ret();
   __ cfi().RestoreState();
   __ cfi().DefCFAOffset(GetFrameSize());
@@ -1886,8 +1903,34 @@ void InstructionCodeGeneratorX86_64::GenerateTestAndBranch(HInstruction* instruc
 void LocationsBuilderX86_64::VisitIf(HIf* if_instr) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(if_instr);
   if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
-    locations->SetInAt(0, Location::Any());
+    locations->SetInAt(0, codegen_->IsProfilingBranch(if_instr)
+        ? Location::RequiresRegister()
+        : Location::Any());
+  }
+}
+
+void InstructionCodeGeneratorX86_64::MaybeIncrementBranchCounter(HIf* if_instr) {
+  if (!codegen_->IsProfilingBranch(if_instr)) {
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ProfilingInfo* info = GetGraph()->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
+  BranchCache* cache = (info != nullptr) ? info->GetBranchCache(if_instr->GetDexPc()) : nullptr;
+  if (cache == nullptr) {
+    return;
   }
+  static_assert(BranchCache::TrueOffset().Int32Value() ==
+                    BranchCache::FalseOffset().Int32Value() + 2,
+                "The condition indexes the counts");
+  uint64_t address = reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+  CpuRegister condition = if_instr->GetLocations()->InAt(0).AsRegister<CpuRegister>();
+  Address counter(CpuRegister(TMP), condition, TIMES_2, 0);
+  NearLabel done;
+  __ movq(CpuRegister(TMP), Immediate(address));
+  __ cmpw(counter, Immediate(std::numeric_limits<uint16_t>::max()));
+  __ j(kEqual, &done);
+  __ addw(counter, Immediate(1));
+  __ Bind(&done);
 }
 
 void InstructionCodeGeneratorX86_64::VisitIf(HIf* if_instr) {
@@ -1897,6 +1940,7 @@ void InstructionCodeGeneratorX86_64::VisitIf(HIf* if_instr) {
       nullptr : codegen_->GetLabelOf(true_successor);
   Label* false_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor) ?
       nullptr : codegen_->GetLabelOf(false_successor);
+  MaybeIncrementBranchCounter(if_instr);
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
@@ -2706,6 +2750,7 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
 
 void InstructionCodeGeneratorX86_64::VisitInvokeInterface(HInvokeInterface* invoke) {
   // TODO: b/18116999, our IMTs can miss an IncompatibleClassChangeError.
+  codegen_->MaybeEmitVZeroUpper();
   LocationSummary* locations = invoke->GetLocations();
   CpuRegister temp = locations->GetTemp(0).AsRegister<CpuRegister>();
   CpuRegister hidden_reg = locations->GetTemp(1).AsRegister<CpuRegister>();
@@ -5837,15 +5882,21 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsSIMDStackSlot()) {
     if (destination.IsFpuRegister()) {
-      __ movups(destination.AsFpuRegister<XmmRegister>(),
-                Address(CpuRegister(RSP), source.GetStackIndex()));
+      if (codegen_->HasWideSIMDRegisters()) {
+        __ vmovups(YmmRegister(destination.AsFpuRegister<XmmRegister>()),
+                   Address(CpuRegister(RSP), source.GetStackIndex()));
+      } else {
+        __ movups(destination.AsFpuRegister<XmmRegister>(),
+                  Address(CpuRegister(RSP), source.GetStackIndex()));
+      }
     } else {
       DCHECK(destination.IsSIMDStackSlot());
-      size_t high = kX86_64WordSize;
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + high));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + high), CpuRegister(TMP));
+      for (size_t offset = 0; offset < codegen_->GetSIMDRegisterWidth();
+           offset += kX86_64WordSize) {
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset),
+                CpuRegister(TMP));
+      }
     }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
@@ -5893,7 +5944,12 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsFpuRegister()) {
     if (destination.IsFpuRegister()) {
-      __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      if (codegen_->GetGraph()->HasSIMD() && codegen_->HasWideSIMDRegisters()) {
+        __ vmovaps(YmmRegister(destination.AsFpuRegister<XmmRegister>()),
+                   YmmRegister(source.AsFpuRegister<XmmRegister>()));
+      } else {
+        __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      }
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
@@ -5902,8 +5958,13 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
                source.AsFpuRegister<XmmRegister>());
     } else {
        DCHECK(destination.IsSIMDStackSlot());
-      __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
-                source.AsFpuRegister<XmmRegister>());
+      if (codegen_->HasWideSIMDRegisters()) {
+        __ vmovups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                   YmmRegister(source.AsFpuRegister<XmmRegister>()));
+      } else {
+        __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                  source.AsFpuRegister<XmmRegister>());
+      }
     }
   }
 }
@@ -5947,6 +6008,15 @@ void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
   __ addq(CpuRegister(RSP), Immediate(extra_slot));
 }
 
+void ParallelMoveResolverX86_64::Exchange256(XmmRegister reg, int mem) {
+  size_t extra_slot = 4 * kX86_64WordSize;
+  __ subq(CpuRegister(RSP), Immediate(extra_slot));
+  __ vmovups(Address(CpuRegister(RSP), 0), YmmRegister(reg));
+  ExchangeMemory64(0, mem + extra_slot, 4);
+  __ vmovups(YmmRegister(reg), Address(CpuRegister(RSP), 0));
+  __ addq(CpuRegister(RSP), Immediate(extra_slot));
+}
+
 void ParallelMoveResolverX86_64::ExchangeMemory32(int mem1, int mem2) {
   ScratchRegisterScope ensure_scratch(
       this, TMP, RAX, codegen_->GetNumberOfCoreRegisters());
@@ -5999,6 +6069,14 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
     Exchange64(destination.AsRegister<CpuRegister>(), source.GetStackIndex());
   } else if (source.IsDoubleStackSlot() && destination.IsDoubleStackSlot()) {
     ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 1);
+  } else if (source.IsFpuRegister() && destination.IsFpuRegister() &&
+             codegen_->GetGraph()->HasSIMD() && codegen_->HasWideSIMDRegisters()) {
+    // There is no scratch YMM register, swap the full width with three XORs.
+    YmmRegister src(source.AsFpuRegister<XmmRegister>());
+    YmmRegister dst(destination.AsFpuRegister<XmmRegister>());
+    __ vxorps(src, src, dst);
+    __ vxorps(dst, dst, src);
+    __ vxorps(src, src, dst);
   } else if (source.IsFpuRegister() && destination.IsFpuRegister()) {
     __ movd(CpuRegister(TMP), source.AsFpuRegister<XmmRegister>());
     __ movaps(source.AsFpuRegister<XmmRegister>(), destination.AsFpuRegister<XmmRegister>());
@@ -6012,11 +6090,21 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
-    ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 2);
+    ExchangeMemory64(destination.GetStackIndex(),
+                     source.GetStackIndex(),
+                     codegen_->GetSIMDRegisterWidth() / kX86_64WordSize);
   } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
-    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    if (codegen_->HasWideSIMDRegisters()) {
+      Exchange256(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    } else {
+      Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    }
   } else if (destination.IsFpuRegister() && source.IsSIMDStackSlot()) {
-    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    if (codegen_->HasWideSIMDRegisters()) {
+      Exchange256(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    } else {
+      Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    }
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
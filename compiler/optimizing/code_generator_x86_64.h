@@ -168,6 +168,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
   void Exchange128(XmmRegister reg, int mem);
+  void Exchange256(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -300,6 +301,7 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
   void PushOntoFPStack(Location source, uint32_t temp_offset,
                        uint32_t stack_adjustment, bool is_float);
   void GenerateCompareTest(HCondition* condition);
+  void MaybeIncrementBranchCounter(HIf* if_instr);
   template<class LabelType>
   void GenerateTestAndBranch(HInstruction* instruction,
                              size_t condition_input_index,
@@ -359,6 +361,9 @@ class CodeGeneratorX86_64 : public CodeGenerator {
 
   void GenerateInvokeRuntime(int32_t entry_point_offset);
 
+  // Emit VZEROUPPER if the method may have dirtied the upper halves of the YMM registers.
+  void MaybeEmitVZeroUpper();
+
   size_t GetWordSize() const override {
     return kX86_64WordSize;
   }
@@ -374,7 +379,13 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   }
 
   size_t GetSIMDRegisterWidth() const override {
-    return 2 * kX86_64WordSize;
+    // With AVX2 the loop vectorizer operates on the full 256-bit YMM registers.
+    return (GetInstructionSetFeatures().HasAVX2() ? 4 : 2) * kX86_64WordSize;
+  }
+
+  // Whether SIMD values occupy the full 256-bit YMM registers.
+  bool HasWideSIMDRegisters() const {
+    return GetSIMDRegisterWidth() == 4 * kX86_64WordSize;
   }
 
   HGraphVisitor* GetLocationBuilder() override {
@@ -40,6 +40,7 @@ bool CodeSinking::Run() {
       SinkCodeToUncommonBranch(exit_predecessor);
     }
   }
+  SinkAllocationsToUses();
   return true;
 }
 
@@ -438,4 +439,199 @@ void CodeSinking::SinkCodeToUncommonBranch(HBasicBlock* end_block) {
   }
 }
 
+// Returns whether `user` is a store initializing the fresh `allocation` (or a constructor
+// fence protecting only that allocation) which can move along with it.
+static bool IsMovableInitializingStore(HInstruction* allocation, HInstruction* user) {
+  if (user->GetBlock() != allocation->GetBlock() || user->InputAt(0) != allocation) {
+    return false;
+  }
+  if (user->IsConstructorFence()) {
+    return user->InputCount() == 1u;
+  } else if (user->IsInstanceFieldSet()) {
+    return !user->AsInstanceFieldSet()->IsVolatile() && user->InputAt(1) != allocation;
+  } else if (user->IsArraySet()) {
+    return !user->CanThrow() && user->InputAt(1) != allocation && user->InputAt(2) != allocation;
+  }
+  return false;
+}
+
+// Returns whether some path from `block` reaches the exit without going through `target`,
+// that is whether `target` does not post dominate `block`.
+static bool CanBypass(HBasicBlock* block,
+                      HBasicBlock* target,
+                      ArenaBitVector* visited,
+                      ScopedArenaVector<HBasicBlock*>* worklist) {
+  visited->ClearAllBits();
+  worklist->clear();
+  visited->SetBit(target->GetBlockId());
+  worklist->push_back(block);
+  while (!worklist->empty()) {
+    HBasicBlock* current = worklist->back();
+    worklist->pop_back();
+    if (current->IsExitBlock()) {
+      return true;
+    }
+    for (HBasicBlock* successor : current->GetSuccessors()) {
+      if (!visited->IsBitSet(successor->GetBlockId())) {
+        visited->SetBit(successor->GetBlockId());
+        worklist->push_back(successor);
+      }
+    }
+  }
+  return false;
+}
+
+// Find where `allocation` and its initializing stores can be sunk to: before the first use
+// in the block dominating all other uses. Returns nullptr if that block is the allocation's
+// own block, or if all paths from the allocation go through it anyways.
+static HInstruction* FindAllocationSinkingPosition(HInstruction* allocation,
+                                                   ArenaBitVector* visited,
+                                                   ScopedArenaVector<HBasicBlock*>* worklist) {
+  HBasicBlock* block = allocation->GetBlock();
+  HGraph* graph = block->GetGraph();
+  // Avoid changing when finalizable objects are created, and do not move
+  // allocations in or out of try/catch blocks.
+  if ((allocation->IsNewInstance() && allocation->AsNewInstance()->IsFinalizable()) ||
+      block->GetTryCatchInformation() != nullptr) {
+    return nullptr;
+  }
+
+  CommonDominator finder(/* block= */ nullptr);
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (IsMovableInitializingStore(allocation, user)) {
+      continue;
+    }
+    HBasicBlock* user_block = user->GetBlock();
+    if (user->IsPhi()) {
+      if (user->AsPhi()->IsCatchPhi()) {
+        return nullptr;
+      }
+      user_block = user_block->GetPredecessors()[use.GetIndex()];
+    }
+    finder.Update(user_block);
+  }
+  HBasicBlock* target_block = finder.Get();
+  if (target_block == nullptr) {
+    // No use other than stores. Likely a LSE or DCE limitation.
+    return nullptr;
+  }
+  DCHECK(block->Dominates(target_block));
+
+  // Never move an allocation into a loop, as it would then be executed once per iteration.
+  while (target_block->GetLoopInformation() != block->GetLoopInformation()) {
+    target_block = target_block->GetDominator();
+  }
+  if (target_block == block ||
+      target_block->GetTryCatchInformation() != nullptr ||
+      !CanBypass(block, target_block, visited, worklist)) {
+    return nullptr;
+  }
+
+  // Environment uses not dominated by the new position will be dropped. Bail if one of
+  // them needs the value.
+  for (const HUseListNode<HEnvironment*>& use : allocation->GetEnvUses()) {
+    HInstruction* user = use.GetUser()->GetHolder();
+    if (!target_block->Dominates(user->GetBlock())) {
+      if (graph->IsDebuggable() ||
+          user->IsDeoptimize() ||
+          user->CanThrowIntoCatchBlock() ||
+          (user->IsSuspendCheck() && graph->IsCompilingOsr())) {
+        return nullptr;
+      }
+    }
+  }
+
+  // Find insertion position.
+  HInstruction* insert_pos = nullptr;
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (!user->IsPhi() &&
+        user->GetBlock() == target_block &&
+        (insert_pos == nullptr || user->StrictlyDominates(insert_pos))) {
+      insert_pos = user;
+    }
+  }
+  for (const HUseListNode<HEnvironment*>& use : allocation->GetEnvUses()) {
+    HInstruction* user = use.GetUser()->GetHolder();
+    if (user->GetBlock() == target_block &&
+        (insert_pos == nullptr || user->StrictlyDominates(insert_pos))) {
+      insert_pos = user;
+    }
+  }
+  if (insert_pos == nullptr) {
+    // No user in `target_block`, insert before the control flow instruction.
+    insert_pos = target_block->GetLastInstruction();
+    DCHECK(insert_pos->IsControlFlow());
+    // Avoid splitting HCondition from HIf to prevent unnecessary materialization.
+    if (insert_pos->IsIf()) {
+      HInstruction* if_input = insert_pos->AsIf()->InputAt(0);
+      if (if_input == insert_pos->GetPrevious()) {
+        insert_pos = if_input;
+      }
+    }
+  }
+  DCHECK(!insert_pos->IsPhi());
+  return insert_pos;
+}
+
+void CodeSinking::SinkAllocationsToUses() {
+  // Local allocator to discard data structures created below at the end of this optimization.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+
+  // Visit later allocations first, so that an allocation only stored into another
+  // sunk allocation can follow it.
+  ScopedArenaVector<HInstruction*> allocations(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetPostOrder()) {
+    for (HBackwardInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsNewInstance() || instruction->IsNewArray()) {
+        allocations.push_back(instruction);
+      }
+    }
+  }
+  if (allocations.empty()) {
+    return;
+  }
+
+  ArenaBitVector visited(&allocator, graph_->GetBlocks().size(), /* expandable= */ false);
+  ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocMisc));
+  ScopedArenaVector<HInstruction*> stores(allocator.Adapter(kArenaAllocMisc));
+  for (HInstruction* allocation : allocations) {
+    HInstruction* position = FindAllocationSinkingPosition(allocation, &visited, &worklist);
+    if (position == nullptr) {
+      continue;
+    }
+    HBasicBlock* target_block = position->GetBlock();
+
+    // Drop the environment uses the new position does not dominate.
+    for (auto it = allocation->GetEnvUses().begin(); it != allocation->GetEnvUses().end();) {
+      HEnvironment* environment = it->GetUser();
+      size_t index = it->GetIndex();
+      ++it;  // Advance before removing the use.
+      if (!target_block->Dominates(environment->GetHolder()->GetBlock())) {
+        environment->RemoveAsUserOfInput(index);
+        environment->SetRawEnvAt(index, nullptr);
+      }
+    }
+
+    // Move the allocation, then its stores in their original order.
+    stores.clear();
+    for (HInstruction* instruction = allocation->GetNext();
+         instruction != nullptr;
+         instruction = instruction->GetNext()) {
+      if (IsMovableInitializingStore(allocation, instruction)) {
+        stores.push_back(instruction);
+      }
+    }
+    allocation->MoveBefore(position, /* do_checks= */ false);
+    for (HInstruction* store : stores) {
+      store->MoveBefore(position, /* do_checks= */ false);
+    }
+    MaybeRecordStat(stats_, MethodCompilationStat::kAllocationSunk);
+    MaybeRecordStat(
+        stats_, MethodCompilationStat::kInstructionSunk, static_cast<uint32_t>(1u + stores.size()));
+  }
+}
+
 }  // namespace art
@@ -23,8 +23,8 @@
 namespace art {
 
 /**
- * Optimization pass to move instructions into uncommon branches,
- * when it is safe to do so.
+ * Optimization pass to move instructions into uncommon branches, and
+ * allocations into the branches using them, when it is safe to do so.
  */
 class CodeSinking : public HOptimization {
  public:
@@ -42,6 +42,11 @@ class CodeSinking : public HOptimization {
   // blocks, to these blocks.
   void SinkCodeToUncommonBranch(HBasicBlock* end_block);
 
+  // Try to move allocations, together with the stores initializing them, out of their
+  // block into the branches that use them, so that paths not needing the object do
+  // not allocate it.
+  void SinkAllocationsToUses();
+
   DISALLOW_COPY_AND_ASSIGN(CodeSinking);
 };
 
@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 
+#include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "base/macros.h"
+#include "base/malloc_arena_pool.h"
+#include "base/memory_region.h"
 #include "base/utils.h"
 #include "builder.h"
 #include "codegen_test_utils.h"
@@ -30,6 +34,7 @@
 #include "utils/arm/assembler_arm_vixl.h"
 #include "utils/arm/managed_register_arm.h"
 #include "utils/x86/managed_register_x86.h"
+#include "utils/x86_64/assembler_x86_64.h"
 
 #include "gtest/gtest.h"
 
@@ -709,6 +714,100 @@ TEST_F(CodegenTest, ComparisonsLong) {
   }
 }
 
+#ifdef ART_ENABLE_CODEGEN_x86_64
+// Returns whether `code` contains the code that `emit` generates with `features`.
+template <typename EmitFn>
+static bool ContainsX86_64Code(ArrayRef<const uint8_t> code,
+                               const X86_64InstructionSetFeatures* features,
+                               EmitFn emit) {
+  MallocArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  x86_64::X86_64Assembler assembler(&allocator, features);
+  emit(&assembler);
+  assembler.FinalizeCode();
+  std::vector<uint8_t> expected(assembler.CodeSize());
+  MemoryRegion region(expected.data(), expected.size());
+  assembler.FinalizeInstructions(region);
+  return std::search(code.begin(), code.end(), expected.begin(), expected.end()) != code.end();
+}
+
+// Check that with AVX2 the SIMD values use the full YMM registers in moves, swaps and spills.
+TEST_F(CodegenTest, X86_64ParallelMoveResolverAVX2) {
+  OverrideInstructionSetFeatures(InstructionSet::kX86_64, "kabylake");
+  HGraph* graph = CreateGraph();
+  x86_64::CodeGeneratorX86_64 codegen(graph, *compiler_options_);
+  const X86_64InstructionSetFeatures* features =
+      compiler_options_->GetInstructionSetFeatures()->AsX86_64InstructionSetFeatures();
+
+  codegen.Initialize();
+  graph->SetHasSIMD(true);
+  ASSERT_EQ(32u, codegen.GetSIMDRegisterWidth());
+  ASSERT_TRUE(codegen.HasWideSIMDRegisters());
+
+  HParallelMove* move = new (graph->GetAllocator()) HParallelMove(graph->GetAllocator());
+  // Exchange256 of a register and a SIMD stack slot.
+  move->AddMove(Location::FpuRegisterLocation(2),
+                Location::SIMDStackSlot(64),
+                DataType::Type::kFloat64,
+                nullptr);
+  move->AddMove(Location::SIMDStackSlot(64),
+                Location::FpuRegisterLocation(2),
+                DataType::Type::kFloat64,
+                nullptr);
+  // Swap of two registers.
+  move->AddMove(Location::FpuRegisterLocation(0),
+                Location::FpuRegisterLocation(1),
+                DataType::Type::kFloat64,
+                nullptr);
+  move->AddMove(Location::FpuRegisterLocation(1),
+                Location::FpuRegisterLocation(0),
+                DataType::Type::kFloat64,
+                nullptr);
+  codegen.GetMoveResolver()->EmitNativeCode(move);
+  EXPECT_EQ(32u, codegen.SaveFloatingPointRegister(/* stack_index= */ 128u, /* reg_id= */ 3u));
+  codegen.MaybeEmitVZeroUpper();
+
+  InternalCodeAllocator code_allocator;
+  codegen.Finalize(&code_allocator);
+  ArrayRef<const uint8_t> code = code_allocator.GetMemory();
+
+  using x86_64::Address;
+  using x86_64::CpuRegister;
+  using x86_64::X86_64Assembler;
+  using x86_64::YmmRegister;
+  EXPECT_TRUE(ContainsX86_64Code(code, features, [](X86_64Assembler* assembler) {
+    assembler->vmovups(Address(CpuRegister(x86_64::RSP), 0), YmmRegister(2));
+  }));
+  EXPECT_TRUE(ContainsX86_64Code(code, features, [](X86_64Assembler* assembler) {
+    assembler->vmovups(YmmRegister(2), Address(CpuRegister(x86_64::RSP), 0));
+  }));
+  EXPECT_TRUE(ContainsX86_64Code(code, features, [](X86_64Assembler* assembler) {
+    assembler->vxorps(YmmRegister(0), YmmRegister(0), YmmRegister(1));
+    assembler->vxorps(YmmRegister(1), YmmRegister(1), YmmRegister(0));
+    assembler->vxorps(YmmRegister(0), YmmRegister(0), YmmRegister(1));
+  }));
+  EXPECT_TRUE(ContainsX86_64Code(code, features, [](X86_64Assembler* assembler) {
+    assembler->vmovups(Address(CpuRegister(x86_64::RSP), 128), YmmRegister(3));
+  }));
+  EXPECT_TRUE(ContainsX86_64Code(code, features, [](X86_64Assembler* assembler) {
+    assembler->vzeroupper();
+  }));
+}
+
+// Check that without AVX2 the SIMD values stay in the XMM registers.
+TEST_F(CodegenTest, X86_64SIMDRegisterWidthSSE) {
+  OverrideInstructionSetFeatures(InstructionSet::kX86_64, "silvermont");
+  HGraph* graph = CreateGraph();
+  x86_64::CodeGeneratorX86_64 codegen(graph, *compiler_options_);
+
+  codegen.Initialize();
+  graph->SetHasSIMD(true);
+  EXPECT_EQ(16u, codegen.GetSIMDRegisterWidth());
+  EXPECT_FALSE(codegen.HasWideSIMDRegisters());
+  EXPECT_EQ(16u, codegen.SaveFloatingPointRegister(/* stack_index= */ 0u, /* reg_id= */ 0u));
+}
+#endif
+
 #ifdef ART_ENABLE_CODEGEN_arm
 TEST_F(CodegenTest, ARMVIXLParallelMoveResolver) {
   OverrideInstructionSetFeatures(InstructionSet::kThumb2, "default");
@@ -547,6 +547,7 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
 
   void VisitVecOperation(HVecOperation* vec_operation) override {
     StartAttributeStream("packed_type") << vec_operation->GetPackedType();
+    StartAttributeStream("vector_length") << vec_operation->GetVectorLength();
   }
 
   void VisitVecMemoryOperation(HVecMemoryOperation* vec_mem_operation) override {
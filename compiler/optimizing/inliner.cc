@@ -34,6 +34,7 @@
 #include "intrinsics.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jit/jit_logger.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
 #include "mirror/object_array-alloc-inl.h"
@@ -65,6 +66,15 @@ static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 32;
 // much inlining compared to code locality.
 static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 
+// Scaling of the instruction, environment and callee size limits above for call sites
+// the profile shows to be hot, and of the callee size limit for cold call sites.
+static constexpr size_t kHotCallSiteBudgetMultiplier = 2;
+static constexpr size_t kColdCallSiteCodeUnitsDivisor = 4;
+
+// Minimum number of executions of a profiled branch for a never taken edge to make
+// the call sites it leads to cold. Matches the threshold used for block layout.
+static constexpr uint32_t kMinimumBranchCountForColdCallSite = 100;
+
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
@@ -78,7 +88,8 @@ static constexpr bool kUseAOTInlineCaches = true;
 #define LOG_TRY() LOG_INTERNAL("Try inlinining call: ")
 #define LOG_NOTE() LOG_INTERNAL("Note: ")
 #define LOG_SUCCESS() LOG_INTERNAL("Success: ")
-#define LOG_FAIL(stats_ptr, stat) MaybeRecordStat(stats_ptr, stat); LOG_INTERNAL("Fail: ")
+#define LOG_FAIL(stats_ptr, stat) \
+  MaybeRecordStat(stats_ptr, stat); RecordInlineFailure(stat); LOG_INTERNAL("Fail: ")
 #define LOG_FAIL_NO_STAT() LOG_INTERNAL("Fail: ")
 
 std::string HInliner::DepthString(int line) const {
@@ -116,14 +127,96 @@ static size_t CountNumberOfInstructions(HGraph* graph) {
 }
 
 void HInliner::UpdateInliningBudget() {
-  if (total_number_of_instructions_ >= kMaximumNumberOfTotalInstructions) {
+  size_t maximum_number_of_total_instructions = GetMaximumNumberOfTotalInstructions();
+  if (call_site_hotness_ == CallSiteHotness::kCold ||
+      total_number_of_instructions_ >= maximum_number_of_total_instructions) {
     // Always try to inline small methods.
     inlining_budget_ = kMaximumNumberOfInstructionsForSmallMethod;
   } else {
     inlining_budget_ = std::max(
         kMaximumNumberOfInstructionsForSmallMethod,
-        kMaximumNumberOfTotalInstructions - total_number_of_instructions_);
+        maximum_number_of_total_instructions - total_number_of_instructions_);
+  }
+}
+
+size_t HInliner::GetMaximumNumberOfTotalInstructions() const {
+  return (call_site_hotness_ == CallSiteHotness::kHot)
+      ? kMaximumNumberOfTotalInstructions * kHotCallSiteBudgetMultiplier
+      : kMaximumNumberOfTotalInstructions;
+}
+
+size_t HInliner::GetMaximumNumberOfCumulatedDexRegisters() const {
+  return (call_site_hotness_ == CallSiteHotness::kHot)
+      ? kMaximumNumberOfCumulatedDexRegisters * kHotCallSiteBudgetMultiplier
+      : kMaximumNumberOfCumulatedDexRegisters;
+}
+
+size_t HInliner::GetInlineMaxCodeUnits() const {
+  size_t inline_max_code_units = codegen_->GetCompilerOptions().GetInlineMaxCodeUnits();
+  switch (call_site_hotness_) {
+    case CallSiteHotness::kCold:
+      return inline_max_code_units / kColdCallSiteCodeUnitsDivisor;
+    case CallSiteHotness::kDefault:
+      return inline_max_code_units;
+    case CallSiteHotness::kHot:
+      return inline_max_code_units * kHotCallSiteBudgetMultiplier;
+  }
+  UNREACHABLE();
+}
+
+// Returns whether the branch profile shows that `block` was never reached, that is
+// a dominating branch was executed often enough but never took the edge leading
+// to `block`.
+static bool IsNeverReachedInBranchProfile(HBasicBlock* block) {
+  for (HBasicBlock* dominator = block->GetDominator();
+       dominator != nullptr;
+       dominator = dominator->GetDominator()) {
+    HIf* if_instr = dominator->GetLastInstruction()->AsIf();
+    if (if_instr == nullptr ||
+        if_instr->GetTrueCount() + if_instr->GetFalseCount() <
+            kMinimumBranchCountForColdCallSite) {
+      continue;
+    }
+    HBasicBlock* true_successor = if_instr->IfTrueSuccessor();
+    HBasicBlock* false_successor = if_instr->IfFalseSuccessor();
+    if (true_successor != false_successor) {
+      if (true_successor->Dominates(block) && if_instr->GetTrueCount() == 0u) {
+        return true;
+      }
+      if (false_successor->Dominates(block) && if_instr->GetFalseCount() == 0u) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+HInliner::CallSiteHotness HInliner::ComputeCallSiteHotness(HInvoke* invoke_instruction) const {
+  DCHECK_EQ(depth_, 0u);
+  if (graph_->IsCompilingBaseline()) {
+    return CallSiteHotness::kDefault;
+  }
+  HBasicBlock* block = invoke_instruction->GetBlock();
+  if (Runtime::Current()->UseJitCompilation()) {
+    // Only the branches of the outermost method carry counts, see HInstructionBuilder.
+    if (IsNeverReachedInBranchProfile(block)) {
+      return CallSiteHotness::kCold;
+    }
+  } else {
+    const ProfileCompilationInfo* pci =
+        codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+    if (pci == nullptr) {
+      return CallSiteHotness::kDefault;
+    }
+    ProfileCompilationInfo::MethodHotness hotness = pci->GetMethodHotness(MethodReference(
+        caller_compilation_unit_.GetDexFile(), caller_compilation_unit_.GetDexMethodIndex()));
+    if (!hotness.IsHot()) {
+      return CallSiteHotness::kCold;
+    }
   }
+  // The method itself is hot. Calls in its loops run most often.
+  return (block->GetLoopInformation() != nullptr) ? CallSiteHotness::kHot
+                                                  : CallSiteHotness::kDefault;
 }
 
 bool HInliner::Run() {
@@ -177,7 +270,7 @@ bool HInliner::Run() {
               call->GetDexMethodIndex(), /* with_signature= */ false);
           // Tests prevent inlining by having $noinline$ in their method names.
           if (callee_name.find("$noinline$") == std::string::npos) {
-            if (TryInline(call)) {
+            if (TryInlineAndRecordDecision(call)) {
               didInline = true;
             } else if (honor_inline_directives) {
               bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
@@ -187,7 +280,7 @@ bool HInliner::Run() {
         } else {
           DCHECK(!honor_inline_directives);
           // Normal case: try to inline.
-          if (TryInline(call)) {
+          if (TryInlineAndRecordDecision(call)) {
             didInline = true;
           }
         }
@@ -390,6 +483,10 @@ ArtMethod* HInliner::TryCHADevirtualization(ArtMethod* resolved_method) {
     // We do not support HDeoptimize in OSR methods.
     return nullptr;
   }
+  if (outermost_graph_->IsSpeculationDisabled(DeoptimizationKind::kCHA)) {
+    // CHA guards previously failed for this method.
+    return nullptr;
+  }
   PointerSize pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
   ArtMethod* single_impl = resolved_method->GetSingleImplementation(pointer_size);
   if (single_impl == nullptr) {
@@ -488,6 +585,31 @@ ArtMethod* HInliner::FindActualCallTarget(HInvoke* invoke_instruction, bool* cha
   return actual_method;
 }
 
+bool HInliner::TryInlineAndRecordDecision(HInvoke* invoke_instruction) {
+  jit::JitCompilationEvent* event = outermost_graph_->GetCompilationEvent();
+  if (event == nullptr) {
+    return TryInline(invoke_instruction);
+  }
+  // Add the decision before trying to inline, so that the decisions of the inliners
+  // of the callee follow it.
+  size_t index = event->inlining_decisions.size();
+  event->inlining_decisions.push_back(jit::JitCompilationEvent::InliningDecision {
+      depth_,
+      /* inlined= */ false,
+      caller_compilation_unit_.GetDexFile()->PrettyMethod(invoke_instruction->GetDexMethodIndex()),
+      /* has_failure_reason= */ false,
+      MethodCompilationStat::kNotInlinedWont });
+  has_inline_failure_reason_ = false;
+  bool inlined = TryInline(invoke_instruction);
+  jit::JitCompilationEvent::InliningDecision& decision = event->inlining_decisions[index];
+  decision.inlined = inlined;
+  if (!inlined && has_inline_failure_reason_) {
+    decision.has_failure_reason = true;
+    decision.failure_reason = inline_failure_reason_;
+  }
+  return inlined;
+}
+
 bool HInliner::TryInline(HInvoke* invoke_instruction) {
   MaybeRecordStat(stats_, MethodCompilationStat::kTryInline);
 
@@ -495,12 +617,15 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
   // polymorphic (invoke-{polymorphic,custom}).
   if (invoke_instruction->IsInvokeUnresolved()) {
     MaybeRecordStat(stats_, MethodCompilationStat::kNotInlinedUnresolved);
+    RecordInlineFailure(MethodCompilationStat::kNotInlinedUnresolved);
     return false;
   } else if (invoke_instruction->IsInvokePolymorphic()) {
     MaybeRecordStat(stats_, MethodCompilationStat::kNotInlinedPolymorphic);
+    RecordInlineFailure(MethodCompilationStat::kNotInlinedPolymorphic);
     return false;
   } else if (invoke_instruction->IsInvokeCustom()) {
     MaybeRecordStat(stats_, MethodCompilationStat::kNotInlinedCustom);
+    RecordInlineFailure(MethodCompilationStat::kNotInlinedCustom);
     return false;
   }
 
@@ -509,6 +634,19 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
   const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
   LOG_TRY() << caller_dex_file.PrettyMethod(method_index);
 
+  if (depth_ == 0u) {
+    call_site_hotness_ = ComputeCallSiteHotness(invoke_instruction);
+    UpdateInliningBudget();
+    if (call_site_hotness_ != CallSiteHotness::kDefault) {
+      LOG_NOTE() << "Call site is "
+                 << (call_site_hotness_ == CallSiteHotness::kHot ? "hot" : "cold");
+      MaybeRecordStat(stats_,
+                      call_site_hotness_ == CallSiteHotness::kHot
+                          ? MethodCompilationStat::kTryInlineHotCallSite
+                          : MethodCompilationStat::kTryInlineColdCallSite);
+    }
+  }
+
   ArtMethod* resolved_method = invoke_instruction->GetResolvedMethod();
   if (resolved_method == nullptr) {
     DCHECK(invoke_instruction->IsInvokeStaticOrDirect());
@@ -599,7 +737,12 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  //
+  // For JIT, if a type guard deoptimization already failed for the method, we do not
+  // speculate on inline caches anymore, see Jit::NotifyDeoptimization.
+  return Runtime::Current()->IsAotCompiler() ||
+      outermost_graph_->IsCompilingOsr() ||
+      outermost_graph_->IsSpeculationDisabled(DeoptimizationKind::kJitInlineCache);
 }
 bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
                                         HInvoke* invoke_instruction,
@@ -1271,7 +1414,8 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (outermost_graph_->IsCompilingOsr() ||
+      outermost_graph_->IsSpeculationDisabled(DeoptimizationKind::kJitSameTarget)) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
@@ -1517,7 +1661,7 @@ bool HInliner::IsInliningBudgetAvailable(ArtMethod* method,
     return false;
   }
 
-  size_t inline_max_code_units = codegen_->GetCompilerOptions().GetInlineMaxCodeUnits();
+  size_t inline_max_code_units = GetInlineMaxCodeUnits();
   if (accessor.InsnsSizeInCodeUnits() > inline_max_code_units) {
     LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedCodeItem)
         << "Method " << method->PrettyMethod()
@@ -1942,7 +2086,7 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
       }
       HInstruction* current = instr_it.Current();
       if (current->NeedsEnvironment() &&
-          (total_number_of_dex_registers_ >= kMaximumNumberOfCumulatedDexRegisters)) {
+          (total_number_of_dex_registers_ >= GetMaximumNumberOfCumulatedDexRegisters())) {
         LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedEnvironmentBudget)
             << "Method " << callee_dex_file.PrettyMethod(method_index)
             << " is not inlined because its caller has reached"
@@ -2048,8 +2192,10 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
       /* osr= */ false,
       /* is_shared_jit_code= */ graph_->IsCompilingForSharedJitCode(),
       /* baseline= */ graph_->IsCompilingBaseline(),
+      /* fast_tier= */ graph_->IsCompilingFastTier(),
       /* start_instruction_id= */ caller_instruction_counter);
   callee_graph->SetArtMethod(resolved_method);
+  callee_graph->SetDisabledSpeculations(graph_->GetDisabledSpeculations());
 
   // When they are needed, allocate `inline_stats_` on the Arena instead
   // of on the stack, as Clang might produce a stack frame too large
@@ -2139,7 +2285,7 @@ void HInliner::RunOptimizations(HGraph* callee_graph,
 
   // Bail early for pathological cases on the environment (for example recursive calls,
   // or too large environment).
-  if (total_number_of_dex_registers_ >= kMaximumNumberOfCumulatedDexRegisters) {
+  if (total_number_of_dex_registers_ >= GetMaximumNumberOfCumulatedDexRegisters()) {
     LOG_NOTE() << "Calls in " << callee_graph->GetArtMethod()->PrettyMethod()
              << " will not be inlined because the outer method has reached"
              << " its environment budget limit.";
@@ -2166,6 +2312,7 @@ void HInliner::RunOptimizations(HGraph* callee_graph,
                    total_number_of_instructions_ + number_of_instructions,
                    this,
                    depth_ + 1);
+  inliner.call_site_hotness_ = call_site_hotness_;
   inliner.Run();
 }
 
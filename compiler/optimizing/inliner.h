@@ -53,7 +53,10 @@ class HInliner : public HOptimization {
         parent_(parent),
         depth_(depth),
         inlining_budget_(0),
-        inline_stats_(nullptr) {}
+        call_site_hotness_(CallSiteHotness::kDefault),
+        inline_stats_(nullptr),
+        has_inline_failure_reason_(false),
+        inline_failure_reason_(MethodCompilationStat::kNotInlinedWont) {}
 
   bool Run() override;
 
@@ -69,8 +72,24 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  // How often a call site is expected to run, according to the profile. The inlining limits
+  // are scaled accordingly: hot call chains get inlined deeper and cold code stays compact.
+  enum class CallSiteHotness {
+    kCold,
+    kDefault,
+    kHot,
+  };
+
   bool TryInline(HInvoke* invoke_instruction);
 
+  // Calls TryInline and records the decision in the JIT compilation event log, if enabled.
+  bool TryInlineAndRecordDecision(HInvoke* invoke_instruction);
+
+  void RecordInlineFailure(MethodCompilationStat reason) const {
+    has_inline_failure_reason_ = true;
+    inline_failure_reason_ = reason;
+  }
+
   // Attempt to resolve the target of the invoke instruction to an acutal call
   // target.
   //
@@ -308,6 +327,15 @@ class HInliner : public HOptimization {
   // Update the inlining budget based on `total_number_of_instructions_`.
   void UpdateInliningBudget();
 
+  // Classify `invoke_instruction` of the outermost method from the JIT branch profile or
+  // the AOT profile.
+  CallSiteHotness ComputeCallSiteHotness(HInvoke* invoke_instruction) const;
+
+  // Inlining limits for the current call site, scaled by `call_site_hotness_`.
+  size_t GetMaximumNumberOfTotalInstructions() const;
+  size_t GetMaximumNumberOfCumulatedDexRegisters() const;
+  size_t GetInlineMaxCodeUnits() const;
+
   // Count the number of calls of `method` being inlined recursively.
   size_t CountRecursiveCallsOf(ArtMethod* method) const;
 
@@ -329,10 +357,19 @@ class HInliner : public HOptimization {
   // The budget left for inlining, in number of instructions.
   size_t inlining_budget_;
 
+  // Hotness of the call site being inlined. Inliners of callees inherit the hotness of the
+  // call site they were inlined from, as the profile does not cover their dex pcs.
+  CallSiteHotness call_site_hotness_;
+
   // Used to record stats about optimizations on the inlined graph.
   // If the inlining is successful, these stats are merged to the caller graph's stats.
   OptimizingCompilerStats* inline_stats_;
 
+  // Last reason reported for not inlining a call, for the JIT compilation event log.
+  // Mutable as some of the checks reporting failures are const.
+  mutable bool has_inline_failure_reason_;
+  mutable MethodCompilationStat inline_failure_reason_;
+
   DISALLOW_COPY_AND_ASSIGN(HInliner);
 };
 
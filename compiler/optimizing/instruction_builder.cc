@@ -30,6 +30,7 @@
 #include "driver/compiler_options.h"
 #include "imtable-inl.h"
 #include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
@@ -64,6 +65,7 @@ HInstructionBuilder::HInstructionBuilder(HGraph* graph,
       dex_compilation_unit_(dex_compilation_unit),
       outer_compilation_unit_(outer_compilation_unit),
       quicken_info_(interpreter_metadata),
+      profiling_info_(nullptr),
       compilation_stats_(compiler_stats),
       local_allocator_(local_allocator),
       locals_for_(local_allocator->Adapter(kArenaAllocGraphBuilder)),
@@ -325,6 +327,17 @@ bool HInstructionBuilder::Build() {
     native_debug_info_locations = FindNativeDebugInfoLocations();
   }
 
+  // The branch counts are indexed by the dex pcs of the outermost method, so they are not
+  // used for inlined methods.
+  if (code_generator_ != nullptr &&
+      code_generator_->GetCompilerOptions().ProfileBranches() &&
+      !graph_->IsCompilingBaseline() &&
+      dex_compilation_unit_ == outer_compilation_unit_ &&
+      graph_->GetArtMethod() != nullptr) {
+    ScopedObjectAccess soa(Thread::Current());
+    profiling_info_ = graph_->GetArtMethod()->GetProfilingInfo(kRuntimePointerSize);
+  }
+
   for (HBasicBlock* block : graph_->GetReversePostOrder()) {
     current_block_ = block;
     uint32_t block_dex_pc = current_block_->GetDexPc();
@@ -602,13 +615,25 @@ void HInstructionBuilder::InitializeParameters() {
   }
 }
 
+void HInstructionBuilder::SetBranchCounts(HIf* if_instr) {
+  if (profiling_info_ == nullptr) {
+    return;
+  }
+  BranchCache* cache = profiling_info_->GetBranchCache(if_instr->GetDexPc());
+  if (cache != nullptr) {
+    if_instr->SetBranchCounts(cache->GetTrue(), cache->GetFalse());
+  }
+}
+
 template<typename T>
 void HInstructionBuilder::If_22t(const Instruction& instruction, uint32_t dex_pc) {
   HInstruction* first = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   HInstruction* second = LoadLocal(instruction.VRegB(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(first, second, dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  HIf* if_instr = new (allocator_) HIf(comparison, dex_pc);
+  SetBranchCounts(if_instr);
+  AppendInstruction(if_instr);
   current_block_ = nullptr;
 }
 
@@ -617,7 +642,9 @@ void HInstructionBuilder::If_21t(const Instruction& instruction, uint32_t dex_pc
   HInstruction* value = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(value, graph_->GetIntConstant(0, dex_pc), dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  HIf* if_instr = new (allocator_) HIf(comparison, dex_pc);
+  SetBranchCounts(if_instr);
+  AppendInstruction(if_instr);
   current_block_ = nullptr;
 }
 
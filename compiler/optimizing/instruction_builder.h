@@ -39,6 +39,7 @@ class HBasicBlockBuilder;
 class Instruction;
 class InstructionOperands;
 class OptimizingCompilerStats;
+class ProfilingInfo;
 class ScopedObjectAccess;
 class SsaBuilder;
 
@@ -120,6 +121,8 @@ class HInstructionBuilder : public ValueObject {
   template<typename T>
   void Binop_22s(const Instruction& instruction, bool reverse, uint32_t dex_pc);
 
+  // Set the counts of `if_instr` from the branch profile of the method, if any.
+  void SetBranchCounts(HIf* if_instr);
   template<typename T> void If_21t(const Instruction& instruction, uint32_t dex_pc);
   template<typename T> void If_22t(const Instruction& instruction, uint32_t dex_pc);
 
@@ -324,6 +327,10 @@ class HInstructionBuilder : public ValueObject {
   // Original values kept after instruction quickening.
   QuickenInfoTable quicken_info_;
 
+  // Profile of the branches of the outermost method, recorded by its baseline compiled
+  // code. Null if there is none.
+  ProfilingInfo* profiling_info_;
+
   OptimizingCompilerStats* const compilation_stats_;
 
   ScopedArenaAllocator* const local_allocator_;
@@ -1020,6 +1020,7 @@ void InstructionSimplifierVisitor::VisitIf(HIf* instruction) {
     // Swap successors if input is negated.
     instruction->ReplaceInput(condition->InputAt(0), 0);
     instruction->GetBlock()->SwapSuccessors();
+    instruction->SetBranchCounts(instruction->GetFalseCount(), instruction->GetTrueCount());
     RecordSimplification();
   }
 }
@@ -1225,12 +1225,14 @@ void IntrinsicLocationsBuilderX86_64::VisitStringEquals(HInvoke* invoke) {
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RequiresRegister());
 
-  // Request temporary registers, RCX and RDI needed for repe_cmpsq instruction.
-  locations->AddTemp(Location::RegisterLocation(RCX));
-  locations->AddTemp(Location::RegisterLocation(RDI));
+  // Request a temporary for the remaining byte count and two XMM registers for
+  // comparing 16 bytes at a time.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
 
-  // Set output, RSI needed for repe_cmpsq instruction anyways.
-  locations->SetOut(Location::RegisterLocation(RSI), Location::kOutputOverlap);
+  // The output is used as the byte offset into both strings while they are still live.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
 }
 
 void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
@@ -1239,11 +1241,13 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
 
   CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
   CpuRegister arg = locations->InAt(1).AsRegister<CpuRegister>();
-  CpuRegister rcx = locations->GetTemp(0).AsRegister<CpuRegister>();
-  CpuRegister rdi = locations->GetTemp(1).AsRegister<CpuRegister>();
-  CpuRegister rsi = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister count = locations->GetTemp(0).AsRegister<CpuRegister>();
+  XmmRegister str_chunk = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  XmmRegister arg_chunk = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
 
-  NearLabel end, return_true, return_false;
+  NearLabel end;
+  Label return_true, return_false;
 
   // Get offsets of count, value, and class fields within a string object.
   const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
@@ -1271,10 +1275,10 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
     AssertNonMovableStringClass();
     // Also, because we use the loaded class references only to compare them, we
     // don't need to unpoison them.
-    // /* HeapReference<Class> */ rcx = str->klass_
-    __ movl(rcx, Address(str, class_offset));
-    // if (rcx != /* HeapReference<Class> */ arg->klass_) return false
-    __ cmpl(rcx, Address(arg, class_offset));
+    // /* HeapReference<Class> */ count = str->klass_
+    __ movl(count, Address(str, class_offset));
+    // if (count != /* HeapReference<Class> */ arg->klass_) return false
+    __ cmpl(count, Address(arg, class_offset));
     __ j(kNotEqual, &return_false);
   }
 
@@ -1283,56 +1287,69 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   __ j(kEqual, &return_true);
 
   // Load length and compression flag of receiver string.
-  __ movl(rcx, Address(str, count_offset));
+  __ movl(count, Address(str, count_offset));
   // Check if lengths and compressiond flags are equal, return false if they're not.
   // Two identical strings will always have same compression style since
   // compression style is decided on alloc.
-  __ cmpl(rcx, Address(arg, count_offset));
+  __ cmpl(count, Address(arg, count_offset));
   __ j(kNotEqual, &return_false);
   // Return true if both strings are empty. Even with string compression `count == 0` means empty.
   static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
                 "Expecting 0=compressed, 1=uncompressed");
-  __ jrcxz(&return_true);
+  __ testl(count, count);
+  __ j(kEqual, &return_true);
 
+  // Convert the length to the size of the string data in bytes.
   if (mirror::kUseStringCompression) {
-    NearLabel string_uncompressed;
+    NearLabel length_in_bytes;
     // Extract length and differentiate between both compressed or both uncompressed.
     // Different compression style is cut above.
-    __ shrl(rcx, Immediate(1));
-    __ j(kCarrySet, &string_uncompressed);
-    // Divide string length by 2, rounding up, and continue as if uncompressed.
-    // Merge clearing the compression flag with +1 for rounding.
-    __ addl(rcx, Immediate(1));
-    __ shrl(rcx, Immediate(1));
-    __ Bind(&string_uncompressed);
+    __ shrl(count, Immediate(1));
+    __ j(kCarryClear, &length_in_bytes);
+    __ addl(count, count);
+    __ Bind(&length_in_bytes);
+  } else {
+    __ addl(count, count);
   }
-  // Load starting addresses of string values into RSI/RDI as required for repe_cmpsq instruction.
-  __ leal(rsi, Address(str, value_offset));
-  __ leal(rdi, Address(arg, value_offset));
-
-  // Divide string length by 4 and adjust for lengths not divisible by 4.
-  __ addl(rcx, Immediate(3));
-  __ shrl(rcx, Immediate(2));
-
-  // Assertions that must hold in order to compare strings 4 characters (uncompressed)
-  // or 8 characters (compressed) at a time.
+  // Round up to a multiple of 8 bytes; the data is zero padded up to there.
   DCHECK_ALIGNED(value_offset, 8);
   static_assert(IsAligned<8>(kObjectAlignment), "String is not zero padded");
+  __ addl(count, Immediate(7));
+  __ andl(count, Immediate(-8));
+
+  // Compare 16 bytes at a time starting at the beginning of the string.
+  NearLabel loop, compare_tail;
+  __ xorl(out, out);
+  __ Bind(&loop);
+  __ cmpl(count, Immediate(16));
+  __ j(kLess, &compare_tail);
+  __ movdqu(str_chunk, Address(str, out, ScaleFactor::TIMES_1, value_offset));
+  __ movdqu(arg_chunk, Address(arg, out, ScaleFactor::TIMES_1, value_offset));
+  __ pcmpeqb(str_chunk, arg_chunk);
+  __ pmovmskb(CpuRegister(TMP), str_chunk);
+  __ cmpl(CpuRegister(TMP), Immediate(0xffff));
+  __ j(kNotEqual, &return_false);
+  __ addl(out, Immediate(16));
+  __ subl(count, Immediate(16));
+  __ jmp(&loop);
 
-  // Loop to compare strings four characters at a time starting at the beginning of the string.
-  __ repe_cmpsq();
-  // If strings are not equal, zero flag will be cleared.
+  // At most one 8-byte word is left.
+  __ Bind(&compare_tail);
+  __ testl(count, count);
+  __ j(kEqual, &return_true);
+  __ movq(CpuRegister(TMP), Address(str, out, ScaleFactor::TIMES_1, value_offset));
+  __ cmpq(CpuRegister(TMP), Address(arg, out, ScaleFactor::TIMES_1, value_offset));
   __ j(kNotEqual, &return_false);
 
   // Return true and exit the function.
   // If loop does not result in returning false, we return true.
   __ Bind(&return_true);
-  __ movl(rsi, Immediate(1));
+  __ movl(out, Immediate(1));
   __ jmp(&end);
 
   // Return false and exit the function.
   __ Bind(&return_false);
-  __ xorl(rsi, rsi);
+  __ xorl(out, out);
   __ Bind(&end);
 }
 
@@ -1342,23 +1359,88 @@ static void CreateStringIndexOfLocations(HInvoke* invoke,
   LocationSummary* locations = new (allocator) LocationSummary(invoke,
                                                                LocationSummary::kCallOnSlowPath,
                                                                kIntrinsified);
-  // The data needs to be in RDI for scasw. So request that the string is there, anyways.
-  locations->SetInAt(0, Location::RegisterLocation(RDI));
-  // If we look for a constant char, we'll still have to copy it into RAX. So just request the
-  // allocator to do that, anyways. We can still do the constant check by checking the parameter
-  // of the instruction explicitly.
-  // Note: This works as we don't clobber RAX anywhere.
-  locations->SetInAt(1, Location::RegisterLocation(RAX));
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
   if (!start_at_zero) {
     locations->SetInAt(2, Location::RequiresRegister());          // The starting index.
   }
-  // As we clobber RDI during execution anyways, also use it as the output.
+  // As we advance the string pointer during the scan anyways, also use it as the output.
   locations->SetOut(Location::SameAsFirstInput());
 
-  // repne scasw uses RCX as the counter.
-  locations->AddTemp(Location::RegisterLocation(RCX));
+  // The number of chars left to scan.
+  locations->AddTemp(Location::RequiresRegister());
   // Need another temporary to be able to compute the result.
   locations->AddTemp(Location::RequiresRegister());
+  // The broadcast search value and the chunk of string data being compared.
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+// Scans `counter` chars starting at `data` for `search_value`, 16 bytes at a time with SSE2
+// and one char at a time for the remainder. On a match, falls through with `counter` holding
+// the number of chars left from the matching one (inclusive); otherwise jumps to `not_found`.
+static void GenerateStringIndexOfLoop(X86_64Assembler* assembler,
+                                      CpuRegister data,
+                                      CpuRegister counter,
+                                      CpuRegister search_value,
+                                      XmmRegister key,
+                                      XmmRegister chunk,
+                                      bool is_compressed,
+                                      Label* not_found) {
+  CpuRegister mask(TMP);
+  const int32_t char_size = is_compressed ? 1 : 2;
+  const int32_t chars_per_chunk = 16 / char_size;
+
+  // Broadcast the search value to all lanes of `key`.
+  __ movd(key, search_value, /* is64bit= */ false);
+  if (is_compressed) {
+    __ punpcklbw(key, key);
+  }
+  __ punpcklwd(key, key);
+  __ pshufd(key, key, Immediate(0));
+
+  NearLabel chunk_loop, found_in_chunk, char_loop, found;
+  __ Bind(&chunk_loop);
+  __ cmpl(counter, Immediate(chars_per_chunk));
+  __ j(kLess, &char_loop);
+  __ movdqu(chunk, Address(data, 0));
+  if (is_compressed) {
+    __ pcmpeqb(chunk, key);
+  } else {
+    __ pcmpeqw(chunk, key);
+  }
+  __ pmovmskb(mask, chunk);
+  __ testl(mask, mask);
+  __ j(kNotZero, &found_in_chunk);
+  __ addq(data, Immediate(16));
+  __ subl(counter, Immediate(chars_per_chunk));
+  __ jmp(&chunk_loop);
+
+  // The lowest set bit of the mask is the byte offset of the first matching char.
+  __ Bind(&found_in_chunk);
+  __ bsfl(mask, mask);
+  if (!is_compressed) {
+    __ shrl(mask, Immediate(1));
+  }
+  __ subl(counter, mask);
+  __ jmp(&found);
+
+  // Compare the remaining chars one at a time.
+  __ Bind(&char_loop);
+  __ testl(counter, counter);
+  __ j(kEqual, not_found);
+  if (is_compressed) {
+    __ movzxb(mask, Address(data, 0));
+  } else {
+    __ movzxw(mask, Address(data, 0));
+  }
+  __ cmpl(mask, search_value);
+  __ j(kEqual, &found);
+  __ addq(data, Immediate(char_size));
+  __ subl(counter, Immediate(1));
+  __ jmp(&char_loop);
+
+  __ Bind(&found);
 }
 
 static void GenerateStringIndexOf(HInvoke* invoke,
@@ -1374,13 +1456,10 @@ static void GenerateStringIndexOf(HInvoke* invoke,
   CpuRegister search_value = locations->InAt(1).AsRegister<CpuRegister>();
   CpuRegister counter = locations->GetTemp(0).AsRegister<CpuRegister>();
   CpuRegister string_length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  XmmRegister key = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+  XmmRegister chunk = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
   CpuRegister out = locations->Out().AsRegister<CpuRegister>();
-
-  // Check our assumptions for registers.
-  DCHECK_EQ(string_obj.AsRegister(), RDI);
-  DCHECK_EQ(search_value.AsRegister(), RAX);
-  DCHECK_EQ(counter.AsRegister(), RCX);
-  DCHECK_EQ(out.AsRegister(), RDI);
+  DCHECK_EQ(out.AsRegister(), string_obj.AsRegister());
 
   // Check for code points > 0xFFFF. Either a slow-path check when we don't know statically,
   // or directly dispatch for a large constant, or omit slow-path for a small constant or a char.
@@ -1415,8 +1494,7 @@ static void GenerateStringIndexOf(HInvoke* invoke,
   __ movl(string_length, Address(string_obj, count_offset));
 
   // Do a zero-length check. Even with string compression `count == 0` means empty.
-  // TODO: Support jecxz.
-  NearLabel not_found_label;
+  Label not_found_label;
   __ testl(string_length, string_length);
   __ j(kEqual, &not_found_label);
 
@@ -1457,37 +1535,38 @@ static void GenerateStringIndexOf(HInvoke* invoke,
     } else {
       __ leaq(string_obj, Address(string_obj, counter, ScaleFactor::TIMES_2, value_offset));
     }
-    // Now update ecx, the work counter: it's gonna be string.length - start_index.
+    // Now update the work counter: it's gonna be string.length - start_index.
     __ negq(counter);  // Needs to be 64-bit negation, as the address computation is 64-bit.
     __ leaq(counter, Address(string_length, counter, ScaleFactor::TIMES_1, 0));
   }
 
   if (mirror::kUseStringCompression) {
-    NearLabel uncompressed_string_comparison;
-    NearLabel comparison_done;
+    Label uncompressed_string_comparison;
+    Label comparison_done;
     __ testl(CpuRegister(TMP), Immediate(1));
     __ j(kNotZero, &uncompressed_string_comparison);
-    // Check if RAX (search_value) is ASCII.
+    // Check if search_value is ASCII.
     __ cmpl(search_value, Immediate(127));
     __ j(kGreater, &not_found_label);
     // Comparing byte-per-byte.
-    __ repne_scasb();
+    GenerateStringIndexOfLoop(
+        assembler, string_obj, counter, search_value, key, chunk, /* is_compressed= */ true,
+        &not_found_label);
     __ jmp(&comparison_done);
-    // Everything is set up for repne scasw:
-    //   * Comparison address in RDI.
-    //   * Counter in ECX.
     __ Bind(&uncompressed_string_comparison);
-    __ repne_scasw();
+    GenerateStringIndexOfLoop(
+        assembler, string_obj, counter, search_value, key, chunk, /* is_compressed= */ false,
+        &not_found_label);
     __ Bind(&comparison_done);
   } else {
-    __ repne_scasw();
+    GenerateStringIndexOfLoop(
+        assembler, string_obj, counter, search_value, key, chunk, /* is_compressed= */ false,
+        &not_found_label);
   }
-  // Did we find a match?
-  __ j(kNotEqual, &not_found_label);
 
-  // Yes, we matched.  Compute the index of the result.
+  // We matched. Compute the index of the result.
   __ subl(string_length, counter);
-  __ leal(out, Address(string_length, -1));
+  __ movl(out, string_length);
 
   NearLabel done;
   __ jmp(&done);
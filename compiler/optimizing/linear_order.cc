@@ -54,6 +54,59 @@ static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
   worklist->insert(insert_pos.base(), block);
 }
 
+// Minimum number of executions of a profiled branch for its counts to be used.
+static constexpr uint32_t kMinimumBranchCountForLayout = 100;
+
+// A profiled successor taken less than once every this number of executions of the
+// branch is considered cold.
+static constexpr uint32_t kColdBranchRatio = 128;
+
+// Returns whether the branch profile says that the edge from `block` to `successor`
+// is (almost) never taken.
+static bool IsColdEdge(HBasicBlock* block, HBasicBlock* successor) {
+  HInstruction* last = block->GetLastInstruction();
+  if (!last->IsIf()) {
+    return false;
+  }
+  HIf* if_instr = last->AsIf();
+  uint32_t true_count = if_instr->GetTrueCount();
+  uint32_t false_count = if_instr->GetFalseCount();
+  uint32_t total = true_count + false_count;
+  if (total < kMinimumBranchCountForLayout) {
+    return false;
+  }
+  uint32_t count = (successor == if_instr->IfTrueSuccessor()) ? true_count : false_count;
+  return count * kColdBranchRatio < total;
+}
+
+// Returns whether `block` leaves the method by throwing.
+static bool IsThrowingBlock(HBasicBlock* block) {
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    if (it.Current()->IsThrow() || it.Current()->AlwaysThrows()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns whether the successors of an HIf should be visited in reverse order, so
+// that the true successor, which is hotter, is laid out right after the branch.
+static bool PreferTrueSuccessor(HBasicBlock* block, const ScopedArenaVector<bool>& is_cold) {
+  HInstruction* last = block->GetLastInstruction();
+  if (!last->IsIf()) {
+    return false;
+  }
+  HIf* if_instr = last->AsIf();
+  bool true_cold = is_cold[if_instr->IfTrueSuccessor()->GetBlockId()];
+  bool false_cold = is_cold[if_instr->IfFalseSuccessor()->GetBlockId()];
+  if (true_cold != false_cold) {
+    return false_cold;
+  }
+  uint32_t total = if_instr->GetTrueCount() + if_instr->GetFalseCount();
+  return total >= kMinimumBranchCountForLayout &&
+         if_instr->GetTrueCount() > if_instr->GetFalseCount();
+}
+
 // Helper method to validate linear order.
 static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
   for (HBasicBlock* header : graph->GetBlocks()) {
@@ -87,7 +140,8 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Cold blocks outside loops are at the end.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -104,27 +158,90 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
     }
     forward_predecessors[block->GetBlockId()] = number_of_forward_predecessors;
   }
-  // (2): Following a worklist approach, first start with the entry block, and
+  // (2): Find the cold blocks: blocks that throw, and blocks only reached through
+  //      cold blocks or through edges that the branch profile says are (almost)
+  //      never taken. Cold blocks outside loops that only lead to other such blocks,
+  //      or to the exit, are deferred to the end of the method.
+  ScopedArenaVector<bool> is_cold(graph->GetBlocks().size(),
+                                  false,
+                                  allocator.Adapter(kArenaAllocLinearOrder));
+  ScopedArenaVector<bool> is_deferred(graph->GetBlocks().size(),
+                                      false,
+                                      allocator.Adapter(kArenaAllocLinearOrder));
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    if (block->IsEntryBlock() || block->IsExitBlock()) {
+      continue;
+    }
+    bool cold = block->IsCatchBlock() || IsThrowingBlock(block);
+    if (!cold) {
+      cold = true;
+      for (HBasicBlock* predecessor : block->GetPredecessors()) {
+        if (block->IsLoopHeader() && block->GetLoopInformation()->IsBackEdge(*predecessor)) {
+          continue;
+        }
+        if (!is_cold[predecessor->GetBlockId()] && !IsColdEdge(predecessor, block)) {
+          cold = false;
+          break;
+        }
+      }
+    }
+    is_cold[block->GetBlockId()] = cold;
+  }
+  for (HBasicBlock* block : ReverseRange(graph->GetReversePostOrder())) {
+    if (!is_cold[block->GetBlockId()] || block->GetLoopInformation() != nullptr) {
+      continue;
+    }
+    bool deferred = true;
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (!successor->IsExitBlock() && !is_deferred[successor->GetBlockId()]) {
+        deferred = false;
+        break;
+      }
+    }
+    is_deferred[block->GetBlockId()] = deferred;
+  }
+
+  // (3): Following a worklist approach, first start with the entry block, and
   //      iterate over the successors. When all non-back edge predecessors of a
   //      successor block are visited, the successor block is added in the worklist
   //      following an order that satisfies the requirements to build our linear graph.
+  //      The hot successor of a branch is added last, so that it is laid out next.
+  //      Deferred blocks are only added once all other blocks are laid out.
   ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocLinearOrder));
+  ScopedArenaVector<HBasicBlock*> deferred_worklist(allocator.Adapter(kArenaAllocLinearOrder));
   worklist.push_back(graph->GetEntryBlock());
   size_t num_added = 0u;
+  auto visit_successor = [&](HBasicBlock* successor) {
+    int block_id = successor->GetBlockId();
+    size_t number_of_remaining_predecessors = forward_predecessors[block_id];
+    if (number_of_remaining_predecessors == 1) {
+      if (is_deferred[block_id]) {
+        deferred_worklist.push_back(successor);
+      } else {
+        AddToListForLinearization(&worklist, successor);
+      }
+    }
+    forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
+  };
   do {
+    if (worklist.empty()) {
+      worklist.push_back(deferred_worklist.back());
+      deferred_worklist.pop_back();
+    }
     HBasicBlock* current = worklist.back();
     worklist.pop_back();
     linear_order[num_added] = current;
     ++num_added;
-    for (HBasicBlock* successor : current->GetSuccessors()) {
-      int block_id = successor->GetBlockId();
-      size_t number_of_remaining_predecessors = forward_predecessors[block_id];
-      if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+    if (PreferTrueSuccessor(current, is_cold)) {
+      for (HBasicBlock* successor : ReverseRange(current->GetSuccessors())) {
+        visit_successor(successor);
+      }
+    } else {
+      for (HBasicBlock* successor : current->GetSuccessors()) {
+        visit_successor(successor);
       }
-      forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
-  } while (!worklist.empty());
+  } while (!worklist.empty() || !deferred_worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
 
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
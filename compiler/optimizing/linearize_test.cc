@@ -23,6 +23,7 @@
 #include "dex/dex_instruction.h"
 #include "driver/compiler_options.h"
 #include "graph_visualizer.h"
+#include "linear_order.h"
 #include "nodes.h"
 #include "optimizing_unit_test.h"
 #include "pretty_printer.h"
@@ -35,8 +36,26 @@ class LinearizeTest : public OptimizingUnitTest {
   template <size_t number_of_blocks>
   void TestCode(const std::vector<uint16_t>& data,
                 const uint32_t (&expected_order)[number_of_blocks]);
+
+  // Linearizes `graph` and checks that the linear order is `expected_order`.
+  template <size_t number_of_blocks>
+  void TestOrder(HGraph* graph, HBasicBlock* const (&expected_order)[number_of_blocks]);
 };
 
+template <size_t number_of_blocks>
+void LinearizeTest::TestOrder(HGraph* graph,
+                              HBasicBlock* const (&expected_order)[number_of_blocks]) {
+  graph->BuildDominatorTree();
+  ScopedArenaVector<HBasicBlock*> linear_order(
+      GetScopedAllocator()->Adapter(kArenaAllocLinearOrder));
+  LinearizeGraph(graph, &linear_order);
+
+  ASSERT_EQ(linear_order.size(), number_of_blocks);
+  for (size_t i = 0; i < number_of_blocks; ++i) {
+    ASSERT_EQ(linear_order[i], expected_order[i]);
+  }
+}
+
 template <size_t number_of_blocks>
 void LinearizeTest::TestCode(const std::vector<uint16_t>& data,
                              const uint32_t (&expected_order)[number_of_blocks]) {
@@ -242,4 +261,89 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ThrowingBlockIsLast) {
+  // Structure of this graph:
+  //            entry
+  //              |
+  //            branch
+  //           /      \
+  //     returning  throwing
+  //           \      /
+  //             exit
+  //
+  // The throwing block is the false successor, which would otherwise be laid out
+  // right after the branch.
+  HGraph* graph = CreateGraph();
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* branch = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* returning = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* throwing = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* exit = new (GetAllocator()) HBasicBlock(graph);
+  for (HBasicBlock* block : {entry, branch, returning, throwing, exit}) {
+    graph->AddBlock(block);
+  }
+  graph->SetEntryBlock(entry);
+  graph->SetExitBlock(exit);
+  entry->AddSuccessor(branch);
+  branch->AddSuccessor(returning);
+  branch->AddSuccessor(throwing);
+  returning->AddSuccessor(exit);
+  throwing->AddSuccessor(exit);
+
+  entry->AddInstruction(new (GetAllocator()) HGoto());
+  branch->AddInstruction(new (GetAllocator()) HIf(graph->GetIntConstant(1)));
+  returning->AddInstruction(new (GetAllocator()) HReturnVoid());
+  throwing->AddInstruction(new (GetAllocator()) HThrow(graph->GetNullConstant(), 0u));
+  exit->AddInstruction(new (GetAllocator()) HExit());
+
+  HBasicBlock* const blocks[] = {entry, branch, returning, throwing, exit};
+  TestOrder(graph, blocks);
+}
+
+TEST_F(LinearizeTest, ProfiledBranch) {
+  // Structure of this graph:
+  //            entry
+  //              |
+  //            branch
+  //           /      \
+  //         hot      cold
+  //           \      /
+  //            merge
+  //              |
+  //             exit
+  //
+  // The profile says the true successor is taken, so it is laid out right after
+  // the branch.
+  HGraph* graph = CreateGraph();
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* branch = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* hot = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* cold = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* merge = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* exit = new (GetAllocator()) HBasicBlock(graph);
+  for (HBasicBlock* block : {entry, branch, hot, cold, merge, exit}) {
+    graph->AddBlock(block);
+  }
+  graph->SetEntryBlock(entry);
+  graph->SetExitBlock(exit);
+  entry->AddSuccessor(branch);
+  branch->AddSuccessor(hot);
+  branch->AddSuccessor(cold);
+  hot->AddSuccessor(merge);
+  cold->AddSuccessor(merge);
+  merge->AddSuccessor(exit);
+
+  entry->AddInstruction(new (GetAllocator()) HGoto());
+  HIf* if_instr = new (GetAllocator()) HIf(graph->GetIntConstant(1));
+  if_instr->SetBranchCounts(/* true_count= */ 1000u, /* false_count= */ 0u);
+  branch->AddInstruction(if_instr);
+  hot->AddInstruction(new (GetAllocator()) HGoto());
+  cold->AddInstruction(new (GetAllocator()) HGoto());
+  merge->AddInstruction(new (GetAllocator()) HReturnVoid());
+  exit->AddInstruction(new (GetAllocator()) HExit());
+
+  HBasicBlock* const blocks[] = {entry, branch, hot, cold, merge, exit};
+  TestOrder(graph, blocks);
+}
+
 }  // namespace art
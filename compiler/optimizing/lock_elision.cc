@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lock_elision.h"
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "escape.h"
+#include "optimizing_compiler_stats.h"
+
+namespace art {
+
+// Maximum number of instructions between two monitor regions merged by lock
+// coarsening, to keep the lock hold time short.
+static constexpr size_t kMaxInstructionsBetweenRegions = 16;
+
+bool LockElision::TryElideLocks(HInstruction* object) {
+  bool is_singleton = false;
+  bool is_singleton_and_not_returned = false;
+  bool is_singleton_and_not_deopt_visible = false;
+  CalculateEscape(object,
+                  /* no_escape= */ nullptr,
+                  &is_singleton,
+                  &is_singleton_and_not_returned,
+                  &is_singleton_and_not_deopt_visible);
+  // The object must not be visible to other threads, even after the method returns,
+  // and the interpreter must not unlock it after a deoptimization.
+  if (!is_singleton_and_not_returned || !is_singleton_and_not_deopt_visible) {
+    return false;
+  }
+  const HUseList<HInstruction*>& uses = object->GetUses();
+  for (auto it = uses.begin(), end = uses.end(); it != end; /* ++it below */) {
+    HInstruction* user = it->GetUser();
+    ++it;  // Increment before removing the use.
+    if (user->IsMonitorOperation()) {
+      user->GetBlock()->RemoveInstruction(user);
+      MaybeRecordStat(stats_, MethodCompilationStat::kMonitorOperationElided);
+    }
+  }
+  return true;
+}
+
+bool LockElision::TryCoarsenLocks(HMonitorOperation* monitor_exit) {
+  DCHECK(!monitor_exit->IsEnter());
+  HInstruction* object = monitor_exit->InputAt(0);
+  HBasicBlock* block = monitor_exit->GetBlock();
+  HInstruction* instruction = monitor_exit->GetNext();
+  for (size_t count = 0; count != kMaxInstructionsBetweenRegions; ++count) {
+    if (instruction->IsMonitorOperation()) {
+      HMonitorOperation* monitor_enter = instruction->AsMonitorOperation();
+      if (!monitor_enter->IsEnter() || monitor_enter->InputAt(0) != object) {
+        return false;
+      }
+      // Nothing between the two regions can throw or deoptimize, so the exception
+      // handlers of both regions and the interpreter still see the lock held once.
+      monitor_exit->GetBlock()->RemoveInstruction(monitor_exit);
+      monitor_enter->GetBlock()->RemoveInstruction(monitor_enter);
+      MaybeRecordStat(stats_, MethodCompilationStat::kMonitorOperationCoarsened);
+      return true;
+    } else if (instruction->IsGoto() || instruction->IsTryBoundary()) {
+      // Follow straight-line control flow, also out of a try block: the instructions up
+      // to the monitor-enter do not throw, so they need no exception handler.
+      HBasicBlock* successor = instruction->IsGoto()
+          ? block->GetSingleSuccessor()
+          : instruction->AsTryBoundary()->GetNormalFlowSuccessor();
+      if (successor->GetPredecessors().size() != 1u) {
+        return false;
+      }
+      block = successor;
+      instruction = block->GetFirstInstruction();
+    } else if (instruction->IsControlFlow() ||
+               instruction->CanThrow() ||
+               instruction->NeedsEnvironment()) {
+      return false;
+    } else {
+      instruction = instruction->GetNext();
+    }
+  }
+  return false;
+}
+
+bool LockElision::Run() {
+  if (!graph_->HasMonitorOperations() || graph_->IsDebuggable()) {
+    // Debuggers can inspect the locks held by a frame.
+    return false;
+  }
+  // Elided locks are still reported when walking the stack, by reading the locked
+  // object from the dex register maps, which dead reference safe methods may not keep
+  // alive. When compiling for OSR, the interpreter may already hold the lock. A CHA
+  // deoptimization would make the interpreter unlock objects that were never locked.
+  const bool can_elide = !graph_->IsDeadReferenceSafe() &&
+                         !graph_->IsCompilingOsr() &&
+                         !graph_->HasShouldDeoptimizeFlag();
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HMonitorOperation*> monitors(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsMonitorOperation()) {
+        monitors.push_back(it.Current()->AsMonitorOperation());
+      }
+    }
+  }
+
+  bool changed = false;
+  for (HMonitorOperation* monitor : monitors) {
+    if (monitor->GetBlock() == nullptr) {
+      // Already removed, with the other monitor operations on the same object.
+      continue;
+    }
+    if (can_elide && TryElideLocks(monitor->InputAt(0))) {
+      changed = true;
+    } else if (!monitor->IsEnter() && TryCoarsenLocks(monitor)) {
+      changed = true;
+    }
+  }
+  // Note that the graph keeps `HasMonitorOperations()`, so that the stack maps keep
+  // the dex registers holding the objects that the interpreter considers locked.
+  return changed;
+}
+
+}  // namespace art
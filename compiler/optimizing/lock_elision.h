@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_LOCK_ELISION_H_
+#define ART_COMPILER_OPTIMIZING_LOCK_ELISION_H_
+
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass to remove monitor operations that are not needed:
+ * - lock elision removes all monitor operations on objects that do not escape
+ *   the method, as no other thread can lock them,
+ * - lock coarsening merges a monitor region with the next one on the same object,
+ *   when only non-throwing instructions without environment separate them.
+ *
+ * The dex register maps of the stack maps are kept, so that the runtime still finds
+ * the locks the interpreter expects to be held, when walking the stack.
+ */
+class LockElision : public HOptimization {
+ public:
+  LockElision(HGraph* graph,
+              OptimizingCompilerStats* stats,
+              const char* name = kLockElisionPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kLockElisionPassName = "lock_elision";
+
+ private:
+  // Remove the monitor operations on `object` if it does not escape. Returns whether
+  // they were removed.
+  bool TryElideLocks(HInstruction* object);
+
+  // Remove `monitor_exit` and the monitor-enter on the same object that follows it,
+  // if any. Returns whether they were removed.
+  bool TryCoarsenLocks(HMonitorOperation* monitor_exit);
+
+  DISALLOW_COPY_AND_ASSIGN(LockElision);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_LOCK_ELISION_H_
@@ -86,6 +86,10 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
   static constexpr uint32_t kScalarHeuristicMaxBodySizeBlocks = 6;
   // Maximum number of instructions to be created as a result of full unrolling.
   static constexpr uint32_t kScalarHeuristicFullyUnrolledMaxInstrThreshold = 35;
+  // Loop's maximum instruction count. Loops with higher count will not be unswitched.
+  static constexpr uint32_t kScalarHeuristicMaxUnswitchingBodySizeInstr = 40;
+  // Loop's maximum basic block count. Loops with higher count will not be unswitched.
+  static constexpr uint32_t kScalarHeuristicMaxUnswitchingBodySizeBlocks = 10;
 
   bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* analysis_info) const override {
     return analysis_info->HasLongTypeInstructions() ||
@@ -118,6 +122,13 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
     return (trip_count * instr_num < kScalarHeuristicFullyUnrolledMaxInstrThreshold);
   }
 
+  bool IsLoopUnswitchingBeneficial(LoopAnalysisInfo* analysis_info) const override {
+    return !analysis_info->HasInstructionsPreventingScalarOpts() &&
+           !IsLoopTooBig(analysis_info,
+                         kScalarHeuristicMaxUnswitchingBodySizeInstr,
+                         kScalarHeuristicMaxUnswitchingBodySizeBlocks);
+  }
+
  protected:
   bool IsLoopTooBig(LoopAnalysisInfo* loop_analysis_info,
                     size_t instr_threshold,
@@ -167,6 +167,15 @@ class ArchNoOptsLoopHelper : public ArenaObject<kArenaAllocOptimization> {
     return false;
   }
 
+  // Returns whether it is beneficial to unswitch the loop: to duplicate the loop to move a branch
+  // on a loop-invariant condition out of it.
+  //
+  // Returns 'false' by default, should be overridden by particular target loop helper.
+  virtual bool IsLoopUnswitchingBeneficial(
+      LoopAnalysisInfo* analysis_info ATTRIBUTE_UNUSED) const {
+    return false;
+  }
+
   // Returns optimal SIMD unrolling factor for the loop.
   //
   // Returns kNoUnrollingFactor by default, should be overridden by particular target loop helper.
@@ -32,6 +32,9 @@ namespace art {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Maximum number of loop instructions that loop unswitching may duplicate in a method.
+static constexpr uint32_t kMaxUnswitchedInstructions = 120;
+
 //
 // Static helpers.
 //
@@ -338,8 +341,10 @@ static bool IsSubConst2(HGraph* graph,
 // Detect reductions of the following forms,
 //   x = x_phi + ..
 //   x = x_phi - ..
+//   x = min(x_phi, ..)
+//   x = max(x_phi, ..)
 static bool HasReductionFormat(HInstruction* reduction, HInstruction* phi) {
-  if (reduction->IsAdd()) {
+  if (reduction->IsAdd() || reduction->IsMin() || reduction->IsMax()) {
     return (reduction->InputAt(0) == phi && reduction->InputAt(1) != phi) ||
            (reduction->InputAt(0) != phi && reduction->InputAt(1) == phi);
   } else if (reduction->IsSub()) {
@@ -355,6 +360,10 @@ static HVecReduce::ReductionKind GetReductionKind(HVecOperation* reduction) {
       reduction->IsVecSADAccumulate() ||
       reduction->IsVecDotProd()) {
     return HVecReduce::kSum;
+  } else if (reduction->IsVecMin()) {
+    return HVecReduce::kMin;
+  } else if (reduction->IsVecMax()) {
+    return HVecReduce::kMax;
   }
   LOG(FATAL) << "Unsupported SIMD reduction " << reduction->GetId();
   UNREACHABLE();
@@ -424,6 +433,55 @@ static void TryToEvaluateIfCondition(HIf* instruction, HGraph* graph) {
   }
 }
 
+// Returns a branch in the loop body on a loop-invariant condition whose successors are single
+// blocks that meet again in the loop body (if-then-else; an if-then has its critical edge
+// split), or nullptr if there is no such branch.
+static HIf* FindUnswitchingCandidate(HLoopInformation* loop_info) {
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HIf* hif = it.Current()->GetLastInstruction()->AsIf();
+    if (hif == nullptr) {
+      continue;
+    }
+    HInstruction* condition = hif->InputAt(0);
+    if (condition->IsConstant() || loop_info->Contains(*condition->GetBlock())) {
+      continue;
+    }
+    HBasicBlock* true_succ = hif->IfTrueSuccessor();
+    HBasicBlock* false_succ = hif->IfFalseSuccessor();
+    if (!loop_info->Contains(*true_succ) ||
+        !loop_info->Contains(*false_succ) ||
+        true_succ->GetPredecessors().size() != 1u ||
+        false_succ->GetPredecessors().size() != 1u ||
+        true_succ->GetSuccessors().size() != 1u ||
+        false_succ->GetSuccessors().size() != 1u) {
+      continue;
+    }
+    HBasicBlock* meet = true_succ->GetSingleSuccessor();
+    if (meet != false_succ->GetSingleSuccessor() ||
+        meet == loop_info->GetHeader() ||
+        meet->GetPredecessors().size() != 2u) {
+      continue;
+    }
+    return hif;
+  }
+  return nullptr;
+}
+
+// Removes the successor of the unswitched branch 'hif' which is not taken when its condition
+// is 'value'; the branch is replaced by a goto.
+static void RemoveUnswitchedBranch(HIf* hif, bool value) {
+  HBasicBlock* block = hif->GetBlock();
+  HBasicBlock* taken = value ? hif->IfTrueSuccessor() : hif->IfFalseSuccessor();
+  HBasicBlock* not_taken = value ? hif->IfFalseSuccessor() : hif->IfTrueSuccessor();
+  HBasicBlock* meet = not_taken->GetSingleSuccessor();
+  not_taken->DisconnectAndDelete();
+  DCHECK(block->GetLastInstruction()->IsGoto());
+  DCHECK_EQ(meet->GetSinglePredecessor(), taken);
+  block->RemoveDominatedBlock(meet);
+  taken->AddDominatedBlock(meet);
+  meet->SetDominator(taken);
+}
+
 // Peel the first 'count' iterations of the loop.
 static void PeelByCount(HLoopInformation* loop_info,
                         int count,
@@ -485,6 +543,7 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_header_(nullptr),
       vector_body_(nullptr),
       vector_index_(nullptr),
+      unswitched_instructions_(0),
       arch_loop_helper_(ArchNoOptsLoopHelper::Create(compiler_options_ != nullptr
                                                           ? compiler_options_->GetInstructionSet()
                                                           : InstructionSet::kNone,
@@ -780,7 +839,9 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
 }
 
 bool HLoopOptimization::OptimizeInnerLoop(LoopNode* node) {
-  return TryOptimizeInnerLoopFinite(node) || TryPeelingAndUnrolling(node);
+  return TryOptimizeInnerLoopFinite(node) ||
+         TryLoopUnswitching(node) ||
+         TryPeelingAndUnrolling(node);
 }
 
 
@@ -913,6 +974,69 @@ bool HLoopOptimization::TryPeelingAndUnrolling(LoopNode* node) {
          TryUnrollingForBranchPenaltyReduction(&analysis_info);
 }
 
+//
+// Loop unswitching.
+//
+
+bool HLoopOptimization::TryLoopUnswitching(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  HIf* hif = FindUnswitchingCandidate(loop_info);
+  if (hif == nullptr) {
+    return false;
+  }
+
+  int64_t trip_count = LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_);
+  LoopAnalysisInfo analysis_info(loop_info);
+  LoopAnalysis::CalculateLoopBasicProperties(loop_info, &analysis_info, trip_count);
+  if (!arch_loop_helper_->IsLoopUnswitchingBeneficial(&analysis_info) ||
+      unswitched_instructions_ + analysis_info.GetNumberOfInstructions() >
+          kMaxUnswitchedInstructions) {
+    return false;
+  }
+
+  // Run 'IsLoopClonable' the last as it might be time-consuming.
+  if (!PeelUnrollHelper::IsLoopClonable(loop_info)) {
+    return false;
+  }
+
+  // Version the loop on the branch condition: the original loop is entered when the condition
+  // is true and the copy otherwise, so the branch can be removed from both of them.
+  //
+  //                                         if (cond)
+  //     loop {                               loop {  ..  A  ..  }
+  //       if (cond) A else B     =====>    else
+  //     }                                    loop {  ..  B  ..  }
+  //
+  unswitched_instructions_ += analysis_info.GetNumberOfInstructions();
+  PeelUnrollSimpleHelper helper(loop_info, &induction_range_);
+  HBasicBlock* copy_header = helper.DoVersioning(hif->InputAt(0));
+  HIf* copy_hif = helper.GetInstructionMap()->Get(hif)->AsIf();
+  RemoveUnswitchedBranch(hif, /* value= */ true);
+  RemoveUnswitchedBranch(copy_hif, /* value= */ false);
+  MaybeRecordStat(stats_, MethodCompilationStat::kLoopUnswitched);
+
+  // Add the copy to the loop hierarchy; it is visited right after 'node'.
+  LoopNode* copy_node = new (loop_allocator_) LoopNode(copy_header->GetLoopInformation());
+  copy_node->outer = node->outer;
+  copy_node->previous = node;
+  copy_node->next = node->next;
+  if (node->next != nullptr) {
+    node->next->previous = copy_node;
+  }
+  node->next = copy_node;
+
+  induction_range_.ReVisit(loop_info);
+  induction_range_.ReVisit(copy_node->loop_info);
+
+  // The original loop is now free of the branch; simplify it and optimize it further.
+  do {
+    simplified_ = false;
+    SimplifyBlocks(node);
+  } while (simplified_);
+  OptimizeInnerLoop(node);
+  return true;
+}
+
 //
 // Loop vectorization. The implementation is based on the book by Aart J.C. Bik:
 // "The Software Vectorization Handbook. Applying Multimedia Extensions for Maximum Performance."
@@ -1533,6 +1657,36 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
       }
       return true;
     }
+  } else if (instruction->IsMin() || instruction->IsMax()) {
+    // Deal with vector restrictions.
+    HInstruction* opa = instruction->InputAt(0);
+    HInstruction* opb = instruction->InputAt(1);
+    HInstruction* r = opa;
+    HInstruction* s = opb;
+    bool is_unsigned = false;
+    if (HasVectorRestrictions(restrictions, kNoMinMax)) {
+      return false;
+    } else if (HasVectorRestrictions(restrictions, kNoHiBits) &&
+               !IsNarrowerOperands(opa, opb, type, &r, &s, &is_unsigned)) {
+      return false;  // reject, unless all operands are same-extension narrower
+    }
+    // Accept MIN/MAX(x, y) for vectorizable operands. This includes the if-converted
+    // forms "x < y ? x : y" which the instruction simplifier turns into MIN/MAX.
+    DCHECK(r != nullptr && s != nullptr);
+    if (generate_code && vector_mode_ != kVector) {  // de-idiom
+      r = opa;
+      s = opb;
+    }
+    if (VectorizeUse(node, r, generate_code, type, restrictions) &&
+        VectorizeUse(node, s, generate_code, type, restrictions)) {
+      if (generate_code) {
+        GenerateVecOp(instruction,
+                      vector_map_->Get(r),
+                      vector_map_->Get(s),
+                      HVecOperation::ToProperType(type, is_unsigned));
+      }
+      return true;
+    }
   }
   return false;
 }
@@ -1541,9 +1695,13 @@ uint32_t HLoopOptimization::GetVectorSizeInBytes() {
   if (kIsDebugBuild) {
     InstructionSet isa = compiler_options_->GetInstructionSet();
     // TODO: Remove this check when there are no implicit assumptions on the SIMD reg size.
-    DCHECK_EQ(simd_register_size_, (isa == InstructionSet::kArm || isa == InstructionSet::kThumb2)
-                                   ? 8u
-                                   : 16u);
+    if (isa == InstructionSet::kArm || isa == InstructionSet::kThumb2) {
+      DCHECK_EQ(simd_register_size_, 8u);
+    } else if (isa == InstructionSet::kX86_64) {
+      DCHECK(simd_register_size_ == 16u || simd_register_size_ == 32u);  // SSE or AVX2.
+    } else {
+      DCHECK_EQ(simd_register_size_, 16u);
+    }
   }
 
   return simd_register_size_;
@@ -1590,7 +1748,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
           *restrictions |= kNoDiv;
           return TrySetVectorLength(type, 4);
         case DataType::Type::kInt64:
-          *restrictions |= kNoDiv | kNoMul;
+          *restrictions |= kNoDiv | kNoMul | kNoMinMax;
           return TrySetVectorLength(type, 2);
         case DataType::Type::kFloat32:
           *restrictions |= kNoReduction;
@@ -1603,8 +1761,13 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       }
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
-      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
+      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD, or 256-bit
+      // SIMD on x86-64 devices with AVX2, in which case the code generator reports 32 bytes).
       if (features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+        // The compressed String.charAt() load only has a 128-bit expansion.
+        if (simd_register_size_ > 16u) {
+          *restrictions |= kNoStringCharAt;
+        }
         switch (type) {
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
@@ -1617,7 +1780,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 16);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kUint16:
             *restrictions |= kNoDiv |
                              kNoAbs |
@@ -1625,26 +1788,27 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kInt16:
             *restrictions |= kNoDiv |
                              kNoAbs |
                              kNoSignedHAdd |
                              kNoUnroundedHAdd |
                              kNoSAD;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kInt32:
             *restrictions |= kNoDiv | kNoSAD;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kInt64:
-            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
-            return TrySetVectorLength(type, 2);
+            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD | kNoMinMax;
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
+          // MINPS/MAXPS do not implement the Java semantics for NaN and -0.0.
           case DataType::Type::kFloat32:
-            *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 4);
+            *restrictions |= kNoReduction | kNoMinMax;
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           case DataType::Type::kFloat64:
-            *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 2);
+            *restrictions |= kNoReduction | kNoMinMax;
+            return TrySetVectorLength(type, simd_register_size_ / DataType::Size(type));
           default:
             break;
         }  // switch type
@@ -1938,6 +2102,14 @@ void HLoopOptimization::GenerateVecOp(HInstruction* org,
       GENERATE_VEC(
         new (global_allocator_) HVecAbs(global_allocator_, opa, type, vector_length_, dex_pc),
         new (global_allocator_) HAbs(org_type, opa, dex_pc));
+    case HInstruction::kMin:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMin(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMin(org_type, opa, opb, dex_pc));
+    case HInstruction::kMax:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMax(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMax(org_type, opa, opb, dex_pc));
     default:
       break;
   }  // switch
@@ -2116,18 +2288,33 @@ bool HLoopOptimization::VectorizeDotProdIdiom(LoopNode* node,
 
   HInstruction* q = instruction->InputAt(0);
   HInstruction* v = instruction->InputAt(1);
-  if (!v->IsMul() || v->GetType() != reduction_type) {
-    return false;
+  HInstruction* a = nullptr;
+  HInstruction* b = nullptr;
+  if (v->IsMul() && v->GetType() == reduction_type) {
+    a = v->InputAt(0);
+    b = v->InputAt(1);
+  } else {
+    // Accept the widening sum "q + x" with x narrower than the reduction as the
+    // dot product "q + x * 1", with the accumulated value on either side.
+    if (DataType::Size(q->GetType()) < DataType::Size(v->GetType())) {
+      std::swap(q, v);
+    }
+    a = v;
+    b = graph_->GetIntConstant(1);
+    v = nullptr;
   }
 
-  HInstruction* a = v->InputAt(0);
-  HInstruction* b = v->InputAt(1);
   HInstruction* r = a;
   HInstruction* s = b;
   DataType::Type op_type = GetNarrowerType(a, b);
   bool is_unsigned = false;
 
-  if (!IsNarrowerOperands(a, b, op_type, &r, &s, &is_unsigned)) {
+  if (DataType::Size(op_type) >= DataType::Size(reduction_type) ||
+      !IsNarrowerOperands(a, b, op_type, &r, &s, &is_unsigned)) {
+    return false;
+  }
+  // Only sum narrower array elements directly, not truncated results of wider operations.
+  if (v == nullptr && !r->IsArrayGet()) {
     return false;
   }
   op_type = HVecOperation::ToProperType(op_type, is_unsigned);
@@ -2159,9 +2346,11 @@ bool HLoopOptimization::VectorizeDotProdIdiom(LoopNode* node,
             GetOtherVL(reduction_type, op_type, vector_length_),
             kNoDexPc));
         MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorizedIdiom);
-      } else {
+      } else if (v != nullptr) {
         GenerateVecOp(v, vector_map_->Get(r), vector_map_->Get(s), reduction_type);
         GenerateVecOp(instruction, vector_map_->Get(q), vector_map_->Get(v), reduction_type);
+      } else {
+        GenerateVecOp(instruction, vector_map_->Get(q), vector_map_->Get(a), reduction_type);
       }
     }
     return true;
@@ -83,6 +83,7 @@ class HLoopOptimization : public HOptimization {
     kNoSAD           = 1 << 10,  // no sum of absolute differences (SAD)
     kNoWideSAD       = 1 << 11,  // no sum of absolute differences (SAD) with operand widening
     kNoDotProd       = 1 << 12,  // no dot product
+    kNoMinMax        = 1 << 13,  // no min/max
   };
 
   /*
@@ -165,6 +166,12 @@ class HLoopOptimization : public HOptimization {
   // Tries to apply scalar loop peeling and unrolling.
   bool TryPeelingAndUnrolling(LoopNode* node);
 
+  // Tries to apply loop unswitching: a loop with a branch on a loop-invariant condition is
+  // versioned on that condition and the branch is removed from both versions, which makes
+  // them candidates for other optimizations (e.g. vectorization). The new loop is added to
+  // the loop hierarchy right after 'node'. Returns whether transformation happened.
+  bool TryLoopUnswitching(LoopNode* node);
+
   //
   // Vectorization analysis and synthesis.
   //
@@ -337,6 +344,9 @@ class HLoopOptimization : public HOptimization {
   HBasicBlock* vector_body_;  // body of the new loop
   HInstruction* vector_index_;  // normalized index of the new loop
 
+  // Number of loop instructions duplicated by loop unswitching so far.
+  uint32_t unswitched_instructions_;
+
   // Helper for target-specific behaviour for loop optimizations.
   ArchNoOptsLoopHelper* arch_loop_helper_;
 
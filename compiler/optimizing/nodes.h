@@ -74,6 +74,10 @@ class LocationSummary;
 class SlowPathCode;
 class SsaBuilder;
 
+namespace jit {
+struct JitCompilationEvent;
+}  // namespace jit
+
 namespace mirror {
 class DexCache;
 }  // namespace mirror
@@ -381,6 +385,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
          bool osr = false,
          bool is_shared_jit_code = false,
          bool baseline = false,
+         bool fast_tier = false,
          int start_instruction_id = 0)
       : allocator_(allocator),
         arena_stack_(arena_stack),
@@ -419,6 +424,9 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         art_method_(nullptr),
         osr_(osr),
         baseline_(baseline),
+        fast_tier_(fast_tier),
+        disabled_speculations_(0u),
+        compilation_event_(nullptr),
         cha_single_implementation_list_(allocator->Adapter(kArenaAllocCHA)),
         is_shared_jit_code_(is_shared_jit_code) {
     blocks_.reserve(kDefaultNumberOfBlocks);
@@ -652,6 +660,17 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingBaseline() const { return baseline_; }
 
+  bool IsCompilingFastTier() const { return fast_tier_; }
+
+  uint32_t GetDisabledSpeculations() const { return disabled_speculations_; }
+  void SetDisabledSpeculations(uint32_t value) { disabled_speculations_ = value; }
+  bool IsSpeculationDisabled(DeoptimizationKind kind) const {
+    return (disabled_speculations_ & DeoptimizationKindMask(kind)) != 0u;
+  }
+
+  jit::JitCompilationEvent* GetCompilationEvent() const { return compilation_event_; }
+  void SetCompilationEvent(jit::JitCompilationEvent* event) { compilation_event_ = event; }
+
   bool IsCompilingForSharedJitCode() const {
     return is_shared_jit_code_;
   }
@@ -860,6 +879,18 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // the code being generated.
   const bool baseline_;
 
+  // Whether we are compiling the JIT fast tier (inlining and cheap optimizations
+  // only). Like baseline, the generated code counts hotness to trigger the
+  // optimized compilation.
+  const bool fast_tier_;
+
+  // Mask of the speculations (see `DeoptimizationKindMask`) that previously failed
+  // at runtime for the method, and which must not be used when compiling it.
+  uint32_t disabled_speculations_;
+
+  // Event recorded for the JIT compilation event log, or null if the log is disabled.
+  jit::JitCompilationEvent* compilation_event_;
+
   // List of methods that are assumed to have single implementation.
   ArenaSet<ArtMethod*> cha_single_implementation_list_;
 
@@ -3240,7 +3271,9 @@ class HDoubleConstant final : public HConstant {
 class HIf final : public HExpression<1> {
  public:
   explicit HIf(HInstruction* input, uint32_t dex_pc = kNoDexPc)
-      : HExpression(kIf, SideEffects::None(), dex_pc) {
+      : HExpression(kIf, SideEffects::None(), dex_pc),
+        true_count_(0u),
+        false_count_(0u) {
     SetRawInputAt(0, input);
   }
 
@@ -3255,10 +3288,23 @@ class HIf final : public HExpression<1> {
     return GetBlock()->GetSuccessors()[1];
   }
 
+  // Number of times the branch was taken and not taken, as recorded by baseline
+  // compiled code. Both are zero when there is no profile.
+  void SetBranchCounts(uint16_t true_count, uint16_t false_count) {
+    true_count_ = true_count;
+    false_count_ = false_count;
+  }
+  uint16_t GetTrueCount() const { return true_count_; }
+  uint16_t GetFalseCount() const { return false_count_; }
+
   DECLARE_INSTRUCTION(If);
 
  protected:
   DEFAULT_COPY_CONSTRUCTOR(If);
+
+ private:
+  uint16_t true_count_;
+  uint16_t false_count_;
 };
 
 
@@ -51,7 +51,9 @@
 #include "licm.h"
 #include "load_store_analysis.h"
 #include "load_store_elimination.h"
+#include "lock_elision.h"
 #include "loop_optimization.h"
+#include "partial_escape_analysis.h"
 #include "scheduler.h"
 #include "select_generator.h"
 #include "sharpening.h"
@@ -96,6 +98,10 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return CodeSinking::kCodeSinkingPassName;
     case OptimizationPass::kConstructorFenceRedundancyElimination:
       return ConstructorFenceRedundancyElimination::kCFREPassName;
+    case OptimizationPass::kLockElision:
+      return LockElision::kLockElisionPassName;
+    case OptimizationPass::kPartialEscapeAnalysis:
+      return PartialEscapeAnalysis::kPartialEscapeAnalysisPassName;
     case OptimizationPass::kScheduling:
       return HInstructionScheduling::kInstructionSchedulingPassName;
 #ifdef ART_ENABLE_CODEGEN_arm
@@ -144,7 +150,9 @@ OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kInvariantCodeMotion);
   X(OptimizationPass::kLoadStoreAnalysis);
   X(OptimizationPass::kLoadStoreElimination);
+  X(OptimizationPass::kLockElision);
   X(OptimizationPass::kLoopOptimization);
+  X(OptimizationPass::kPartialEscapeAnalysis);
   X(OptimizationPass::kScheduling);
   X(OptimizationPass::kSelectGenerator);
   X(OptimizationPass::kSideEffectsAnalysis);
@@ -274,6 +282,12 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kCodeSinking:
         opt = new (allocator) CodeSinking(graph, stats, pass_name);
         break;
+      case OptimizationPass::kLockElision:
+        opt = new (allocator) LockElision(graph, stats, pass_name);
+        break;
+      case OptimizationPass::kPartialEscapeAnalysis:
+        opt = new (allocator) PartialEscapeAnalysis(graph, stats, pass_name);
+        break;
       case OptimizationPass::kConstructorFenceRedundancyElimination:
         opt = new (allocator) ConstructorFenceRedundancyElimination(graph, stats, pass_name);
         break;
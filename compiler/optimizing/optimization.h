@@ -80,7 +80,9 @@ enum class OptimizationPass {
   kInvariantCodeMotion,
   kLoadStoreAnalysis,
   kLoadStoreElimination,
+  kLockElision,
   kLoopOptimization,
+  kPartialEscapeAnalysis,
   kScheduling,
   kSelectGenerator,
   kSideEffectsAnalysis,
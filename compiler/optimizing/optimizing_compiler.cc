@@ -30,6 +30,7 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -50,6 +51,7 @@
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/jit_logger.h"
+#include "jit/profiling_info.h"
 #include "jni/quick/jni_compiler.h"
 #include "linker/linker_patch.h"
 #include "nodes.h"
@@ -119,6 +121,7 @@ class PassObserver : public ValueObject {
         visualizer_enabled_(!compiler_options.GetDumpCfgFileName().empty()),
         visualizer_(&visualizer_oss_, graph, *codegen),
         visualizer_dump_mutex_(dump_mutex),
+        pass_start_ns_(0),
         graph_in_bad_state_(false) {
     if (timing_logger_enabled_ || visualizer_enabled_) {
       if (!IsVerboseMethod(compiler_options, GetMethodName())) {
@@ -168,6 +171,9 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (graph_->GetCompilationEvent() != nullptr) {
+      pass_start_ns_ = NanoTime();
+    }
   }
 
   void FlushVisualizer() REQUIRES(!visualizer_dump_mutex_) {
@@ -183,6 +189,10 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
+    if (graph_->GetCompilationEvent() != nullptr) {
+      graph_->GetCompilationEvent()->pass_timings.push_back(
+          jit::JitCompilationEvent::PassTiming { pass_name, NanoTime() - pass_start_ns_ });
+    }
     if (visualizer_enabled_) {
       visualizer_.DumpGraph(pass_name, /* is_after_pass= */ true, graph_in_bad_state_);
     }
@@ -232,6 +242,9 @@ class PassObserver : public ValueObject {
   HGraphVisualizer visualizer_;
   Mutex& visualizer_dump_mutex_;
 
+  // Start time of the current pass, for the JIT compilation event log.
+  uint64_t pass_start_ns_;
+
   // Flag to be set by the compiler if the pass failed and the graph is not
   // expected to validate.
   bool graph_in_bad_state_;
@@ -296,9 +309,9 @@ class OptimizingCompiler final : public Compiler {
                   jit::JitCodeCache* code_cache,
                   jit::JitMemoryRegion* region,
                   ArtMethod* method,
-                  bool baseline,
-                  bool osr,
-                  jit::JitLogger* jit_logger)
+                  CompilationKind compilation_kind,
+                  jit::JitLogger* jit_logger,
+                  jit::JitCompilationEvent* compilation_event)
       override
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -377,9 +390,9 @@ class OptimizingCompiler final : public Compiler {
                             CodeVectorAllocator* code_allocator,
                             const DexCompilationUnit& dex_compilation_unit,
                             ArtMethod* method,
-                            bool baseline,
-                            bool osr,
+                            CompilationKind compilation_kind,
                             bool is_shared_jit_code,
+                            jit::JitCompilationEvent* compilation_event,
                             VariableSizedHandleScope* handles) const;
 
   CodeGenerator* TryCompileIntrinsic(ArenaAllocator* allocator,
@@ -399,6 +412,13 @@ class OptimizingCompiler final : public Compiler {
                                 const DexCompilationUnit& dex_compilation_unit,
                                 PassObserver* pass_observer) const;
 
+  // Run the optimizations of the JIT fast tier: inlining and cheap simplifications,
+  // without the expensive loop and memory optimizations.
+  void RunFastTierOptimizations(HGraph* graph,
+                                CodeGenerator* codegen,
+                                const DexCompilationUnit& dex_compilation_unit,
+                                PassObserver* pass_observer) const;
+
   void GenerateJitDebugInfo(const debug::MethodDebugInfo& method_debug_info);
 
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
@@ -486,6 +506,50 @@ bool OptimizingCompiler::RunBaselineOptimizations(HGraph* graph,
   }
 }
 
+void OptimizingCompiler::RunFastTierOptimizations(HGraph* graph,
+                                                  CodeGenerator* codegen,
+                                                  const DexCompilationUnit& dex_compilation_unit,
+                                                  PassObserver* pass_observer) const {
+  OptimizationDef optimizations[] = {
+    OptDef(OptimizationPass::kConstantFolding),
+    OptDef(OptimizationPass::kInstructionSimplifier),
+    OptDef(OptimizationPass::kDeadCodeElimination,
+           "dead_code_elimination$initial"),
+    // Inlining, driven by the inline caches collected by the baseline code.
+    OptDef(OptimizationPass::kInliner),
+    // Simplification (only if inlining occurred).
+    OptDef(OptimizationPass::kConstantFolding,
+           "constant_folding$after_inlining",
+           OptimizationPass::kInliner),
+    OptDef(OptimizationPass::kInstructionSimplifier,
+           "instruction_simplifier$after_inlining",
+           OptimizationPass::kInliner),
+    OptDef(OptimizationPass::kDeadCodeElimination,
+           "dead_code_elimination$after_inlining",
+           OptimizationPass::kInliner),
+    // GVN.
+    OptDef(OptimizationPass::kSideEffectsAnalysis,
+           "side_effects$before_gvn"),
+    OptDef(OptimizationPass::kGlobalValueNumbering),
+    OptDef(OptimizationPass::kCHAGuardOptimization),
+    OptDef(OptimizationPass::kDeadCodeElimination,
+           "dead_code_elimination$final"),
+    // The codegen has a few assumptions that only the instruction simplifier
+    // can satisfy.
+    OptDef(OptimizationPass::kAggressiveInstructionSimplifier,
+           "instruction_simplifier$before_codegen"),
+    OptDef(OptimizationPass::kConstructorFenceRedundancyElimination)
+  };
+  RunOptimizations(graph,
+                   codegen,
+                   dex_compilation_unit,
+                   pass_observer,
+                   optimizations);
+
+  // Only run the architecture specific passes the code generator depends on.
+  RunBaselineOptimizations(graph, codegen, dex_compilation_unit, pass_observer);
+}
+
 bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                                               CodeGenerator* codegen,
                                               const DexCompilationUnit& dex_compilation_unit,
@@ -659,6 +723,8 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kAggressiveInstructionSimplifier,
            "instruction_simplifier$after_bce"),
     // Other high-level optimizations.
+    OptDef(OptimizationPass::kLockElision),
+    OptDef(OptimizationPass::kPartialEscapeAnalysis),
     OptDef(OptimizationPass::kSideEffectsAnalysis,
            "side_effects$before_lse"),
     OptDef(OptimizationPass::kLoadStoreAnalysis),
@@ -731,9 +797,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                                               CodeVectorAllocator* code_allocator,
                                               const DexCompilationUnit& dex_compilation_unit,
                                               ArtMethod* method,
-                                              bool baseline,
-                                              bool osr,
+                                              CompilationKind compilation_kind,
                                               bool is_shared_jit_code,
+                                              jit::JitCompilationEvent* compilation_event,
                                               VariableSizedHandleScope* handles) const {
   MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kAttemptBytecodeCompilation);
   const CompilerOptions& compiler_options = GetCompilerOptions();
@@ -771,6 +837,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   CodeItemDebugInfoAccessor code_item_accessor(dex_file, code_item, method_idx);
 
   bool dead_reference_safe;
+  uint32_t disabled_speculations = 0u;
   ArrayRef<const uint8_t> interpreter_metadata;
   // For AOT compilation, we may not get a method, for example if its class is erroneous,
   // possibly due to an unavailable superclass.  JIT should always have a method.
@@ -781,6 +848,13 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
       ScopedObjectAccess soa(Thread::Current());
       containing_class = &method->GetClassDef();
       interpreter_metadata = method->GetQuickenedInfo();
+      if (!Runtime::Current()->IsAotCompiler()) {
+        // Do not reuse the speculations that made previously compiled code deoptimize.
+        ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+        if (info != nullptr) {
+          disabled_speculations = info->GetDisabledSpeculations();
+        }
+      }
     }
     // MethodContainsRSensitiveAccess is currently slow, but HasDeadReferenceSafeAnnotation()
     // is currently rarely true.
@@ -802,13 +876,16 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
       kInvalidInvokeType,
       dead_reference_safe,
       compiler_options.GetDebuggable(),
-      /* osr= */ osr,
+      /* osr= */ compilation_kind == CompilationKind::kOsr,
       /* is_shared_jit_code= */ is_shared_jit_code,
-      /* baseline= */ baseline);
+      /* baseline= */ compilation_kind == CompilationKind::kBaseline,
+      /* fast_tier= */ compilation_kind == CompilationKind::kFast);
 
   if (method != nullptr) {
     graph->SetArtMethod(method);
   }
+  graph->SetDisabledSpeculations(disabled_speculations);
+  graph->SetCompilationEvent(compilation_event);
 
   std::unique_ptr<CodeGenerator> codegen(
       CodeGenerator::Create(graph,
@@ -877,14 +954,23 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     }
   }
 
-  if (baseline) {
-    RunBaselineOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
-  } else {
-    RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
-  }
-
   RegisterAllocator::Strategy regalloc_strategy =
     compiler_options.GetRegisterAllocationStrategy();
+  switch (compilation_kind) {
+    case CompilationKind::kBaseline:
+      RunBaselineOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+      break;
+    case CompilationKind::kFast:
+      RunFastTierOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+      // The fast tier favors compile time over register allocation quality.
+      regalloc_strategy = RegisterAllocator::kRegisterAllocatorLinearScan;
+      break;
+    case CompilationKind::kOsr:
+    case CompilationKind::kOptimized:
+      RunOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
+      break;
+  }
+
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
@@ -1062,9 +1148,11 @@ CompiledMethod* OptimizingCompiler::Compile(const dex::CodeItem* code_item,
                        &code_allocator,
                        dex_compilation_unit,
                        method,
-                       compiler_options.IsBaseline(),
-                       /* osr= */ false,
+                       compiler_options.IsBaseline()
+                           ? CompilationKind::kBaseline
+                           : CompilationKind::kOptimized,
                        /* is_shared_jit_code= */ false,
+                       /* compilation_event= */ nullptr,
                        &handles));
       }
     }
@@ -1210,9 +1298,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                                     jit::JitCodeCache* code_cache,
                                     jit::JitMemoryRegion* region,
                                     ArtMethod* method,
-                                    bool baseline,
-                                    bool osr,
-                                    jit::JitLogger* jit_logger) {
+                                    CompilationKind compilation_kind,
+                                    jit::JitLogger* jit_logger,
+                                    jit::JitCompilationEvent* compilation_event) {
   StackHandleScope<3> hs(self);
   Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
       method->GetDeclaringClass()->GetClassLoader()));
@@ -1228,6 +1316,11 @@ bool OptimizingCompiler::JitCompile(Thread* self,
   Runtime* runtime = Runtime::Current();
   ArenaAllocator allocator(runtime->GetJitArenaPool());
 
+  // The native debug info of the code a child zygote publishes would be linked after the
+  // entries of its parent zygote, which it cannot write.
+  const bool generate_debug_info =
+      GetCompilerOptions().GenerateAnyDebugInfo() && !code_cache->IsPublishedRegion(*region);
+
   if (UNLIKELY(method->IsNative())) {
     const CompilerOptions& compiler_options = GetCompilerOptions();
     JniCompiledMethod jni_compiled_method = ArtQuickJniCompileMethod(
@@ -1257,7 +1350,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
     const uint8_t* code = reserved_code.data() + OatQuickMethodHeader::InstructionAlignedSize();
 
     // Add debug info after we know the code location but before we update entry-point.
-    if (compiler_options.GenerateAnyDebugInfo()) {
+    if (generate_debug_info) {
       debug::MethodDebugInfo info = {};
       info.custom_name = "art_jni_trampoline";
       info.dex_file = dex_file;
@@ -1286,7 +1379,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                             reserved_data,
                             roots,
                             ArrayRef<const uint8_t>(stack_map),
-                            osr,
+                            compilation_kind == CompilationKind::kOsr,
                             /* has_should_deoptimize_flag= */ false,
                             cha_single_implementation_list)) {
       code_cache->Free(self, region, reserved_code.data(), reserved_data.data());
@@ -1294,6 +1387,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
     }
 
     Runtime::Current()->GetJit()->AddMemoryUsage(method, allocator.BytesUsed());
+    if (compilation_event != nullptr) {
+      compilation_event->code_size = jni_compiled_method.GetCode().size();
+    }
     if (jit_logger != nullptr) {
       jit_logger->WriteLog(code, jni_compiled_method.GetCode().size(), method);
     }
@@ -1304,6 +1400,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
   CodeVectorAllocator code_allocator(&allocator);
   VariableSizedHandleScope handles(self);
 
+  // With --baseline, every request produces baseline code.
+  const CompilationKind compiled_kind =
+      GetCompilerOptions().IsBaseline() ? CompilationKind::kBaseline : compilation_kind;
   std::unique_ptr<CodeGenerator> codegen;
   {
     Handle<mirror::Class> compiling_class = handles.NewHandle(method->GetDeclaringClass());
@@ -1327,9 +1426,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                    &code_allocator,
                    dex_compilation_unit,
                    method,
-                   baseline || GetCompilerOptions().IsBaseline(),
-                   osr,
+                   compiled_kind,
                    /* is_shared_jit_code= */ code_cache->IsSharedRegion(*region),
+                   compilation_event,
                    &handles));
     if (codegen.get() == nullptr) {
       return false;
@@ -1365,7 +1464,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
 
   // Add debug info after we know the code location but before we update entry-point.
   const CompilerOptions& compiler_options = GetCompilerOptions();
-  if (compiler_options.GenerateAnyDebugInfo()) {
+  if (generate_debug_info) {
     debug::MethodDebugInfo info = {};
     DCHECK(info.custom_name.empty());
     info.dex_file = dex_file;
@@ -1394,7 +1493,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                           reserved_data,
                           roots,
                           ArrayRef<const uint8_t>(stack_map),
-                          osr,
+                          compilation_kind == CompilationKind::kOsr,
                           codegen->GetGraph()->HasShouldDeoptimizeFlag(),
                           codegen->GetGraph()->GetCHASingleImplementationList())) {
     code_cache->Free(self, region, reserved_code.data(), reserved_data.data());
@@ -1402,6 +1501,10 @@ bool OptimizingCompiler::JitCompile(Thread* self,
   }
 
   Runtime::Current()->GetJit()->AddMemoryUsage(method, allocator.BytesUsed());
+  Runtime::Current()->GetJit()->AddCodeSize(compiled_kind, code_allocator.GetMemory().size());
+  if (compilation_event != nullptr) {
+    compilation_event->code_size = code_allocator.GetMemory().size();
+  }
   if (jit_logger != nullptr) {
     jit_logger->WriteLog(code, code_allocator.GetMemory().size(), method);
   }
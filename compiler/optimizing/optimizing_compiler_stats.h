@@ -72,6 +72,7 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopUnswitched,
   kSelectGenerated,
   kRemovedInstanceOf,
   kInlinedInvokeVirtualOrInterface,
@@ -80,6 +81,7 @@ enum class MethodCompilationStat {
   kSimplifyIf,
   kSimplifyThrowingInvoke,
   kInstructionSunk,
+  kAllocationSunk,
   kNotInlinedUnresolvedEntrypoint,
   kNotInlinedDexCache,
   kNotInlinedStackMaps,
@@ -101,11 +103,17 @@ enum class MethodCompilationStat {
   kNotInlinedPolymorphic,
   kNotInlinedCustom,
   kTryInline,
+  kTryInlineHotCallSite,
+  kTryInlineColdCallSite,
   kConstructorFenceGeneratedNew,
   kConstructorFenceGeneratedFinal,
   kConstructorFenceRemovedLSE,
   kConstructorFenceRemovedPFRA,
   kConstructorFenceRemovedCFRE,
+  kPartialEscapeAllocationRemoved,
+  kPartialEscapeMaterialization,
+  kMonitorOperationElided,
+  kMonitorOperationCoarsened,
   kBitstringTypeCheck,
   kJitOutOfMemoryForCommit,
   kLastStat
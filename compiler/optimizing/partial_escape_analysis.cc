@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_escape_analysis.h"
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
+#include "base/scoped_arena_containers.h"
+#include "optimizing_compiler_stats.h"
+
+namespace art {
+
+static HInstruction* GetDefaultValue(HGraph* graph, DataType::Type type) {
+  switch (type) {
+    case DataType::Type::kReference:
+      return graph->GetNullConstant();
+    case DataType::Type::kFloat32:
+      return graph->GetFloatConstant(0);
+    case DataType::Type::kFloat64:
+      return graph->GetDoubleConstant(0);
+    default:
+      return graph->GetConstant(type, 0);
+  }
+}
+
+// Replace `load` with `value`, the value last stored in the field, or the field's
+// default value if `value` is null.
+static void ReplaceLoad(HInstanceFieldGet* load, HInstruction* value) {
+  HGraph* graph = load->GetBlock()->GetGraph();
+  DataType::Type type = load->GetType();
+  if (value == nullptr) {
+    value = GetDefaultValue(graph, type);
+  } else if (type != DataType::Type::kBool &&
+             !DataType::IsTypeConversionImplicit(value->GetType(), type)) {
+    // As in load-store elimination, a single conversion from the stored value to the
+    // type of the load is enough.
+    HTypeConversion* conversion =
+        new (graph->GetAllocator()) HTypeConversion(type, value, load->GetDexPc());
+    load->GetBlock()->InsertInstructionBefore(conversion, load);
+    value = conversion;
+  }
+  load->ReplaceWith(value);
+  load->GetBlock()->RemoveInstruction(load);
+}
+
+bool PartialEscapeAnalysis::Run() {
+  if (graph_->IsDebuggable() || graph_->HasTryCatch() || graph_->HasIrreducibleLoops()) {
+    // The debugger may look at the object on any path, and catch blocks would need
+    // the object in their environment. Irreducible loops are not worth the trouble.
+    return false;
+  }
+  if (graph_->GetExitBlock() == nullptr) {
+    // Infinite loop, just bail.
+    return false;
+  }
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  // Collect the candidates first, as the pass creates new allocations.
+  ScopedArenaVector<HNewInstance*> candidates(allocator.Adapter(kArenaAllocMisc));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsNewInstance()) {
+        candidates.push_back(it.Current()->AsNewInstance());
+      }
+    }
+  }
+
+  bool changed = false;
+  for (HNewInstance* new_instance : candidates) {
+    ScopedArenaAllocator candidate_allocator(allocator.GetArenaStack());
+    changed |= TryScalarReplace(new_instance, &candidate_allocator);
+  }
+  return changed;
+}
+
+bool PartialEscapeAnalysis::TryScalarReplace(HNewInstance* new_instance,
+                                             ScopedArenaAllocator* allocator) {
+  if (new_instance->IsFinalizable() ||
+      new_instance->NeedsChecks() ||
+      new_instance->IsStringAlloc()) {
+    // Moving the allocation would change which exceptions are thrown, or when
+    // the object becomes visible to the finalizer.
+    return false;
+  }
+
+  HBasicBlock* allocation_block = new_instance->GetBlock();
+  const size_t number_of_blocks = graph_->GetBlocks().size();
+  ScopedArenaVector<HInstanceFieldGet*> loads(allocator->Adapter(kArenaAllocMisc));
+  ScopedArenaVector<HInstanceFieldSet*> stores(allocator->Adapter(kArenaAllocMisc));
+  ArenaBitVector use_blocks(allocator, number_of_blocks, /* expandable= */ false);
+  use_blocks.ClearAllBits();
+  ArenaBitVector escape_blocks(allocator, number_of_blocks, /* expandable= */ false);
+  escape_blocks.ClearAllBits();
+  ArenaBitVector escapes(allocator, graph_->GetCurrentInstructionId(), /* expandable= */ false);
+  escapes.ClearAllBits();
+  bool has_constructor_fence = false;
+
+  // Step (1): Classify the uses of the allocation.
+  for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+    HInstruction* user = use.GetUser();
+    HBasicBlock* block = user->GetBlock();
+    use_blocks.SetBit(block->GetBlockId());
+    if (user->IsInstanceFieldSet() && user->InputAt(1) != new_instance) {
+      // Only stores of the allocation block, typically the inlined constructor, are
+      // scalar replaced.
+      if (block != allocation_block || user->AsInstanceFieldSet()->IsVolatile()) {
+        return false;
+      }
+      stores.push_back(user->AsInstanceFieldSet());
+    } else if (user->IsInstanceFieldGet()) {
+      if (user->AsInstanceFieldGet()->IsVolatile()) {
+        return false;
+      }
+      loads.push_back(user->AsInstanceFieldGet());
+    } else if (user->IsConstructorFence()) {
+      if (block != allocation_block) {
+        return false;
+      }
+      has_constructor_fence = true;
+    } else if (user->IsPhi() || user->IsSelect() || user->IsBoundType() || user->IsNullCheck()) {
+      // The object gets another name, which we don't track.
+      return false;
+    } else {
+      // Any other use needs the actual object.
+      if (block == allocation_block) {
+        return false;
+      }
+      escape_blocks.SetBit(block->GetBlockId());
+      escapes.SetBit(user->GetId());
+    }
+  }
+  if (escape_blocks.NumSetBits() == 0) {
+    // Load-store elimination handles allocations that do not escape.
+    return false;
+  }
+  for (const HUseListNode<HEnvironment*>& use : new_instance->GetEnvUses()) {
+    HInstruction* holder = use.GetUser()->GetHolder();
+    if (holder->IsDeoptimize()) {
+      // The interpreter needs the object when deoptimizing.
+      return false;
+    }
+    use_blocks.SetBit(holder->GetBlock()->GetBlockId());
+  }
+
+  // Step (2): Check that an escaping block does not reach any other use of the
+  // allocation, except through the allocation itself (e.g. in a loop). The object
+  // materialized in an escaping block is then the only one its later uses see.
+  ScopedArenaVector<HBasicBlock*> worklist(allocator->Adapter(kArenaAllocMisc));
+  ArenaBitVector visited(allocator, number_of_blocks, /* expandable= */ false);
+  for (uint32_t block_id : escape_blocks.Indexes()) {
+    HBasicBlock* escape_block = graph_->GetBlocks()[block_id];
+    visited.ClearAllBits();
+    worklist.assign(escape_block->GetSuccessors().begin(), escape_block->GetSuccessors().end());
+    while (!worklist.empty()) {
+      HBasicBlock* block = worklist.back();
+      worklist.pop_back();
+      if (block == allocation_block || visited.IsBitSet(block->GetBlockId())) {
+        continue;
+      }
+      if (use_blocks.IsBitSet(block->GetBlockId())) {
+        return false;
+      }
+      visited.SetBit(block->GetBlockId());
+      worklist.insert(worklist.end(), block->GetSuccessors().begin(), block->GetSuccessors().end());
+    }
+  }
+
+  // Step (3): Check that there is a path on which the object does not escape, otherwise
+  // there is nothing to gain.
+  bool has_non_escaping_path = false;
+  visited.ClearAllBits();
+  worklist.assign(allocation_block->GetSuccessors().begin(),
+                  allocation_block->GetSuccessors().end());
+  while (!worklist.empty() && !has_non_escaping_path) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    if (escape_blocks.IsBitSet(block->GetBlockId()) || visited.IsBitSet(block->GetBlockId())) {
+      continue;
+    }
+    visited.SetBit(block->GetBlockId());
+    has_non_escaping_path = block->IsExitBlock();
+    worklist.insert(worklist.end(), block->GetSuccessors().begin(), block->GetSuccessors().end());
+  }
+  if (!has_non_escaping_path) {
+    return false;
+  }
+
+  // Step (4): Compute the value of the fields, at each load of the allocation block, and
+  // at the end of it. A null value stands for the default value of the field.
+  ScopedArenaSafeMap<uint32_t, HInstanceFieldSet*> last_stores(
+      std::less<uint32_t>(), allocator->Adapter(kArenaAllocMisc));
+  ScopedArenaSafeMap<HInstruction*, HInstruction*> load_values(
+      std::less<HInstruction*>(), allocator->Adapter(kArenaAllocMisc));
+  auto field_value = [&](MemberOffset offset) -> HInstruction* {
+    auto it = last_stores.find(offset.Uint32Value());
+    return (it == last_stores.end()) ? nullptr : it->second->GetValue();
+  };
+  for (HInstruction* instruction = new_instance->GetNext();
+       instruction != nullptr;
+       instruction = instruction->GetNext()) {
+    if (instruction->IsInstanceFieldSet() && instruction->InputAt(0) == new_instance) {
+      HInstanceFieldSet* store = instruction->AsInstanceFieldSet();
+      last_stores.Overwrite(store->GetFieldOffset().Uint32Value(), store);
+    } else if (instruction->IsInstanceFieldGet() && instruction->InputAt(0) == new_instance) {
+      load_values.Put(instruction, field_value(instruction->AsInstanceFieldGet()->GetFieldOffset()));
+    }
+  }
+
+  // Step (5): Find the first escaping use of each escaping block, where the object gets
+  // materialized.
+  ScopedArenaVector<HInstruction*> materialization_points(
+      number_of_blocks, nullptr, allocator->Adapter(kArenaAllocMisc));
+  for (uint32_t block_id : escape_blocks.Indexes()) {
+    HBasicBlock* escape_block = graph_->GetBlocks()[block_id];
+    for (HInstructionIterator it(escape_block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (escapes.IsBitSet(it.Current()->GetId())) {
+        materialization_points[block_id] = it.Current();
+        break;
+      }
+    }
+    DCHECK(materialization_points[block_id] != nullptr);
+  }
+
+  // Step (6): Scalar replace the loads that see the object before it escapes.
+  for (HInstanceFieldGet* load : loads) {
+    HBasicBlock* block = load->GetBlock();
+    HInstruction* materialization_point = materialization_points[block->GetBlockId()];
+    if (materialization_point != nullptr && materialization_point->StrictlyDominates(load)) {
+      // Load from the materialized object.
+      continue;
+    }
+    ReplaceLoad(load,
+                (block == allocation_block) ? load_values.Get(load)
+                                            : field_value(load->GetFieldOffset()));
+  }
+
+  // Step (7): Materialize the object in each escaping block.
+  ArenaAllocator* graph_allocator = graph_->GetAllocator();
+  for (uint32_t block_id : escape_blocks.Indexes()) {
+    HBasicBlock* escape_block = graph_->GetBlocks()[block_id];
+    HInstruction* materialization_point = materialization_points[block_id];
+    HNewInstance* materialized = new (graph_allocator) HNewInstance(
+        new_instance->InputAt(0),
+        new_instance->GetDexPc(),
+        new_instance->GetTypeIndex(),
+        new_instance->GetDexFile(),
+        new_instance->IsFinalizable(),
+        new_instance->GetEntrypoint());
+    escape_block->InsertInstructionBefore(materialized, materialization_point);
+    materialized->CopyEnvironmentFrom(new_instance->GetEnvironment());
+    materialized->SetReferenceTypeInfo(new_instance->GetReferenceTypeInfo());
+    for (const auto& entry : last_stores) {
+      HInstanceFieldSet* store = entry.second;
+      const FieldInfo& field_info = store->GetFieldInfo();
+      HInstanceFieldSet* materialized_store = new (graph_allocator) HInstanceFieldSet(
+          materialized,
+          store->GetValue(),
+          field_info.GetField(),
+          field_info.GetFieldType(),
+          field_info.GetFieldOffset(),
+          field_info.IsVolatile(),
+          field_info.GetFieldIndex(),
+          field_info.GetDeclaringClassDefIndex(),
+          field_info.GetDexFile(),
+          store->GetDexPc());
+      if (!store->GetValueCanBeNull()) {
+        materialized_store->ClearValueCanBeNull();
+      }
+      escape_block->InsertInstructionBefore(materialized_store, materialization_point);
+    }
+    if (has_constructor_fence) {
+      HConstructorFence* fence = new (graph_allocator) HConstructorFence(
+          materialized, new_instance->GetDexPc(), graph_allocator);
+      escape_block->InsertInstructionBefore(fence, materialization_point);
+    }
+    new_instance->ReplaceUsesDominatedBy(materialized, materialized);
+    new_instance->ReplaceEnvUsesDominatedBy(materialized, materialized);
+    MaybeRecordStat(stats_, MethodCompilationStat::kPartialEscapeMaterialization);
+  }
+
+  // Step (8): Remove the original allocation. Like load-store elimination, drop the
+  // environment uses on the paths where the object doesn't escape.
+  for (HInstanceFieldSet* store : stores) {
+    store->GetBlock()->RemoveInstruction(store);
+  }
+  HConstructorFence::RemoveConstructorFences(new_instance);
+  new_instance->RemoveEnvironmentUsers();
+  DCHECK(!new_instance->HasUses());
+  allocation_block->RemoveInstruction(new_instance);
+  MaybeRecordStat(stats_, MethodCompilationStat::kPartialEscapeAllocationRemoved);
+  return true;
+}
+
+}  // namespace art
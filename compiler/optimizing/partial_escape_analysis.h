@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
+#define ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
+
+#include "base/scoped_arena_allocator.h"
+#include "nodes.h"
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass to remove allocations that only escape on some paths.
+ *
+ * Load-store elimination removes allocations that never escape. This pass handles
+ * allocations that escape only in some blocks, for example an error or a cache-miss
+ * branch: the allocation is scalar replaced on the other paths, and re-created
+ * ("materialized") with its field values right before its first escaping use in
+ * each escaping block.
+ *
+ * The pass handles the common shape of an allocation followed by its (inlined)
+ * constructor: all stores to the object must be in the allocation block, and an
+ * escaping block must not reach any other use of the object. Loads from the
+ * object on non-escaping paths are replaced by the stored values.
+ */
+class PartialEscapeAnalysis : public HOptimization {
+ public:
+  PartialEscapeAnalysis(HGraph* graph,
+                        OptimizingCompilerStats* stats,
+                        const char* name = kPartialEscapeAnalysisPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kPartialEscapeAnalysisPassName = "partial_escape_analysis";
+
+ private:
+  // Try to scalar replace `new_instance` on its non-escaping paths. Returns whether
+  // the graph was changed.
+  bool TryScalarReplace(HNewInstance* new_instance, ScopedArenaAllocator* allocator);
+
+  DISALLOW_COPY_AND_ASSIGN(PartialEscapeAnalysis);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PARTIAL_ESCAPE_ANALYSIS_H_
@@ -181,6 +181,14 @@ bool PrepareForRegisterAllocation::CanEmitConditionAt(HCondition* condition,
     return false;
   }
 
+  if (user->IsIf() &&
+      GetGraph()->IsCompilingBaseline() &&
+      compiler_options_.ProfileBranches()) {
+    // The code counting the outcome of the branch needs the condition in a register,
+    // see CodeGenerator::IsProfilingBranch.
+    return false;
+  }
+
   if (user->IsIf() || user->IsDeoptimize()) {
     return true;
   }
@@ -16,6 +16,7 @@
 
 #include "ssa_liveness_analysis.h"
 
+#include "base/arena_bit_vector.h"
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
 #include "linear_order.h"
@@ -270,22 +271,39 @@ void SsaLivenessAnalysis::ComputeLiveRanges() {
 }
 
 void SsaLivenessAnalysis::ComputeLiveInAndLiveOutSets() {
-  bool changed;
-  do {
-    changed = false;
-
-    for (const HBasicBlock* block : graph_->GetPostOrder()) {
-      // The live_in set depends on the kill set (which does not
-      // change in this loop), and the live_out set.  If the live_out
-      // set does not change, there is no need to update the live_in set.
-      if (UpdateLiveOut(*block) && UpdateLiveIn(*block)) {
-        if (kIsDebugBuild) {
-          CheckNoLiveInIrreducibleLoop(*block);
+  // Iterate to a fixed point with a worklist: once visited, a block only needs to be
+  // visited again when the live_in set of one of its successors has changed, instead
+  // of sweeping over all blocks until nothing changes.
+  size_t number_of_blocks = graph_->GetBlocks().size();
+  ScopedArenaVector<HBasicBlock*> worklist(allocator_->Adapter(kArenaAllocSsaLiveness));
+  worklist.reserve(number_of_blocks);
+  ArenaBitVector in_worklist(
+      allocator_, number_of_blocks, /* expandable= */ false, kArenaAllocSsaLiveness);
+  // Seed the worklist so that blocks are first visited in post order.
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    worklist.push_back(block);
+    in_worklist.SetBit(block->GetBlockId());
+  }
+
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    in_worklist.ClearBit(block->GetBlockId());
+    // The live_in set depends on the kill set (which does not
+    // change in this loop), and the live_out set.  If the live_out
+    // set does not change, there is no need to update the live_in set.
+    if (UpdateLiveOut(*block) && UpdateLiveIn(*block)) {
+      if (kIsDebugBuild) {
+        CheckNoLiveInIrreducibleLoop(*block);
+      }
+      for (HBasicBlock* predecessor : block->GetPredecessors()) {
+        if (!in_worklist.IsBitSet(predecessor->GetBlockId())) {
+          in_worklist.SetBit(predecessor->GetBlockId());
+          worklist.push_back(predecessor);
         }
-        changed = true;
       }
     }
-  } while (changed);
+  }
 }
 
 bool SsaLivenessAnalysis::UpdateLiveOut(const HBasicBlock& block) {
@@ -1255,8 +1255,8 @@ class SsaLivenessAnalysis : public ValueObject {
   // kill sets, that do not take into account backward branches.
   void ComputeLiveRanges();
 
-  // After computing the initial sets, this method does a fixed point
-  // calculation over the live_in and live_out set to take into account
+  // After computing the initial sets, this method does a worklist-based fixed
+  // point calculation over the live_in and live_out set to take into account
   // backwards branches.
   void ComputeLiveInAndLiveOutSets();
 
@@ -19,6 +19,7 @@
 #include "arch/instruction_set.h"
 #include "arch/instruction_set_features.h"
 #include "base/arena_allocator.h"
+#include "base/arena_bit_vector.h"
 #include "base/arena_containers.h"
 #include "code_generator.h"
 #include "driver/compiler_options.h"
@@ -49,6 +50,26 @@ class SsaLivenessAnalysisTest : public OptimizingUnitTest {
     return successor;
   }
 
+  // Checks that the live_in and live_out sets of all blocks are a solution of the
+  // liveness equations, that is no further iteration would change them.
+  void CheckLivenessFixedPoint(const SsaLivenessAnalysis& ssa_analysis) {
+    ArenaBitVector live_out_not_killed(GetAllocator(), 0u, /* expandable= */ true);
+    for (HBasicBlock* block : graph_->GetBlocks()) {
+      if (block == nullptr) {
+        continue;
+      }
+      BitVector* live_out = ssa_analysis.GetLiveOutSet(*block);
+      for (HBasicBlock* successor : block->GetSuccessors()) {
+        EXPECT_TRUE(ssa_analysis.GetLiveInSet(*successor)->IsSubsetOf(live_out))
+            << block->GetBlockId() << " -> " << successor->GetBlockId();
+      }
+      live_out_not_killed.Copy(live_out);
+      live_out_not_killed.Subtract(ssa_analysis.GetKillSet(*block));
+      EXPECT_TRUE(live_out_not_killed.IsSubsetOf(ssa_analysis.GetLiveInSet(*block)))
+          << block->GetBlockId();
+    }
+  }
+
   HGraph* graph_;
   std::unique_ptr<CodeGenerator> codegen_;
   HBasicBlock* entry_;
@@ -215,4 +236,72 @@ TEST_F(SsaLivenessAnalysisTest, TestDeoptimize) {
   }
 }
 
+// A value defined before a deep loop nest and only used in the innermost loop must be
+// live in at every block of the nest. The blocks jumping back to outer loop headers
+// are visited before those headers, so this relies on the fixed point iteration.
+TEST_F(SsaLivenessAnalysisTest, TestDeepLoopNest) {
+  constexpr size_t kDepth = 50u;
+  HInstruction* value = new (GetAllocator()) HParameterValue(
+      graph_->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+  HInstruction* cond = new (GetAllocator()) HParameterValue(
+      graph_->GetDexFile(), dex::TypeIndex(1), 1, DataType::Type::kBool);
+  entry_->AddInstruction(value);
+  entry_->AddInstruction(cond);
+  entry_->AddInstruction(new (GetAllocator()) HGoto());
+
+  HBasicBlock* return_block = new (GetAllocator()) HBasicBlock(graph_);
+  graph_->AddBlock(return_block);
+  return_block->AddInstruction(new (GetAllocator()) HReturnVoid());
+  HBasicBlock* exit = CreateSuccessor(return_block);
+  exit->AddInstruction(new (GetAllocator()) HExit());
+  graph_->SetExitBlock(exit);
+
+  // Build headers for `kDepth` nested loops, each one leaving to the header of the
+  // enclosing loop, or to the return block for the outermost one.
+  HBasicBlock* block = entry_;
+  HBasicBlock* enclosing_header = nullptr;
+  for (size_t i = 0; i != kDepth; ++i) {
+    HBasicBlock* header = CreateSuccessor(block);
+    header->AddInstruction(new (GetAllocator()) HIf(cond));
+    if (block != entry_) {
+      block->AddInstruction(new (GetAllocator()) HGoto());
+    }
+    HBasicBlock* loop_exit = new (GetAllocator()) HBasicBlock(graph_);
+    graph_->AddBlock(loop_exit);
+    loop_exit->AddInstruction(new (GetAllocator()) HGoto());
+    loop_exit->AddSuccessor(enclosing_header != nullptr ? enclosing_header : return_block);
+    // The `true` successor of the HIf is added below, as the next header or the body.
+    HBasicBlock* next = new (GetAllocator()) HBasicBlock(graph_);
+    graph_->AddBlock(next);
+    header->AddSuccessor(next);
+    header->AddSuccessor(loop_exit);
+    enclosing_header = header;
+    block = next;
+    if (i + 1u != kDepth) {
+      // Make `next` an empty block leading to the next header.
+      continue;
+    }
+    // Innermost loop body, using the value.
+    HInstruction* add = new (GetAllocator()) HAdd(DataType::Type::kInt32, value, value);
+    next->AddInstruction(add);
+    next->AddInstruction(new (GetAllocator()) HGoto());
+    next->AddSuccessor(header);
+  }
+
+  graph_->BuildDominatorTree();
+  SsaLivenessAnalysis ssa_analysis(graph_, codegen_.get(), GetScopedAllocator());
+  ssa_analysis.Analyze();
+
+  size_t number_of_blocks_in_loops = 0u;
+  for (HBasicBlock* current : graph_->GetBlocks()) {
+    if (current != nullptr && current->IsInLoop()) {
+      ++number_of_blocks_in_loops;
+      EXPECT_TRUE(ssa_analysis.GetLiveInSet(*current)->IsBitSet(value->GetSsaIndex()))
+          << current->GetBlockId();
+    }
+  }
+  EXPECT_LE(3u * kDepth - 1u, number_of_blocks_in_loops);
+  CheckLivenessFixedPoint(ssa_analysis);
+}
+
 }  // namespace art
@@ -838,7 +838,7 @@ bool SuperblockCloner::IsSubgraphClonable() const {
 }
 
 bool SuperblockCloner::IsFastCase() const {
-  // Check that loop unrolling/loop peeling is being conducted.
+  // Check that loop unrolling/loop peeling/loop versioning is being conducted.
   // Check that all the basic blocks belong to the same loop.
   bool flag = false;
   HLoopInformation* common_loop_info = nullptr;
@@ -854,7 +854,7 @@ bool SuperblockCloner::IsFastCase() const {
     }
   }
 
-  // Check that orig_bb_set_ corresponds to loop peeling/unrolling.
+  // Check that orig_bb_set_ corresponds to loop peeling/unrolling/versioning.
   if (common_loop_info == nullptr || !orig_bb_set_.SameBitsSet(&common_loop_info->GetBlocks())) {
     return false;
   }
@@ -864,6 +864,13 @@ bool SuperblockCloner::IsFastCase() const {
   HEdgeSet remap_copy_internal(graph_->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
   HEdgeSet remap_incoming(graph_->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
 
+  // Check whether remapping info corresponds to loop versioning. This is checked first as the
+  // loop header has more than one incoming edge at this point and has no valid preheader.
+  if (remap_orig_internal_->empty() && remap_copy_internal_->empty()) {
+    CollectRemappingInfoForVersioning(common_loop_info, &remap_incoming);
+    return !remap_incoming.empty() && EdgeHashSetsEqual(&remap_incoming, remap_incoming_);
+  }
+
 
   // Check whether remapping info corresponds to loop unrolling.
   CollectRemappingInfoForPeelUnroll(/* to_unroll*/ true,
@@ -1047,6 +1054,20 @@ void CollectRemappingInfoForPeelUnroll(bool to_unroll,
   }
 }
 
+void CollectRemappingInfoForVersioning(HLoopInformation* loop_info,
+                                       HEdgeSet* remap_incoming) {
+  DCHECK(loop_info != nullptr);
+  HBasicBlock* loop_header = loop_info->GetHeader();
+  // The first predecessor is the entry of the original loop; dominance information is not
+  // valid at this point so GetPreHeader() can't be used.
+  HBasicBlock* orig_entry = loop_header->GetPredecessors()[0];
+  for (HBasicBlock* pred : loop_header->GetPredecessors()) {
+    if (pred != orig_entry && !loop_info->IsBackEdge(*pred)) {
+      remap_incoming->insert(HEdge(pred, loop_header));
+    }
+  }
+}
+
 bool IsSubgraphConnected(SuperblockCloner::HBasicBlockSet* work_set, HGraph* graph) {
   ArenaVector<HBasicBlock*> entry_blocks(
       graph->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
@@ -1132,6 +1153,80 @@ HBasicBlock* PeelUnrollHelper::DoPeelUnrollImpl(bool to_unroll) {
   return loop_header;
 }
 
+HBasicBlock* PeelUnrollHelper::DoVersioning(HInstruction* condition) {
+  // For now do versioning only for natural loops.
+  DCHECK(!loop_info_->IsIrreducible());
+
+  HBasicBlock* loop_header = loop_info_->GetHeader();
+  // Check that loop info is up-to-date.
+  DCHECK(loop_info_ == loop_header->GetLoopInformation());
+  HBasicBlock* preheader = loop_info_->GetPreHeader();
+  DCHECK(preheader->GetLastInstruction()->IsGoto());
+  DCHECK(!loop_info_->Contains(*condition->GetBlock()));
+  HGraph* graph = loop_header->GetGraph();
+  ArenaAllocator* allocator = graph->GetAllocator();
+
+  if (kSuperblockClonerLogging) {
+    std::cout << "Method: " << graph->PrettyMethod() << std::endl;
+    std::cout << "Scalar loop versioning was applied to the loop <" << loop_header->GetBlockId()
+              << ">." << std::endl;
+  }
+
+  // Make the preheader branch on 'condition' to two separate entries of the loop header; the
+  // second one will be remapped to the copy of the loop:
+  //
+  //      preheader                   preheader(if condition)
+  //          |                        /              \
+  //          v          =====>   orig_entry      copy_entry
+  //       header                      \              /
+  //                                       header
+  //
+  // The new blocks belong to the loops the preheader belongs to.
+  HBasicBlock* orig_entry = graph->SplitEdge(preheader, loop_header);
+  orig_entry->AddInstruction(new (allocator) HGoto(loop_header->GetDexPc()));
+  HBasicBlock* copy_entry = new (allocator) HBasicBlock(graph, loop_header->GetDexPc());
+  graph->AddBlock(copy_entry);
+  copy_entry->AddInstruction(new (allocator) HGoto(loop_header->GetDexPc()));
+
+  HInstruction* preheader_goto = preheader->GetLastInstruction();
+  preheader->RemoveInstruction(preheader_goto);
+  preheader->AddInstruction(new (allocator) HIf(condition, preheader_goto->GetDexPc()));
+  preheader->AddSuccessor(copy_entry);
+  copy_entry->AddSuccessor(loop_header);
+
+  size_t orig_entry_index = loop_header->GetPredecessorIndexOf(orig_entry);
+  for (HInstructionIterator it(loop_header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    phi->AddInput(phi->InputAt(orig_entry_index));
+  }
+
+  HLoopInformation* outer_loop_info = preheader->GetLoopInformation();
+  for (HBasicBlock* entry : {orig_entry, copy_entry}) {
+    entry->SetLoopInformation(outer_loop_info);
+    for (HLoopInformationOutwardIterator it(*preheader); !it.Done(); it.Advance()) {
+      it.Current()->Add(entry);
+    }
+  }
+
+  HEdgeSet remap_orig_internal(graph->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
+  HEdgeSet remap_copy_internal(graph->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
+  HEdgeSet remap_incoming(graph->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
+
+  CollectRemappingInfoForVersioning(loop_info_, &remap_incoming);
+  DCHECK_EQ(remap_incoming.size(), 1u);
+
+  cloner_.SetSuccessorRemappingInfo(&remap_orig_internal, &remap_copy_internal, &remap_incoming);
+  cloner_.Run();
+  cloner_.CleanUp();
+
+  // Check that loop info is preserved.
+  DCHECK(loop_info_ == loop_header->GetLoopInformation());
+
+  HBasicBlock* copy_header = cloner_.GetBlockCopy(loop_header);
+  DCHECK(copy_header->IsLoopHeader());
+  return copy_header;
+}
+
 PeelUnrollSimpleHelper::PeelUnrollSimpleHelper(HLoopInformation* info,
                                                InductionVarRange* induction_range)
   : bb_map_(std::less<HBasicBlock*>(),
@@ -89,7 +89,8 @@ inline bool IsEdgeValid(HEdge edge, HGraph* graph) {
 // fine grain manipulation with IR; data flow and graph properties are resolved/adjusted
 // automatically. The clone transformation is defined by specifying a set of basic blocks to copy
 // and a set of rules how to treat edges, remap their successors. By using this approach such
-// optimizations as Branch Target Expansion, Loop Peeling, Loop Unrolling can be implemented.
+// optimizations as Branch Target Expansion, Loop Peeling, Loop Unrolling, Loop Versioning can be
+// implemented.
 //
 // The idea of the transformation is based on "Superblock cloning" technique described in the book
 // "Engineering a Compiler. Second Edition", Keith D. Cooper, Linda Torczon, Rice University
@@ -161,7 +162,7 @@ class SuperblockCloner : public ValueObject {
   //
   // TODO: formally describe the criteria.
   //
-  // Loop peeling and unrolling satisfy the criteria.
+  // Loop peeling, unrolling and versioning satisfy the criteria.
   bool IsFastCase() const;
 
   // Runs the copy algorithm according to the description.
@@ -362,7 +363,7 @@ class SuperblockCloner : public ValueObject {
   DISALLOW_COPY_AND_ASSIGN(SuperblockCloner);
 };
 
-// Helper class to perform loop peeling/unrolling.
+// Helper class to perform loop peeling/unrolling/versioning.
 //
 // This helper should be used when correspondence map between original and copied
 // basic blocks/instructions are demanded.
@@ -388,6 +389,12 @@ class PeelUnrollHelper : public ValueObject {
   HBasicBlock* DoUnrolling() { return DoPeelUnrollImpl(/* to_unroll= */ true); }
   HLoopInformation* GetRegionToBeAdjusted() const { return cloner_.GetRegionToBeAdjusted(); }
 
+  // Applies loop versioning for the loop specified by 'loop_info': the loop is copied and the
+  // preheader is made to branch on 'condition' - to the original loop if it is true and to the
+  // copy otherwise. 'condition' must be defined outside of the loop. Returns the header of
+  // the copy loop.
+  HBasicBlock* DoVersioning(HInstruction* condition);
+
  protected:
   // Applies loop peeling/unrolling for the loop specified by 'loop_info'.
   //
@@ -411,6 +418,7 @@ class PeelUnrollSimpleHelper : public ValueObject {
   bool IsLoopClonable() const { return helper_.IsLoopClonable(); }
   HBasicBlock* DoPeeling() { return helper_.DoPeeling(); }
   HBasicBlock* DoUnrolling() { return helper_.DoUnrolling(); }
+  HBasicBlock* DoVersioning(HInstruction* condition) { return helper_.DoVersioning(condition); }
   HLoopInformation* GetRegionToBeAdjusted() const { return helper_.GetRegionToBeAdjusted(); }
 
   const SuperblockCloner::HBasicBlockMap* GetBasicBlockMap() const { return &bb_map_; }
@@ -431,6 +439,11 @@ void CollectRemappingInfoForPeelUnroll(bool to_unroll,
                                        SuperblockCloner::HEdgeSet* remap_copy_internal,
                                        SuperblockCloner::HEdgeSet* remap_incoming);
 
+// Collects edge remapping info for loop versioning for the loop specified by loop info: the
+// loop header entries other than the preheader are remapped to the copy of the loop.
+void CollectRemappingInfoForVersioning(HLoopInformation* loop_info,
+                                       SuperblockCloner::HEdgeSet* remap_incoming);
+
 // Returns whether blocks from 'work_set' are reachable from the rest of the graph.
 //
 // Returns whether such a set 'outer_entries' of basic blocks exists that:
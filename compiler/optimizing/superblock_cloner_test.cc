@@ -408,6 +408,75 @@ TEST_F(SuperblockClonerTest, LoopUnrolling) {
   EXPECT_EQ(loop_info->GetBackEdges()[0], bb_map.Get(loop_body));
 }
 
+// Tests SuperblockCloner for loop versioning case.
+//
+// Control Flow of the example (ignoring critical edges splitting).
+//
+//       Before                    After
+//
+//         |B|                      |B|
+//          |                        |
+//          v                        v
+//         |1|                      |1|
+//          |                      /   \
+//          v                     v     v
+//         |2|<-\               |2|<-\ |2A|<-\
+//         / \  /               / \  /  / \   /
+//        v   v/               |  |3|  |  |3A|
+//       |4|  |3|               \      /
+//        |                      v    v
+//        v                       |4|
+//       |E|                       |
+//                                 v
+//                                |E|
+TEST_F(SuperblockClonerTest, LoopVersioning) {
+  HBasicBlock* header = nullptr;
+  HBasicBlock* loop_body = nullptr;
+
+  InitGraph();
+  CreateBasicLoopControlFlow(entry_block_, return_block_, &header, &loop_body);
+  CreateBasicLoopDataFlow(header, loop_body);
+  HBasicBlock* preheader = header->GetPredecessors()[0];
+  HInstruction* condition =
+      new (GetAllocator()) HEqual(parameters_[0], graph_->GetIntConstant(0));
+  preheader->AddInstruction(condition);
+  preheader->AddInstruction(new (GetAllocator()) HGoto());
+  graph_->BuildDominatorTree();
+  EXPECT_TRUE(CheckGraph());
+
+  HBasicBlockMap bb_map(
+      std::less<HBasicBlock*>(), graph_->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
+  HInstructionMap hir_map(
+      std::less<HInstruction*>(), graph_->GetAllocator()->Adapter(kArenaAllocSuperblockCloner));
+
+  HLoopInformation* loop_info = header->GetLoopInformation();
+  EXPECT_EQ(loop_info->GetPreHeader(), preheader);
+  PeelUnrollHelper helper(loop_info, &bb_map, &hir_map, /* induction_range= */ nullptr);
+  EXPECT_TRUE(helper.IsLoopClonable());
+  HBasicBlock* copy_header = helper.DoVersioning(condition);
+
+  EXPECT_TRUE(CheckGraph());
+
+  // Check that the preheader branches to both loops.
+  HIf* hif = preheader->GetLastInstruction()->AsIf();
+  ASSERT_TRUE(hif != nullptr);
+  EXPECT_EQ(hif->InputAt(0), condition);
+  EXPECT_EQ(hif->IfTrueSuccessor()->GetSingleSuccessor(), header);
+  EXPECT_EQ(hif->IfFalseSuccessor()->GetSingleSuccessor(), copy_header);
+
+  // Check loop structure.
+  EXPECT_EQ(bb_map.Get(header), copy_header);
+  EXPECT_EQ(loop_info, header->GetLoopInformation());
+  EXPECT_EQ(loop_info->GetBackEdges().size(), 1u);
+  EXPECT_EQ(loop_info->GetBackEdges()[0], loop_body);
+  HLoopInformation* copy_loop_info = copy_header->GetLoopInformation();
+  ASSERT_TRUE(copy_loop_info != nullptr);
+  EXPECT_NE(copy_loop_info, loop_info);
+  EXPECT_EQ(copy_loop_info->GetHeader(), copy_header);
+  EXPECT_EQ(copy_loop_info->GetBackEdges().size(), 1u);
+  EXPECT_EQ(copy_loop_info->GetBackEdges()[0], bb_map.Get(loop_body));
+}
+
 // Checks that loop unrolling works fine for a loop with multiple back edges. Tests that after
 // the transformation the loop has a single preheader.
 TEST_F(SuperblockClonerTest, LoopPeelingMultipleBackEdges) {
@@ -609,6 +609,39 @@ class AssemblerTest : public testing::Test {
                                                             fmt);
   }
 
+  std::string RepeatVF(void (Ass::*f)(VecReg, FPReg), const std::string& fmt) {
+    return RepeatTemplatedRegisters<VecReg, FPReg>(f,
+                                                   GetVectorRegisters(),
+                                                   GetFPRegisters(),
+                                                   &AssemblerTest::GetVecRegName,
+                                                   &AssemblerTest::GetFPRegName,
+                                                   fmt);
+  }
+
+  std::string RepeatVVI(void (Ass::*f)(VecReg, VecReg, const Imm&),
+                        size_t imm_bytes,
+                        const std::string& fmt) {
+    return RepeatTemplatedRegistersImm<VecReg, VecReg>(f,
+                                                       GetVectorRegisters(),
+                                                       GetVectorRegisters(),
+                                                       &AssemblerTest::GetVecRegName,
+                                                       &AssemblerTest::GetVecRegName,
+                                                       imm_bytes,
+                                                       fmt);
+  }
+
+  std::string RepeatFVI(void (Ass::*f)(FPReg, VecReg, const Imm&),
+                        size_t imm_bytes,
+                        const std::string& fmt) {
+    return RepeatTemplatedRegistersImm<FPReg, VecReg>(f,
+                                                      GetFPRegisters(),
+                                                      GetVectorRegisters(),
+                                                      &AssemblerTest::GetFPRegName,
+                                                      &AssemblerTest::GetVecRegName,
+                                                      imm_bytes,
+                                                      fmt);
+  }
+
   std::string RepeatVR(void (Ass::*f)(VecReg, Reg), const std::string& fmt) {
     return RepeatTemplatedRegisters<VecReg, Reg>(
         f,
@@ -1030,6 +1063,17 @@ class AssemblerTest : public testing::Test {
         fmt);
   }
 
+  // Repeats over vector registers and addresses provided by fixture.
+  std::string RepeatVA(void (Ass::*f)(VecReg, const Addr&), const std::string& fmt) {
+    return RepeatTemplatedRegMem<VecReg, Addr>(
+        f,
+        GetVectorRegisters(),
+        GetAddresses(),
+        &AssemblerTest::GetVecRegName,
+        &AssemblerTest::GetAddrName,
+        fmt);
+  }
+
   // Repeats over addresses and registers provided by fixture.
   std::string RepeatAR(void (Ass::*f)(const Addr&, Reg), const std::string& fmt) {
     return RepeatAR(f, GetAddresses(), fmt);
@@ -1106,6 +1150,17 @@ class AssemblerTest : public testing::Test {
         fmt);
   }
 
+  // Repeats over addresses and vector registers provided by fixture.
+  std::string RepeatAV(void (Ass::*f)(const Addr&, VecReg), const std::string& fmt) {
+    return RepeatTemplatedMemReg<Addr, VecReg>(
+        f,
+        GetAddresses(),
+        GetVectorRegisters(),
+        &AssemblerTest::GetAddrName,
+        &AssemblerTest::GetVecRegName,
+        fmt);
+  }
+
   // Repeats over addresses and fp-registers provided by fixture.
   std::string RepeatAF(void (Ass::*f)(const Addr&, FPReg), const std::string& fmt) {
     return RepeatAF(f, GetAddresses(), fmt);
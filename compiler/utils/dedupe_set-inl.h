@@ -74,6 +74,7 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
     auto it = keys_.find(hashed_in_key);
     if (it != keys_.end()) {
       DCHECK(it->Key() != nullptr);
+      it->IncrementReferenceCount();
       return it->Key();
     }
     const StoreKey* store_key = alloc_.Copy(in_key);
@@ -81,6 +82,17 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
     return store_key;
   }
 
+  void Release(Thread* self, size_t hash, const InKey& in_key) REQUIRES(!lock_) {
+    MutexLock lock(self, lock_);
+    HashedKey<InKey> hashed_in_key(hash, &in_key);
+    auto it = keys_.find(hashed_in_key);
+    DCHECK(it != keys_.end());
+    if (it->DecrementReferenceCount() == 0u) {
+      alloc_.Destroy(it->Key());
+      keys_.erase(it);
+    }
+  }
+
   void UpdateStats(Thread* self, Stats* global_stats) REQUIRES(!lock_) {
     // HashSet<> doesn't keep entries ordered by hash, so we actually allocate memory
     // for bookkeeping while collecting the stats.
@@ -113,8 +125,8 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   template <typename T>
   class HashedKey {
    public:
-    HashedKey() : hash_(0u), key_(nullptr) { }
-    HashedKey(size_t hash, const T* key) : hash_(hash), key_(key) { }
+    HashedKey() : hash_(0u), key_(nullptr), reference_count_(0u) { }
+    HashedKey(size_t hash, const T* key) : hash_(hash), key_(key), reference_count_(1u) { }
 
     size_t Hash() const {
       return hash_;
@@ -132,9 +144,20 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
       key_ = nullptr;
     }
 
+    void IncrementReferenceCount() {
+      ++reference_count_;
+    }
+
+    size_t DecrementReferenceCount() {
+      DCHECK_NE(reference_count_, 0u);
+      return --reference_count_;
+    }
+
    private:
     size_t hash_;
     const T* key_;
+    // The number of Add() calls that returned the key, less the Release() calls.
+    size_t reference_count_;
   };
 
   class ShardEmptyFn {
@@ -202,6 +225,20 @@ const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::A
   return shards_[shard_bin]->Add(self, shard_hash, key);
 }
 
+template <typename InKey,
+          typename StoreKey,
+          typename Alloc,
+          typename HashType,
+          typename HashFunc,
+          HashType kShard>
+void DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Release(
+    Thread* self, const InKey& key) {
+  HashType raw_hash = HashFunc()(key);
+  HashType shard_hash = raw_hash / kShard;
+  HashType shard_bin = raw_hash % kShard;
+  shards_[shard_bin]->Release(self, shard_hash, key);
+}
+
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
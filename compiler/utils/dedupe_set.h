@@ -41,6 +41,10 @@ class DedupeSet {
   // Add a new key to the dedupe set if not present. Return the equivalent deduplicated stored key.
   const StoreKey* Add(Thread* self, const InKey& key);
 
+  // Drop a reference obtained from Add() for a key equal to `key`. The stored key is destroyed
+  // when the last reference is released. Keys that are never released live as long as the set.
+  void Release(Thread* self, const InKey& key);
+
   DedupeSet(const char* set_name, const Alloc& alloc);
 
   ~DedupeSet();
@@ -88,4 +88,55 @@ TEST(DedupeSetTest, Test) {
   }
 }
 
+class DedupeSetTestCountingAlloc : public DedupeSetTestAlloc {
+ public:
+  explicit DedupeSetTestCountingAlloc(size_t* num_destroyed) : num_destroyed_(num_destroyed) {}
+
+  void Destroy(const std::vector<uint8_t>* key) {
+    ++*num_destroyed_;
+    DedupeSetTestAlloc::Destroy(key);
+  }
+
+ private:
+  size_t* num_destroyed_;
+};
+
+TEST(DedupeSetTest, Release) {
+  Thread* self = Thread::Current();
+  size_t num_destroyed = 0u;
+  {
+    DedupeSetTestCountingAlloc alloc(&num_destroyed);
+    DedupeSet<ArrayRef<const uint8_t>,
+              std::vector<uint8_t>,
+              DedupeSetTestCountingAlloc,
+              size_t,
+              DedupeSetTestHashFunc> deduplicator("test", alloc);
+    uint8_t raw_test1[] = { 10u, 20u, 30u, 45u };
+    ArrayRef<const uint8_t> test1(raw_test1);
+    uint8_t raw_test2[] = { 10u, 22u, 30u, 47u };
+    ArrayRef<const uint8_t> test2(raw_test2);
+    const std::vector<uint8_t>* array1 = deduplicator.Add(self, test1);
+    ASSERT_EQ(array1, deduplicator.Add(self, test1));
+    const std::vector<uint8_t>* array2 = deduplicator.Add(self, test2);
+    ASSERT_NE(array2, array1);
+
+    // The key is kept until every reference obtained from Add() is released.
+    deduplicator.Release(self, test1);
+    ASSERT_EQ(num_destroyed, 0u);
+    ASSERT_EQ(array1, deduplicator.Add(self, test1));
+    deduplicator.Release(self, test1);
+    ASSERT_EQ(num_destroyed, 0u);
+    deduplicator.Release(self, test1);
+    ASSERT_EQ(num_destroyed, 1u);
+
+    // A released key can be added again.
+    const std::vector<uint8_t>* array3 = deduplicator.Add(self, test1);
+    ASSERT_NE(array3, nullptr);
+    ASSERT_TRUE(std::equal(test1.begin(), test1.end(), array3->begin()));
+    ASSERT_EQ(num_destroyed, 1u);
+  }
+  // Keys that were not released are destroyed with the set.
+  ASSERT_EQ(num_destroyed, 3u);
+}
+
 }  // namespace art
@@ -32,6 +32,10 @@ std::ostream& operator<<(std::ostream& os, const XmmRegister& reg) {
   return os << reg.AsFloatRegister();
 }
 
+std::ostream& operator<<(std::ostream& os, const YmmRegister& reg) {
+  return os << "ymm" << static_cast<int>(reg.AsFloatRegister());
+}
+
 std::ostream& operator<<(std::ostream& os, const X87Register& reg) {
   return os << "ST" << static_cast<int>(reg);
 }
@@ -3435,6 +3439,15 @@ void X86_64Assembler::pcmpeqq(XmmRegister dst, XmmRegister src) {
   EmitXmmRegisterOperand(dst.LowBits(), src);
 }
 
+void X86_64Assembler::pmovmskb(CpuRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0xD7);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
 void X86_64Assembler::pcmpgtb(XmmRegister dst, XmmRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -3691,6 +3704,578 @@ void X86_64Assembler::psrldq(XmmRegister reg, const Immediate& shift_count) {
   EmitUint8(shift_count.value());
 }
 
+void X86_64Assembler::vmovaps(YmmRegister dst, YmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x28, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vmovups(YmmRegister dst, const Address& src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x10, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src);
+}
+
+void X86_64Assembler::vmovups(const Address& dst, YmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x11, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        src.AsFloatRegister(), /*vvvv=*/ -1, dst);
+}
+
+void X86_64Assembler::vmovupd(YmmRegister dst, const Address& src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x10, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src);
+}
+
+void X86_64Assembler::vmovupd(const Address& dst, YmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x11, SET_VEX_M_0F, SET_VEX_PP_66,
+                        src.AsFloatRegister(), /*vvvv=*/ -1, dst);
+}
+
+void X86_64Assembler::vmovdqu(YmmRegister dst, const Address& src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x6F, SET_VEX_M_0F, SET_VEX_PP_F3,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src);
+}
+
+void X86_64Assembler::vmovdqu(const Address& dst, YmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x7F, SET_VEX_M_0F, SET_VEX_PP_F3,
+                        src.AsFloatRegister(), /*vvvv=*/ -1, dst);
+}
+
+void X86_64Assembler::vpbroadcastb(YmmRegister dst, XmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x78, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpbroadcastw(YmmRegister dst, XmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x79, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpbroadcastd(YmmRegister dst, XmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x58, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpbroadcastq(YmmRegister dst, XmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x59, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vbroadcastss(YmmRegister dst, XmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x18, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vbroadcastsd(YmmRegister dst, XmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x19, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vextracti128(XmmRegister dst, YmmRegister src, const Immediate& imm) {
+  DCHECK(has_AVX2_);
+  DCHECK(imm.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x39, SET_VEX_M_0F_3A, SET_VEX_PP_66,
+                        src.AsFloatRegister(), /*vvvv=*/ -1, dst.AsFloatRegister());
+  EmitUint8(imm.value());
+}
+
+void X86_64Assembler::vpaddb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xFC, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xFD, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xFE, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddq(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xD4, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xF8, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xF9, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xFA, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubq(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xFB, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xEC, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xED, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddusb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xDC, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpaddusw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xDD, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xE8, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xE9, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubusb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xD8, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsubusw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xD9, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpavgb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xE0, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpavgw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xE3, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmullw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xD5, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmulld(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x40, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaddwd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xF5, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x38, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xEA, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminsd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x39, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminub(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xDA, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminuw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x3A, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpminud(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x3B, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxsb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x3C, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxsw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xEE, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxsd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x3D, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxub(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xDE, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxuw(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x3E, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpmaxud(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x3F, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpand(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xDB, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpandn(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xDF, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpor(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xEB, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpxor(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0xEF, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpcmpeqb(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x74, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vaddps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x58, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vaddpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x58, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vsubps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x5C, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vsubpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x5C, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vmulps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x59, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vmulpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x59, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vdivps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x5E, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vdivpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x5E, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x54, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x54, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandnps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x55, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vandnpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x55, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vorps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x56, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x56, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vxorps(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x57, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vxorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x57, SET_VEX_M_0F, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), src1.AsFloatRegister(), src2.AsFloatRegister());
+}
+
+void X86_64Assembler::vpabsd(YmmRegister dst, YmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x1E, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vcvtdq2ps(YmmRegister dst, YmmRegister src) {
+  DCHECK(has_AVX2_);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x5B, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                        dst.AsFloatRegister(), /*vvvv=*/ -1, src.AsFloatRegister());
+}
+
+void X86_64Assembler::vpsllw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x71, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 6, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpslld(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x72, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 6, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsllq(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x73, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 6, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsraw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x71, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 4, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrad(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x72, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 4, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlw(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x71, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 2, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrld(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x72, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 2, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlq(YmmRegister dst, YmmRegister src, const Immediate& shift_count) {
+  DCHECK(has_AVX2_);
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Instruction(0x73, SET_VEX_M_0F, SET_VEX_PP_66,
+                        /*reg=*/ 2, dst.AsFloatRegister(), src.AsFloatRegister());
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vzeroupper() {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0xC5);
+  EmitUint8(0xF8);
+  EmitUint8(0x77);
+}
+
 
 void X86_64Assembler::fldl(const Address& src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
@@ -5426,6 +6011,42 @@ size_t ConstantArea::AddFloat(float v) {
   return AddInt32(bit_cast<int32_t, float>(v));
 }
 
+void X86_64Assembler::EmitVex256Instruction(uint8_t opcode,
+                                            int vex_m,
+                                            int vex_pp,
+                                            int reg,
+                                            int vvvv,
+                                            int rm) {
+  EmitVex256Prefix(reg > 7, /*x=*/ false, rm > 7, vvvv, vex_m, vex_pp);
+  EmitUint8(opcode);
+  EmitRegisterOperand(reg & 7, rm & 7);
+}
+
+void X86_64Assembler::EmitVex256Instruction(uint8_t opcode,
+                                            int vex_m,
+                                            int vex_pp,
+                                            int reg,
+                                            int vvvv,
+                                            const Address& address) {
+  uint8_t rex = address.rex();
+  EmitVex256Prefix(reg > 7, (rex & GET_REX_X) != 0, (rex & GET_REX_B) != 0, vvvv, vex_m, vex_pp);
+  EmitUint8(opcode);
+  EmitOperand(reg & 7, address);
+}
+
+void X86_64Assembler::EmitVex256Prefix(bool r, bool x, bool b, int vvvv, int vex_m, int vex_pp) {
+  // The register specifiers are stored inverted; VEX.vvvv = 1111b encodes no register.
+  uint8_t inverted_vvvv = static_cast<uint8_t>(vvvv < 0 ? 0x0F : (~vvvv & 0x0F));
+  if (!x && !b && vex_m == SET_VEX_M_0F) {
+    EmitUint8(EmitVexPrefixByteZero(/*is_twobyte_form=*/ true));
+    EmitUint8((r ? 0 : SET_VEX_R) | (inverted_vvvv << 3) | SET_VEX_L_256 | vex_pp);
+  } else {
+    EmitUint8(EmitVexPrefixByteZero(/*is_twobyte_form=*/ false));
+    EmitUint8(EmitVexPrefixByteOne(r, x, b, vex_m));
+    EmitUint8((inverted_vvvv << 3) | SET_VEX_L_256 | vex_pp);  // VEX.W = 0.
+  }
+}
+
 uint8_t X86_64Assembler::EmitVexPrefixByteZero(bool is_twobyte_form) {
   // Vex Byte 0,
   // Bits [7:0] must contain the value 11000101b (0xC5) for 2-byte Vex
@@ -5481,7 +6102,7 @@ uint8_t X86_64Assembler::EmitVexPrefixByteOne(bool R,
     vex_prefix |= 0x78;
   } else if (operand.IsXmmRegister()) {
     XmmRegister vvvv = operand.AsXmmRegister();
-    int inverted_reg = 15 - static_cast<int>(vvvv.AsFloatRegister());
+    int inverted_reg = 15 - vvvv.AsFloatRegister();
     uint8_t reg = static_cast<uint8_t>(inverted_reg);
     vex_prefix |= ((reg & 0x0F) << 3);
   } else if (operand.IsCpuRegister()) {
@@ -5513,7 +6134,7 @@ uint8_t X86_64Assembler::EmitVexPrefixByteTwo(bool W,
   // Bits[6:3] - 'vvvv' the source or dest register specifier
   if (operand.IsXmmRegister()) {
     XmmRegister vvvv = operand.AsXmmRegister();
-    int inverted_reg = 15 - static_cast<int>(vvvv.AsFloatRegister());
+    int inverted_reg = 15 - vvvv.AsFloatRegister();
     uint8_t reg = static_cast<uint8_t>(inverted_reg);
     vex_prefix |= ((reg & 0x0F) << 3);
   } else if (operand.IsCpuRegister()) {
@@ -649,6 +649,8 @@ class X86_64Assembler final : public Assembler {
   void pcmpeqd(XmmRegister dst, XmmRegister src);
   void pcmpeqq(XmmRegister dst, XmmRegister src);
 
+  void pmovmskb(CpuRegister dst, XmmRegister src);
+
   void pcmpgtb(XmmRegister dst, XmmRegister src);
   void pcmpgtw(XmmRegister dst, XmmRegister src);
   void pcmpgtd(XmmRegister dst, XmmRegister src);
@@ -681,6 +683,96 @@ class X86_64Assembler final : public Assembler {
   void psrlq(XmmRegister reg, const Immediate& shift_count);
   void psrldq(XmmRegister reg, const Immediate& shift_count);
 
+  // AVX2 instructions operating on the full 256-bit YMM registers (VEX.256 encoding).
+  void vmovaps(YmmRegister dst, YmmRegister src);
+  void vmovups(YmmRegister dst, const Address& src);
+  void vmovups(const Address& dst, YmmRegister src);
+  void vmovupd(YmmRegister dst, const Address& src);
+  void vmovupd(const Address& dst, YmmRegister src);
+  void vmovdqu(YmmRegister dst, const Address& src);
+  void vmovdqu(const Address& dst, YmmRegister src);
+
+  void vpbroadcastb(YmmRegister dst, XmmRegister src);
+  void vpbroadcastw(YmmRegister dst, XmmRegister src);
+  void vpbroadcastd(YmmRegister dst, XmmRegister src);
+  void vpbroadcastq(YmmRegister dst, XmmRegister src);
+  void vbroadcastss(YmmRegister dst, XmmRegister src);
+  void vbroadcastsd(YmmRegister dst, XmmRegister src);
+  void vextracti128(XmmRegister dst, YmmRegister src, const Immediate& imm);
+
+  void vpaddb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddq(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubq(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddsb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddsw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddusb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpaddusw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubsb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubsw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubusb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpsubusw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpavgb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpavgw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmullw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmulld(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaddwd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+
+  void vpminsb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpminsw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpminsd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpminub(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpminuw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpminud(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaxsb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaxsw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaxsd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaxub(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaxuw(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpmaxud(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+
+  void vpand(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpandn(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpor(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpxor(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vpcmpeqb(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+
+  void vaddps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vaddpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vsubps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vsubpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vmulps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vmulpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vdivps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vdivpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandnps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vandnpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vorps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vxorps(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+  void vxorpd(YmmRegister dst, YmmRegister src1, YmmRegister src2);
+
+  void vpabsd(YmmRegister dst, YmmRegister src);
+  void vcvtdq2ps(YmmRegister dst, YmmRegister src);
+
+  void vpsllw(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpslld(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsllq(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsraw(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrad(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrlw(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrld(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+  void vpsrlq(YmmRegister dst, YmmRegister src, const Immediate& shift_count);
+
+  // Clears the upper halves of all YMM registers, avoiding the AVX to SSE transition penalty.
+  void vzeroupper();
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -1018,6 +1110,21 @@ class X86_64Assembler final : public Assembler {
   void EmitOptionalByteRegNormalizingRex32(CpuRegister dst, CpuRegister src);
   void EmitOptionalByteRegNormalizingRex32(CpuRegister dst, const Operand& operand);
 
+  // Emit a VEX.256 encoded instruction. `reg` goes in ModRM.reg, `vvvv` is the extra source
+  // register (-1 if none), and the last operand goes in ModRM.rm.
+  void EmitVex256Instruction(uint8_t opcode,
+                             int vex_m,
+                             int vex_pp,
+                             int reg,
+                             int vvvv,
+                             int rm);
+  void EmitVex256Instruction(uint8_t opcode,
+                             int vex_m,
+                             int vex_pp,
+                             int reg,
+                             int vvvv,
+                             const Address& address);
+  void EmitVex256Prefix(bool r, bool x, bool b, int vvvv, int vex_m, int vex_pp);
   uint8_t EmitVexPrefixByteZero(bool is_twobyte_form);
   uint8_t EmitVexPrefixByteOne(bool R, bool X, bool B, int SET_VEX_M);
   uint8_t EmitVexPrefixByteOne(bool R,
@@ -135,13 +135,15 @@ class AssemblerX86_64Test : public AssemblerTest<x86_64::X86_64Assembler,
                                                  x86_64::Address,
                                                  x86_64::CpuRegister,
                                                  x86_64::XmmRegister,
-                                                 x86_64::Immediate> {
+                                                 x86_64::Immediate,
+                                                 x86_64::YmmRegister> {
  public:
   using Base = AssemblerTest<x86_64::X86_64Assembler,
                              x86_64::Address,
                              x86_64::CpuRegister,
                              x86_64::XmmRegister,
-                             x86_64::Immediate>;
+                             x86_64::Immediate,
+                             x86_64::YmmRegister>;
 
  protected:
   // Get the typically used name for this architecture, e.g., aarch64, x86-64, ...
@@ -289,12 +291,19 @@ class AssemblerX86_64Test : public AssemblerTest<x86_64::X86_64Assembler,
       fp_registers_.push_back(new x86_64::XmmRegister(x86_64::XMM14));
       fp_registers_.push_back(new x86_64::XmmRegister(x86_64::XMM15));
     }
+
+    if (vec_registers_.size() == 0) {
+      for (int i = 0; i < 16; ++i) {
+        vec_registers_.push_back(new x86_64::YmmRegister(i));
+      }
+    }
   }
 
   void TearDown() override {
     AssemblerTest::TearDown();
     STLDeleteElements(&registers_);
     STLDeleteElements(&fp_registers_);
+    STLDeleteElements(&vec_registers_);
   }
 
   std::vector<x86_64::Address> GetAddresses() override {
@@ -309,6 +318,10 @@ class AssemblerX86_64Test : public AssemblerTest<x86_64::X86_64Assembler,
     return fp_registers_;
   }
 
+  std::vector<x86_64::YmmRegister*> GetVectorRegisters() override {
+    return vec_registers_;
+  }
+
   x86_64::Immediate CreateImmediate(int64_t imm_value) override {
     return x86_64::Immediate(imm_value);
   }
@@ -337,6 +350,7 @@ class AssemblerX86_64Test : public AssemblerTest<x86_64::X86_64Assembler,
   std::map<x86_64::CpuRegister, std::string, X86_64CpuRegisterCompare> tertiary_register_names_;
   std::map<x86_64::CpuRegister, std::string, X86_64CpuRegisterCompare> quaternary_register_names_;
   std::vector<x86_64::XmmRegister*> fp_registers_;
+  std::vector<x86_64::YmmRegister*> vec_registers_;
 };
 
 class AssemblerX86_64AVXTest : public AssemblerX86_64Test {
@@ -1175,6 +1189,411 @@ TEST_F(AssemblerX86_64AVXTest, MovupsLoad) {
   DriverStr(RepeatFA(&x86_64::X86_64Assembler::movups, "vmovups {mem}, %{reg}"), "avx_movups_l");
 }
 
+TEST_F(AssemblerX86_64AVXTest, VmovapsYmm) {
+  DriverStr(RepeatVV(&x86_64::X86_64Assembler::vmovaps, "vmovaps %{reg2}, %{reg1}"), "vmovaps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovupsYmmLoad) {
+  DriverStr(RepeatVA(&x86_64::X86_64Assembler::vmovups, "vmovups {mem}, %{reg}"), "vmovups_ymm_l");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovupsYmmStore) {
+  DriverStr(RepeatAV(&x86_64::X86_64Assembler::vmovups, "vmovups %{reg}, {mem}"), "vmovups_ymm_s");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovupdYmmLoad) {
+  DriverStr(RepeatVA(&x86_64::X86_64Assembler::vmovupd, "vmovupd {mem}, %{reg}"), "vmovupd_ymm_l");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovupdYmmStore) {
+  DriverStr(RepeatAV(&x86_64::X86_64Assembler::vmovupd, "vmovupd %{reg}, {mem}"), "vmovupd_ymm_s");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovdquYmmLoad) {
+  DriverStr(RepeatVA(&x86_64::X86_64Assembler::vmovdqu, "vmovdqu {mem}, %{reg}"), "vmovdqu_ymm_l");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmovdquYmmStore) {
+  DriverStr(RepeatAV(&x86_64::X86_64Assembler::vmovdqu, "vmovdqu %{reg}, {mem}"), "vmovdqu_ymm_s");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastbYmm) {
+  DriverStr(RepeatVF(&x86_64::X86_64Assembler::vpbroadcastb, "vpbroadcastb %{reg2}, %{reg1}"),
+            "vpbroadcastb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastwYmm) {
+  DriverStr(RepeatVF(&x86_64::X86_64Assembler::vpbroadcastw, "vpbroadcastw %{reg2}, %{reg1}"),
+            "vpbroadcastw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastdYmm) {
+  DriverStr(RepeatVF(&x86_64::X86_64Assembler::vpbroadcastd, "vpbroadcastd %{reg2}, %{reg1}"),
+            "vpbroadcastd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpbroadcastqYmm) {
+  DriverStr(RepeatVF(&x86_64::X86_64Assembler::vpbroadcastq, "vpbroadcastq %{reg2}, %{reg1}"),
+            "vpbroadcastq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VbroadcastssYmm) {
+  DriverStr(RepeatVF(&x86_64::X86_64Assembler::vbroadcastss, "vbroadcastss %{reg2}, %{reg1}"),
+            "vbroadcastss_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VbroadcastsdYmm) {
+  DriverStr(RepeatVF(&x86_64::X86_64Assembler::vbroadcastsd, "vbroadcastsd %{reg2}, %{reg1}"),
+            "vbroadcastsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Vextracti128) {
+  DriverStr(RepeatFVI(&x86_64::X86_64Assembler::vextracti128,
+                      /*imm_bytes*/ 1U,
+                      "vextracti128 ${imm}, %{reg2}, %{reg1}"),
+            "vextracti128");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddb, "vpaddb %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddwYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddw, "vpaddw %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpadddYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddd, "vpaddd %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddqYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddq, "vpaddq %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubb, "vpsubb %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubwYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubw, "vpsubw %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubd, "vpsubd %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubqYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubq, "vpsubq %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddsbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddsb, "vpaddsb %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddswYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddsw, "vpaddsw %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpaddusbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddusb, "vpaddusb %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddusb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpadduswYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpaddusw, "vpaddusw %{reg3}, %{reg2}, %{reg1}"),
+            "vpaddusw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubsbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubsb, "vpsubsb %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubswYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubsw, "vpsubsw %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubusbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubusb, "vpsubusb %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubusb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsubuswYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpsubusw, "vpsubusw %{reg3}, %{reg2}, %{reg1}"),
+            "vpsubusw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpavgbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpavgb, "vpavgb %{reg3}, %{reg2}, %{reg1}"),
+            "vpavgb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpavgwYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpavgw, "vpavgw %{reg3}, %{reg2}, %{reg1}"),
+            "vpavgw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmullwYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmullw, "vpmullw %{reg3}, %{reg2}, %{reg1}"),
+            "vpmullw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmulldYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmulld, "vpmulld %{reg3}, %{reg2}, %{reg1}"),
+            "vpmulld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaddwdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmaddwd, "vpmaddwd %{reg3}, %{reg2}, %{reg1}"),
+            "vpmaddwd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminsbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpminsb, "vpminsb %{reg3}, %{reg2}, %{reg1}"),
+            "vpminsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminswYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpminsw, "vpminsw %{reg3}, %{reg2}, %{reg1}"),
+            "vpminsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminsdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpminsd, "vpminsd %{reg3}, %{reg2}, %{reg1}"),
+            "vpminsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminubYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpminub, "vpminub %{reg3}, %{reg2}, %{reg1}"),
+            "vpminub_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminuwYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpminuw, "vpminuw %{reg3}, %{reg2}, %{reg1}"),
+            "vpminuw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpminudYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpminud, "vpminud %{reg3}, %{reg2}, %{reg1}"),
+            "vpminud_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxsbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmaxsb, "vpmaxsb %{reg3}, %{reg2}, %{reg1}"),
+            "vpmaxsb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxswYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmaxsw, "vpmaxsw %{reg3}, %{reg2}, %{reg1}"),
+            "vpmaxsw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxsdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmaxsd, "vpmaxsd %{reg3}, %{reg2}, %{reg1}"),
+            "vpmaxsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxubYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmaxub, "vpmaxub %{reg3}, %{reg2}, %{reg1}"),
+            "vpmaxub_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxuwYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmaxuw, "vpmaxuw %{reg3}, %{reg2}, %{reg1}"),
+            "vpmaxuw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpmaxudYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpmaxud, "vpmaxud %{reg3}, %{reg2}, %{reg1}"),
+            "vpmaxud_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpandYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpand, "vpand %{reg3}, %{reg2}, %{reg1}"),
+            "vpand_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpandnYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpandn, "vpandn %{reg3}, %{reg2}, %{reg1}"),
+            "vpandn_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VporYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpor, "vpor %{reg3}, %{reg2}, %{reg1}"),
+            "vpor_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpxorYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpxor, "vpxor %{reg3}, %{reg2}, %{reg1}"),
+            "vpxor_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpcmpeqbYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vpcmpeqb, "vpcmpeqb %{reg3}, %{reg2}, %{reg1}"),
+            "vpcmpeqb_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VaddpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vaddps, "vaddps %{reg3}, %{reg2}, %{reg1}"),
+            "vaddps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VaddpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vaddpd, "vaddpd %{reg3}, %{reg2}, %{reg1}"),
+            "vaddpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VsubpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vsubps, "vsubps %{reg3}, %{reg2}, %{reg1}"),
+            "vsubps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VsubpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vsubpd, "vsubpd %{reg3}, %{reg2}, %{reg1}"),
+            "vsubpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmulpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vmulps, "vmulps %{reg3}, %{reg2}, %{reg1}"),
+            "vmulps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VmulpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vmulpd, "vmulpd %{reg3}, %{reg2}, %{reg1}"),
+            "vmulpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VdivpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vdivps, "vdivps %{reg3}, %{reg2}, %{reg1}"),
+            "vdivps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VdivpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vdivpd, "vdivpd %{reg3}, %{reg2}, %{reg1}"),
+            "vdivpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vandps, "vandps %{reg3}, %{reg2}, %{reg1}"),
+            "vandps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vandpd, "vandpd %{reg3}, %{reg2}, %{reg1}"),
+            "vandpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandnpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vandnps, "vandnps %{reg3}, %{reg2}, %{reg1}"),
+            "vandnps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VandnpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vandnpd, "vandnpd %{reg3}, %{reg2}, %{reg1}"),
+            "vandnpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VorpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vorps, "vorps %{reg3}, %{reg2}, %{reg1}"),
+            "vorps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VorpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vorpd, "vorpd %{reg3}, %{reg2}, %{reg1}"),
+            "vorpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VxorpsYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vxorps, "vxorps %{reg3}, %{reg2}, %{reg1}"),
+            "vxorps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VxorpdYmm) {
+  DriverStr(RepeatVVV(&x86_64::X86_64Assembler::vxorpd, "vxorpd %{reg3}, %{reg2}, %{reg1}"),
+            "vxorpd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpabsdYmm) {
+  DriverStr(RepeatVV(&x86_64::X86_64Assembler::vpabsd, "vpabsd %{reg2}, %{reg1}"), "vpabsd_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Vcvtdq2psYmm) {
+  DriverStr(RepeatVV(&x86_64::X86_64Assembler::vcvtdq2ps, "vcvtdq2ps %{reg2}, %{reg1}"),
+            "vcvtdq2ps_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsllwYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpsllw,
+                      /*imm_bytes*/ 1U,
+                      "vpsllw ${imm}, %{reg2}, %{reg1}"),
+            "vpsllw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpslldYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpslld,
+                      /*imm_bytes*/ 1U,
+                      "vpslld ${imm}, %{reg2}, %{reg1}"),
+            "vpslld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsllqYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpsllq,
+                      /*imm_bytes*/ 1U,
+                      "vpsllq ${imm}, %{reg2}, %{reg1}"),
+            "vpsllq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrawYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpsraw,
+                      /*imm_bytes*/ 1U,
+                      "vpsraw ${imm}, %{reg2}, %{reg1}"),
+            "vpsraw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsradYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpsrad,
+                      /*imm_bytes*/ 1U,
+                      "vpsrad ${imm}, %{reg2}, %{reg1}"),
+            "vpsrad_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrlwYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpsrlw,
+                      /*imm_bytes*/ 1U,
+                      "vpsrlw ${imm}, %{reg2}, %{reg1}"),
+            "vpsrlw_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrldYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpsrld,
+                      /*imm_bytes*/ 1U,
+                      "vpsrld ${imm}, %{reg2}, %{reg1}"),
+            "vpsrld_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VpsrlqYmm) {
+  DriverStr(RepeatVVI(&x86_64::X86_64Assembler::vpsrlq,
+                      /*imm_bytes*/ 1U,
+                      "vpsrlq ${imm}, %{reg2}, %{reg1}"),
+            "vpsrlq_ymm");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Vzeroupper) {
+  GetAssembler()->vzeroupper();
+  DriverStr("vzeroupper\n", "vzeroupper");
+}
+
 TEST_F(AssemblerX86_64Test, Movss) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::movss, "movss %{reg2}, %{reg1}"), "movss");
 }
@@ -1857,6 +2276,10 @@ TEST_F(AssemblerX86_64Test, PCmpeqq) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpeqq, "pcmpeqq %{reg2}, %{reg1}"), "pcmpeqq");
 }
 
+TEST_F(AssemblerX86_64Test, PMovmskb) {
+  DriverStr(RepeatrF(&x86_64::X86_64Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"), "pmovmskb");
+}
+
 TEST_F(AssemblerX86_64Test, PCmpgtb) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpgtb, "pcmpgtb %{reg2}, %{reg1}"), "pcmpgtb");
 }
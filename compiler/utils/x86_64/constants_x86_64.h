@@ -67,6 +67,29 @@ class XmmRegister {
 };
 std::ostream& operator<<(std::ostream& os, const XmmRegister& reg);
 
+// The 256-bit AVX view of an XMM register, used by the VEX.256 encoded instructions.
+class YmmRegister {
+ public:
+  explicit constexpr YmmRegister(FloatRegister r) : reg_(r) {}
+  explicit constexpr YmmRegister(int r) : reg_(FloatRegister(r)) {}
+  explicit constexpr YmmRegister(XmmRegister r) : reg_(r.AsFloatRegister()) {}
+  constexpr FloatRegister AsFloatRegister() const {
+    return reg_;
+  }
+  constexpr XmmRegister AsXmmRegister() const {
+    return XmmRegister(reg_);
+  }
+  constexpr uint8_t LowBits() const {
+    return reg_ & 7;
+  }
+  constexpr bool NeedsRex() const {
+    return reg_ > 7;
+  }
+ private:
+  const FloatRegister reg_;
+};
+std::ostream& operator<<(std::ostream& os, const YmmRegister& reg);
+
 enum X87Register {
   ST0 = 0,
   ST1 = 1,
@@ -73,6 +73,7 @@
 #include "dex2oat_options.h"
 #include "dex2oat_return_codes.h"
 #include "dexlayout.h"
+#include "driver/compiled_method_cache.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
 #include "driver/compiler_options_map-inl.h"
@@ -284,7 +285,7 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --image-fd=<number>: same as --image but accepts a file descriptor instead.");
   UsageError("      Cannot be used together with --image.");
   UsageError("");
-  UsageError("  --image-format=(uncompressed|lz4|lz4hc):");
+  UsageError("  --image-format=(uncompressed|lz4|lz4hc|zstd):");
   UsageError("      Which format to store the image.");
   UsageError("      Example: --image-format=lz4");
   UsageError("      Default: uncompressed");
@@ -410,6 +411,24 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("  --profile-file-fd=<number>: same as --profile-file but accepts a file descriptor.");
   UsageError("      Cannot be used together with --profile-file.");
   UsageError("");
+  UsageError("  --reuse-from=<file-name>: reuse the code of methods whose inputs did not change");
+  UsageError("      from a file written by an earlier --reuse-to invocation of the same dex2oat.");
+  UsageError("      The inputs of a method include the whole string, type, field and method id");
+  UsageError("      tables of its dex file, so adding any of these to a dex file, e.g. a new");
+  UsageError("      string literal, recompiles all methods of that dex file.");
+  UsageError("      Example: --reuse-from=/tmp/base.cmc");
+  UsageError("");
+  UsageError("  --reuse-to=<file-name>: write the compiled code of this invocation to a file");
+  UsageError("      for a later --reuse-from invocation.");
+  UsageError("      Example: --reuse-to=/tmp/base.cmc");
+  UsageError("");
+  UsageError("  --compilation-cache-dir=<directory>: reuse compiled code like --reuse-from and");
+  UsageError("      --reuse-to with a file in <directory> named after the compiler options,");
+  UsageError("      class path and dex file locations. Successive builds of an app find the code");
+  UsageError("      of the previous build there, and the directory can be shared by the builds");
+  UsageError("      of different apps, which do not reuse each other's code.");
+  UsageError("      Example: --compilation-cache-dir=/tmp/dex2oat-cache");
+  UsageError("");
   UsageError("  --swap-file=<file-name>: specifies a file to use for swap.");
   UsageError("      Example: --swap-file=/data/tmp/swap.001");
   UsageError("");
@@ -521,6 +540,11 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --max-image-block-size=<size>: Maximum solid block size for compressed images.");
   UsageError("");
+  UsageError("  --image-dictionary-size=<size>: Maximum size of a dictionary trained on the image");
+  UsageError("      data and shared by its blocks. Only used with --image-format=zstd when the");
+  UsageError("      image is split into several blocks.");
+  UsageError("      Default: 0 (no dictionary)");
+  UsageError("");
   std::cerr << "See log for usage error information\n";
   exit(EXIT_FAILURE);
 }
@@ -968,6 +992,10 @@ class Dex2Oat final {
       Usage("An input vdex should not be passed with a .dm file");
     }
 
+    if (!compilation_cache_dir_.empty() && !reuse_from_filename_.empty()) {
+      Usage("--compilation-cache-dir should not be used with --reuse-from");
+    }
+
     if (!parser_options->oat_symbols.empty() &&
         parser_options->oat_symbols.size() != oat_filenames_.size()) {
       Usage("--oat-file arguments do not match --oat-symbols arguments");
@@ -1328,6 +1356,9 @@ class Dex2Oat final {
     AssignIfExists(args, M::AppImageFile, &app_image_file_name_);
     AssignIfExists(args, M::AppImageFileFd, &app_image_fd_);
     AssignIfExists(args, M::NoInlineFrom, &no_inline_from_string_);
+    AssignIfExists(args, M::ReuseFrom, &reuse_from_filename_);
+    AssignIfExists(args, M::ReuseTo, &reuse_to_filename_);
+    AssignIfExists(args, M::CompilationCacheDir, &compilation_cache_dir_);
     AssignIfExists(args, M::ClasspathDir, &classpath_dir_);
     AssignIfExists(args, M::DirtyImageObjects, &dirty_image_objects_filename_);
     AssignIfExists(args, M::UpdatableBcpPackagesFile, &updatable_bcp_packages_filename_);
@@ -2109,18 +2140,130 @@ class Dex2Oat final {
       callbacks_->SetVerifierDeps(new verifier::VerifierDeps(dex_files));
     }
 
+    if (!reuse_from_filename_.empty() ||
+        !reuse_to_filename_.empty() ||
+        !compilation_cache_dir_.empty()) {
+      SetUpCompiledMethodCache();
+    }
+
     // To allow initialization of classes that construct ThreadLocal objects in class initializer,
     // re-initialize the ThreadLocal.nextHashCode to a new object that's not in the boot image.
     ThreadLocalHashOverride thread_local_hash_override(
         /*apply=*/ !IsBootImage(), /*initial_value=*/ 123456789u ^ GetCombinedChecksums());
 
     // Invoke the compilation.
+    jobject class_loader = nullptr;
     if (compile_individually) {
       CompileDexFilesIndividually();
       // Return a null classloader since we already freed released it.
-      return nullptr;
+    } else {
+      class_loader = CompileDexFiles(dex_files);
+    }
+
+    for (const std::string& filename : { reuse_to_filename_, compilation_cache_filename_ }) {
+      std::string error_msg;
+      if (!filename.empty() && !compiled_method_cache_->Save(filename, &error_msg)) {
+        LOG(WARNING) << "Failed to write compiled code for reuse: " << error_msg;
+      }
     }
-    return CompileDexFiles(dex_files);
+    return class_loader;
+  }
+
+  // Describes the inputs of the compilation other than the dex files being compiled,
+  // see CompiledMethodCache.
+  std::string GetCompiledMethodCacheFingerprint() const {
+    std::ostringstream oss;
+    oss << "oat-version=" << reinterpret_cast<const char*>(OatHeader::kOatVersion.data())
+        << " debug-build=" << kIsDebugBuild
+        << " isa=" << compiler_options_->GetInstructionSet()
+        << " features=" << compiler_options_->GetInstructionSetFeatures()->GetFeatureString()
+        << " backend=" << static_cast<uint32_t>(compiler_kind_)
+        << " filter=" << CompilerFilter::NameOfFilter(compiler_options_->GetCompilerFilter())
+        << " image-type=" << static_cast<uint32_t>(compiler_options_->image_type_)
+        << " baseline=" << compiler_options_->IsBaseline()
+        << " debuggable=" << compiler_options_->GetDebuggable()
+        << " native-debuggable=" << compiler_options_->GetNativeDebuggable()
+        << " debug-info=" << compiler_options_->GetGenerateDebugInfo()
+        << " mini-debug-info=" << compiler_options_->GetGenerateMiniDebugInfo()
+        << " implicit-checks=" << compiler_options_->GetImplicitNullChecks()
+        << compiler_options_->GetImplicitStackOverflowChecks()
+        << compiler_options_->GetImplicitSuspendChecks()
+        << " pic=" << compiler_options_->GetCompilePic()
+        << " huge-method=" << compiler_options_->GetHugeMethodThreshold()
+        << " large-method=" << compiler_options_->GetLargeMethodThreshold()
+        << " inline-max-code-units=" << compiler_options_->GetInlineMaxCodeUnits()
+        << " count-hotness=" << compiler_options_->CountHotnessInCompiledCode()
+        << " resolve-startup-strings=" << compiler_options_->ResolveStartupConstStrings()
+        << " initialize-app-image-classes=" << compiler_options_->InitializeAppImageClasses()
+        << " register-allocation="
+        << static_cast<uint32_t>(compiler_options_->register_allocation_strategy_)
+        << " compile-individually=" << ShouldCompileDexFilesIndividually()
+        << " hidden-api-policy=" << static_cast<uint32_t>(
+            Runtime::Current()->GetHiddenApiEnforcementPolicy());
+    if (compiler_options_->GetPassesToRun() != nullptr) {
+      oss << " passes=" << android::base::Join(*compiler_options_->GetPassesToRun(), ',');
+    }
+    oss << " no-inline-from=";
+    for (const DexFile* dex_file : compiler_options_->no_inline_from_) {
+      oss << dex_file->GetLocation() << ",";
+    }
+    for (const char* key : { OatHeader::kBootClassPathChecksumsKey, OatHeader::kClassPathKey }) {
+      auto it = key_value_store_->find(key);
+      if (it != key_value_store_->end()) {
+        oss << " " << key << "=" << it->second;
+      }
+    }
+    std::vector<std::string> image_classes(compiler_options_->image_classes_.begin(),
+                                           compiler_options_->image_classes_.end());
+    std::sort(image_classes.begin(), image_classes.end());
+    oss << " image-classes=" << android::base::Join(image_classes, ',');
+    // The profile is not part of the fingerprint, the cache keys cover the profile data
+    // of each method.
+    return oss.str();
+  }
+
+  void SetUpCompiledMethodCache() {
+    TimingLogger::ScopedTiming t("Set up compiled method cache", timings_);
+    std::vector<const DexFile*> other_dex_files;
+    if (!IsBootImage() && !IsBootImageExtension()) {
+      other_dex_files = class_loader_context_->FlattenOpenedDexFiles();
+    }
+    const std::vector<const DexFile*>& boot_class_path =
+        Runtime::Current()->GetClassLinker()->GetBootClassPath();
+    other_dex_files.insert(other_dex_files.end(), boot_class_path.begin(), boot_class_path.end());
+    compiled_method_cache_.reset(
+        new CompiledMethodCache(GetCompiledMethodCacheFingerprint(),
+                                compiler_options_->GetDexFilesForOatFile(),
+                                other_dex_files,
+                                profile_compilation_info_.get()));
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      compiled_method_cache_->ComputeClassDigests();
+    }
+    std::string error_msg;
+    if (!reuse_from_filename_.empty() &&
+        !compiled_method_cache_->Load(reuse_from_filename_, &error_msg)) {
+      // Not fatal, we just compile everything.
+      LOG(WARNING) << "Failed to read compiled code for reuse: " << error_msg;
+    }
+    if (!reuse_to_filename_.empty()) {
+      compiled_method_cache_->EnableSaving();
+    }
+    if (!compilation_cache_dir_.empty()) {
+      if (mkdir(compilation_cache_dir_.c_str(), 0700) != 0 && errno != EEXIST) {
+        PLOG(WARNING) << "Failed to create compilation cache directory " << compilation_cache_dir_;
+      } else {
+        compilation_cache_filename_ =
+            compilation_cache_dir_ + "/" + compiled_method_cache_->GetFileName();
+        // The first build of an app has nothing to reuse yet.
+        if (OS::FileExists(compilation_cache_filename_.c_str()) &&
+            !compiled_method_cache_->Load(compilation_cache_filename_, &error_msg)) {
+          LOG(WARNING) << "Failed to read compiled code for reuse: " << error_msg;
+        }
+        compiled_method_cache_->EnableSaving();
+      }
+    }
+    driver_->SetCompiledMethodCache(compiled_method_cache_.get());
   }
 
   // Create the class loader, use it to compile, and return.
@@ -2254,7 +2397,8 @@ class Dex2Oat final {
                                                   oat_filenames_,
                                                   dex_file_oat_index_map_,
                                                   class_loader,
-                                                  dirty_image_objects_.get()));
+                                                  dirty_image_objects_.get(),
+                                                  thread_count_));
 
       // We need to prepare method offsets in the image address space for resolving linker patches.
       TimingLogger::ScopedTiming t2("dex2oat Prepare image address space", timings_);
@@ -2352,7 +2496,7 @@ class Dex2Oat final {
         rodata = nullptr;
 
         OutputStream* text = elf_writer->StartText();
-        if (!oat_writer->WriteCode(text)) {
+        if (!oat_writer->WriteCode(text, /*release_written_code=*/ true)) {
           LOG(ERROR) << "Failed to write .text section to the ELF file " << oat_file->GetPath();
           return false;
         }
@@ -2498,6 +2642,10 @@ class Dex2Oat final {
     if (compiler_options_->GetDumpTimings() ||
         (kIsDebugBuild && timings_->GetTotalNs() > MsToNs(1000))) {
       LOG(INFO) << Dumpable<TimingLogger>(*timings_);
+      if (compiled_method_cache_ != nullptr) {
+        LOG(INFO) << "Compiled method cache: " << compiled_method_cache_->GetNumberOfHits()
+                  << " hits, " << compiled_method_cache_->GetNumberOfMisses() << " misses";
+      }
     }
   }
 
@@ -3043,6 +3191,11 @@ class Dex2Oat final {
   bool is_host_;
   std::string android_root_;
   std::string no_inline_from_string_;
+  std::string reuse_from_filename_;
+  std::string reuse_to_filename_;
+  std::string compilation_cache_dir_;
+  std::string compilation_cache_filename_;
+  std::unique_ptr<CompiledMethodCache> compiled_method_cache_;
   CompactDexLevel compact_dex_level_ = kDefaultCompactDexLevel;
 
   std::vector<std::unique_ptr<linker::ElfWriter>> elf_writers_;
@@ -251,6 +251,40 @@ TEST_F(Dex2oatImageTest, TestModesAndFilters) {
   }
 }
 
+TEST_F(Dex2oatImageTest, TestDeterministicWithThreads) {
+  if (kIsTargetBuild) {
+    // This test is too slow for target builds.
+    return;
+  }
+  std::vector<std::string> libcore_dex_files = GetLibCoreDexFileNames();
+  ASSERT_NE(std::string::npos, libcore_dex_files[0].find("core-oj"));
+  ASSERT_NE(std::string::npos, libcore_dex_files[1].find("core-libart"));
+  ArrayRef<const std::string> dex_files =
+      ArrayRef<const std::string>(libcore_dex_files).SubArray(/*pos=*/ 0u, /*length=*/ 2u);
+
+  // The image writer copies and fixes up the objects and native data on multiple
+  // threads; the output must not depend on the number of threads.
+  ScratchDir scratch;
+  std::string single_thread_prefix = scratch.GetPath() + "single";
+  std::string multi_thread_prefix = scratch.GetPath() + "multi";
+  std::vector<std::string> extra_args = {
+      android::base::StringPrintf("--base=0x%08x", kBaseAddress),
+      "--force-determinism",
+  };
+  std::string error_msg;
+  extra_args.push_back("-j1");
+  ASSERT_TRUE(CompileBootImage(extra_args, single_thread_prefix, dex_files, &error_msg))
+      << error_msg;
+  extra_args.back() = "-j4";
+  ASSERT_TRUE(CompileBootImage(extra_args, multi_thread_prefix, dex_files, &error_msg))
+      << error_msg;
+
+  for (const char* extension : { ".art", ".oat", ".vdex" }) {
+    EXPECT_TRUE(CompareFiles(single_thread_prefix + extension, multi_thread_prefix + extension))
+        << extension;
+  }
+}
+
 TEST_F(Dex2oatImageTest, TestExtension) {
   std::string error_msg;
   MemMap reservation = ReserveCoreImageAddressSpace(&error_msg);
@@ -138,6 +138,7 @@ static void AddImageMappings(Builder& builder) {
           .WithType<ImageHeader::StorageMode>()
           .WithValueMap({{"lz4", ImageHeader::kStorageModeLZ4},
                          {"lz4hc", ImageHeader::kStorageModeLZ4HC},
+                         {"zstd", ImageHeader::kStorageModeZstd},
                          {"uncompressed", ImageHeader::kStorageModeUncompressed}})
           .IntoKey(M::ImageFormat);
 }
@@ -171,7 +172,16 @@ static void AddCompilerMappings(Builder& builder) {
           .IntoKey(M::ProfileFd)
       .Define("--no-inline-from=_")
           .WithType<std::string>()
-          .IntoKey(M::NoInlineFrom);
+          .IntoKey(M::NoInlineFrom)
+      .Define("--reuse-from=_")
+          .WithType<std::string>()
+          .IntoKey(M::ReuseFrom)
+      .Define("--reuse-to=_")
+          .WithType<std::string>()
+          .IntoKey(M::ReuseTo)
+      .Define("--compilation-cache-dir=_")
+          .WithType<std::string>()
+          .IntoKey(M::CompilationCacheDir);
 }
 
 static void AddTargetMappings(Builder& builder) {
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include <dirent.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -47,7 +48,7 @@
 #include "gc_root-inl.h"
 #include "intern_table-inl.h"
 #include "oat.h"
-#include "oat_file.h"
+#include "oat_file-inl.h"
 #include "profile/profile_compilation_info.h"
 #include "vdex_file.h"
 #include "ziparchive/zip_writer.h"
@@ -832,6 +833,13 @@ class Dex2oatLayoutTest : public Dex2oatTest {
 
     EXPECT_EQ(odex_file->GetCompilerFilter(), CompilerFilter::kSpeedProfile);
 
+    // The code is laid out in startup, hot and cold regions when compiling with a profile.
+    const OatHeader& oat_header = odex_file->GetOatHeader();
+    EXPECT_GE(oat_header.GetHotCodeOffset(), oat_header.GetExecutableOffset());
+    EXPECT_GE(oat_header.GetColdCodeOffset(), oat_header.GetHotCodeOffset());
+    EXPECT_LE(oat_header.GetColdCodeOffset(),
+              static_cast<size_t>(odex_file->End() - odex_file->Begin()));
+
     if (!app_image_file_name.empty()) {
       // Go peek at the image header to make sure it was large enough to contain the class.
       std::unique_ptr<File> file(OS::OpenFileForReading(app_image_file_name.c_str()));
@@ -1521,6 +1529,81 @@ TEST_F(Dex2oatTest, LayoutSections) {
   }
 }
 
+// Test that the code of startup methods, of the other hot methods and of unprofiled methods is
+// laid out in the code regions recorded in the oat header.
+TEST_F(Dex2oatTest, LayoutCodeRegions) {
+  using Hotness = ProfileCompilationInfo::MethodHotness;
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+  ScratchFile profile_file;
+  const dex::TypeId* type_id = dex->FindTypeId("LManyMethods;");
+  ASSERT_TRUE(type_id != nullptr);
+  const dex::ClassDef* class_def = dex->FindClassDef(dex->GetIndexForTypeId(*type_id));
+  ASSERT_TRUE(class_def != nullptr);
+  // Only use methods with unique code items, so that their compiled code is not deduplicated.
+  // Remember the index of each method in the OatClass.
+  std::vector<std::pair<uint16_t, uint32_t>> methods;
+  {
+    ClassAccessor accessor(*dex, *class_def);
+    std::set<size_t> code_item_offsets;
+    uint32_t class_method_index = 0u;
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      if (code_item_offsets.insert(method.GetCodeItemOffset()).second) {
+        methods.emplace_back(method.GetIndex(), class_method_index);
+      }
+      ++class_method_index;
+    }
+  }
+  ASSERT_GE(methods.size(), 6u);
+  std::vector<uint16_t> startup_methods = {methods[1].first};
+  std::vector<uint16_t> hot_methods = {methods[3].first};
+  const uint32_t startup_class_method_index = methods[1].second;
+  const uint32_t hot_class_method_index = methods[3].second;
+  const uint32_t cold_class_method_index = methods[5].second;
+  ProfileCompilationInfo info;
+  info.AddMethodsForDex(
+      static_cast<Hotness::Flag>(Hotness::kFlagHot | Hotness::kFlagStartup),
+      dex.get(),
+      startup_methods.begin(),
+      startup_methods.end());
+  info.AddMethodsForDex(Hotness::kFlagHot, dex.get(), hot_methods.begin(), hot_methods.end());
+  ASSERT_TRUE(info.Save(profile_file.GetFd()));
+
+  // Compile everything so that the unprofiled methods have code too.
+  const std::string oat_filename = GetScratchDir() + "/base.oat";
+  std::string error_msg;
+  const int res = GenerateOdexForTestWithStatus(
+      {dex->GetLocation()},
+      oat_filename,
+      CompilerFilter::Filter::kSpeed,
+      &error_msg,
+      {"--profile-file=" + profile_file.GetFilename()});
+  ASSERT_EQ(res, 0) << error_msg;
+  std::unique_ptr<OatFile> odex_file(OatFile::Open(/*zip_fd=*/ -1,
+                                                   oat_filename.c_str(),
+                                                   oat_filename.c_str(),
+                                                   /*executable=*/ false,
+                                                   /*low_4gb=*/ false,
+                                                   dex->GetLocation(),
+                                                   &error_msg));
+  ASSERT_TRUE(odex_file != nullptr) << error_msg;
+  std::vector<const OatDexFile*> oat_dex_files = odex_file->GetOatDexFiles();
+  ASSERT_EQ(oat_dex_files.size(), 1u);
+  const OatFile::OatClass oat_class =
+      oat_dex_files[0]->GetOatClass(dex->GetIndexForClassDef(*class_def));
+
+  const OatHeader& oat_header = odex_file->GetOatHeader();
+  uint32_t startup_code_offset = oat_class.GetOatMethod(startup_class_method_index).GetCodeOffset();
+  uint32_t hot_code_offset = oat_class.GetOatMethod(hot_class_method_index).GetCodeOffset();
+  uint32_t cold_code_offset = oat_class.GetOatMethod(cold_class_method_index).GetCodeOffset();
+  ASSERT_NE(startup_code_offset, 0u);
+  ASSERT_NE(hot_code_offset, 0u);
+  ASSERT_NE(cold_code_offset, 0u);
+  EXPECT_LT(startup_code_offset, oat_header.GetHotCodeOffset());
+  EXPECT_GE(hot_code_offset, oat_header.GetHotCodeOffset());
+  EXPECT_LT(hot_code_offset, oat_header.GetColdCodeOffset());
+  EXPECT_GE(cold_code_offset, oat_header.GetColdCodeOffset());
+}
+
 // Test that generating compact dex works.
 TEST_F(Dex2oatTest, GenerateCompactDex) {
   // Generate a compact dex based odex.
@@ -1663,6 +1746,304 @@ TEST_F(Dex2oatDedupeCode, DedupeTest) {
   EXPECT_LT(dedupe_size, no_dedupe_size);
 }
 
+class Dex2oatReuseTest : public Dex2oatTest {
+ protected:
+  void CompileAndCopy(const std::string& odex_location,
+                      const std::string& copy_location,
+                      const std::vector<std::string>& extra_args) {
+    CompileAndCopy({ GetTestDexFileName("MultiDex") }, odex_location, copy_location, extra_args);
+  }
+
+  // Compiles the `dex_locations` and records the compiled method cache hits and misses
+  // reported by dex2oat in `hits_` and `misses_`.
+  void CompileAndCopy(const std::vector<std::string>& dex_locations,
+                      const std::string& odex_location,
+                      const std::string& copy_location,
+                      const std::vector<std::string>& extra_args) {
+    std::vector<std::string> args =
+        { "--force-determinism", "--avoid-storing-invocation", "--dump-timings" };
+    args.insert(args.end(), extra_args.begin(), extra_args.end());
+    output_ = "";
+    std::string error_msg;
+    int status = GenerateOdexForTestWithStatus(dex_locations,
+                                               odex_location,
+                                               CompilerFilter::Filter::kSpeed,
+                                               &error_msg,
+                                               args);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << error_msg << output_;
+    Copy(odex_location, copy_location);
+    ParseCacheStats();
+  }
+
+  void ExpectSameContents(const std::string& lhs_location, const std::string& rhs_location) {
+    std::unique_ptr<File> lhs(OS::OpenFileForReading(lhs_location.c_str()));
+    std::unique_ptr<File> rhs(OS::OpenFileForReading(rhs_location.c_str()));
+    ASSERT_TRUE(lhs != nullptr);
+    ASSERT_TRUE(rhs != nullptr);
+    EXPECT_GT(lhs->GetLength(), 0);
+    EXPECT_EQ(lhs->GetLength(), rhs->GetLength());
+    EXPECT_EQ(lhs->Compare(rhs.get()), 0) << lhs_location << " " << rhs_location;
+  }
+
+  // Expects the last compilation to have the given number of cache hits and misses. The
+  // numbers are only known on host, on target the dex2oat output goes to the logcat.
+  void ExpectCacheStats(size_t expected_hits, size_t expected_misses) {
+    if (!kIsTargetBuild) {
+      ASSERT_TRUE(has_cache_stats_) << output_;
+      EXPECT_NE(0u, hits_ + misses_) << output_;
+      EXPECT_EQ(expected_hits, hits_) << output_;
+      EXPECT_EQ(expected_misses, misses_) << output_;
+    }
+  }
+
+  size_t hits_ = 0u;
+  size_t misses_ = 0u;
+
+ private:
+  void ParseCacheStats() {
+    std::regex cache_regex("Compiled method cache: ([0-9]+) hits, ([0-9]+) misses");
+    std::smatch cache_match;
+    has_cache_stats_ = std::regex_search(output_, cache_match, cache_regex);
+    hits_ = 0u;
+    misses_ = 0u;
+    if (!has_cache_stats_) {
+      return;
+    }
+    std::istringstream(cache_match[1].str()) >> hits_;
+    std::istringstream(cache_match[2].str()) >> misses_;
+  }
+
+  bool has_cache_stats_ = false;
+};
+
+TEST_F(Dex2oatReuseTest, ReuseCompiledCode) {
+  std::string out_dir = GetScratchDir();
+  const std::string odex_location = out_dir + "/base.odex";
+  const std::string fresh_odex = out_dir + "/fresh.odex";
+  const std::string reused_odex = out_dir + "/reused.odex";
+  const std::string first_cache = out_dir + "/first.cmc";
+  const std::string second_cache = out_dir + "/second.cmc";
+
+  CompileAndCopy(odex_location, fresh_odex, { "--reuse-to=" + first_cache });
+  size_t number_of_methods = misses_;
+  ExpectCacheStats(0u, number_of_methods);
+  CompileAndCopy(odex_location,
+                 reused_odex,
+                 { "--reuse-from=" + first_cache, "--reuse-to=" + second_cache });
+  ExpectCacheStats(number_of_methods, 0u);
+
+  // Reused code must produce exactly the same oat file, and carry over all entries.
+  ExpectSameContents(fresh_odex, reused_odex);
+  ExpectSameContents(first_cache, second_cache);
+}
+
+TEST_F(Dex2oatReuseTest, RecompileOnlyDependents) {
+  std::string out_dir = GetScratchDir();
+  const std::string odex_location = out_dir + "/base.odex";
+  const std::string copy_location = out_dir + "/copy.odex";
+  const std::string unrelated_cache = out_dir + "/unrelated.cmc";
+  const std::string cache = out_dir + "/base.cmc";
+  const std::string unrelated_dex = GetTestDexFileName("ManyMethods");
+
+  // The classes of ManyMethods do not refer to those of MultiDex.
+  CompileAndCopy({ unrelated_dex },
+                 odex_location,
+                 copy_location,
+                 { "--reuse-to=" + unrelated_cache });
+  size_t number_of_unrelated_methods = misses_;
+  ExpectCacheStats(0u, number_of_unrelated_methods);
+  CompileAndCopy({ unrelated_dex, GetTestDexFileName("MultiDex") },
+                 odex_location,
+                 copy_location,
+                 { "--reuse-to=" + cache });
+  size_t number_of_methods = misses_;
+  ExpectCacheStats(0u, number_of_methods);
+
+  // MultiDexModifiedSecondary has the same classes.dex, with a Main class using the
+  // Second class of its modified classes2.dex. Only the unrelated methods can be reused.
+  CompileAndCopy({ unrelated_dex, GetTestDexFileName("MultiDexModifiedSecondary") },
+                 odex_location,
+                 copy_location,
+                 { "--reuse-from=" + cache });
+  if (!kIsTargetBuild) {
+    EXPECT_LT(number_of_unrelated_methods, number_of_methods);
+    EXPECT_NE(0u, misses_) << output_;
+  }
+  ExpectCacheStats(number_of_unrelated_methods, misses_);
+}
+
+TEST_F(Dex2oatReuseTest, SharedCacheDirectory) {
+  std::string out_dir = GetScratchDir();
+  const std::string odex_location = out_dir + "/base.odex";
+  const std::string fresh_odex = out_dir + "/fresh.odex";
+  const std::string cached_odex = out_dir + "/cached.odex";
+  const std::string cache_dir = out_dir + "/cache";
+
+  CompileAndCopy(odex_location, fresh_odex, { "--compilation-cache-dir=" + cache_dir });
+  size_t number_of_methods = misses_;
+  ExpectCacheStats(0u, number_of_methods);
+  std::unique_ptr<DIR, decltype(&closedir)> dir(opendir(cache_dir.c_str()), closedir);
+  ASSERT_TRUE(dir != nullptr);
+  size_t num_files = 0u;
+  for (dirent* entry = readdir(dir.get()); entry != nullptr; entry = readdir(dir.get())) {
+    if (entry->d_name[0] != '.') {
+      ++num_files;
+    }
+  }
+  EXPECT_EQ(num_files, 1u);
+
+  CompileAndCopy(odex_location, cached_odex, { "--compilation-cache-dir=" + cache_dir });
+  ExpectCacheStats(number_of_methods, 0u);
+  ExpectSameContents(fresh_odex, cached_odex);
+  ClearDirectory(cache_dir.c_str());
+  ASSERT_EQ(rmdir(cache_dir.c_str()), 0);
+}
+
+TEST_F(Dex2oatReuseTest, SharedCacheDirectoryRecompilesOnlyDependents) {
+  std::string out_dir = GetScratchDir();
+  const std::string odex_location = out_dir + "/base.odex";
+  const std::string copy_location = out_dir + "/copy.odex";
+  const std::string unrelated_cache = out_dir + "/unrelated.cmc";
+  const std::string cache_dir = out_dir + "/cache";
+  const std::string unrelated_dex = GetTestDexFileName("ManyMethods");
+  const std::string app_dex = out_dir + "/app.jar";
+
+  CompileAndCopy({ unrelated_dex },
+                 odex_location,
+                 copy_location,
+                 { "--reuse-to=" + unrelated_cache });
+  size_t number_of_unrelated_methods = misses_;
+
+  // Successive builds of an app have the same dex locations, so the second build finds
+  // the code of the first one in the directory.
+  Copy(GetTestDexFileName("MultiDex"), app_dex);
+  CompileAndCopy({ unrelated_dex, app_dex },
+                 odex_location,
+                 copy_location,
+                 { "--compilation-cache-dir=" + cache_dir });
+  size_t number_of_methods = misses_;
+  ExpectCacheStats(0u, number_of_methods);
+  Copy(GetTestDexFileName("MultiDexModifiedSecondary"), app_dex);
+  CompileAndCopy({ unrelated_dex, app_dex },
+                 odex_location,
+                 copy_location,
+                 { "--compilation-cache-dir=" + cache_dir });
+  if (!kIsTargetBuild) {
+    EXPECT_NE(0u, misses_) << output_;
+  }
+  ExpectCacheStats(number_of_unrelated_methods, misses_);
+  ClearDirectory(cache_dir.c_str());
+  ASSERT_EQ(rmdir(cache_dir.c_str()), 0);
+}
+
+TEST_F(Dex2oatReuseTest, DontReuseWithDifferentOptions) {
+  std::string out_dir = GetScratchDir();
+  const std::string odex_location = out_dir + "/base.odex";
+  const std::string fresh_odex = out_dir + "/fresh.odex";
+  const std::string reused_odex = out_dir + "/reused.odex";
+  const std::string cache = out_dir + "/base.cmc";
+
+  CompileAndCopy(odex_location, reused_odex, { "--reuse-to=" + cache });
+  size_t number_of_methods = misses_;
+  CompileAndCopy(odex_location, fresh_odex, { "--debuggable" });
+  CompileAndCopy(odex_location, reused_odex, { "--debuggable", "--reuse-from=" + cache });
+  ExpectCacheStats(0u, number_of_methods);
+
+  // The non-debuggable code must not leak into the debuggable oat file.
+  ExpectSameContents(fresh_odex, reused_odex);
+}
+
+TEST_F(Dex2oatReuseTest, RecompileAfterAddingStringId) {
+  std::string out_dir = GetScratchDir();
+  const std::string odex_location = out_dir + "/base.odex";
+  const std::string fresh_odex = out_dir + "/fresh.odex";
+  const std::string reused_odex = out_dir + "/reused.odex";
+  const std::string unrelated_cache = out_dir + "/unrelated.cmc";
+  const std::string modified_cache = out_dir + "/modified.cmc";
+  const std::string cache = out_dir + "/base.cmc";
+  const std::string unrelated_dex = GetTestDexFileName("ManyMethods");
+  const std::string modified_dex = GetTestDexFileName("MultiDexModifiedSecondary");
+
+  CompileAndCopy({ unrelated_dex },
+                 odex_location,
+                 reused_odex,
+                 { "--reuse-to=" + unrelated_cache });
+  size_t number_of_unrelated_methods = misses_;
+  CompileAndCopy({ unrelated_dex, modified_dex },
+                 odex_location,
+                 fresh_odex,
+                 { "--reuse-to=" + modified_cache });
+  size_t number_of_methods = misses_;
+  CompileAndCopy({ unrelated_dex, GetTestDexFileName("MultiDex") },
+                 odex_location,
+                 reused_odex,
+                 { "--reuse-to=" + cache });
+
+  // The classes2.dex of MultiDexModifiedSecondary has the new string "I Third That.", which
+  // shifts the string ids of that dex file. None of the MultiDex code may be reused, even for
+  // methods whose code items did not change, but all of the ManyMethods code must be.
+  CompileAndCopy({ unrelated_dex, modified_dex },
+                 odex_location,
+                 reused_odex,
+                 { "--reuse-from=" + cache });
+  ExpectCacheStats(number_of_unrelated_methods, number_of_methods - number_of_unrelated_methods);
+  ExpectSameContents(fresh_odex, reused_odex);
+}
+
+TEST_F(Dex2oatReuseTest, ReuseWithProfile) {
+  using Hotness = ProfileCompilationInfo::MethodHotness;
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+  std::vector<uint16_t> methods;
+  for (ClassAccessor accessor : dex->GetClasses()) {
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      if (method.GetCodeItem() != nullptr && (method.GetAccessFlags() & kAccConstructor) == 0) {
+        methods.push_back(method.GetIndex());
+      }
+    }
+  }
+  ASSERT_GE(methods.size(), 2u);
+
+  // The updated profile only adds the hotness of the last method, so only that method's key
+  // changes.
+  ScratchFile profile;
+  ScratchFile updated_profile;
+  {
+    ProfileCompilationInfo info;
+    info.AddMethodsForDex(Hotness::kFlagHot, dex.get(), methods.begin(), methods.end() - 1);
+    ASSERT_TRUE(info.Save(profile.GetFd()));
+    info.AddMethodsForDex(Hotness::kFlagHot, dex.get(), methods.end() - 1, methods.end());
+    ASSERT_TRUE(info.Save(updated_profile.GetFd()));
+  }
+
+  std::string out_dir = GetScratchDir();
+  const std::string odex_location = out_dir + "/base.odex";
+  const std::string fresh_odex = out_dir + "/fresh.odex";
+  const std::string reused_odex = out_dir + "/reused.odex";
+  const std::string cache = out_dir + "/base.cmc";
+  const std::string profile_arg = "--profile-file=" + profile.GetFilename();
+  const std::string updated_profile_arg = "--profile-file=" + updated_profile.GetFilename();
+
+  CompileAndCopy({ dex->GetLocation() },
+                 odex_location,
+                 fresh_odex,
+                 { profile_arg, "--reuse-to=" + cache });
+  size_t number_of_methods = misses_;
+  CompileAndCopy({ dex->GetLocation() },
+                 odex_location,
+                 reused_odex,
+                 { profile_arg, "--reuse-from=" + cache });
+  ExpectCacheStats(number_of_methods, 0u);
+  ExpectSameContents(fresh_odex, reused_odex);
+
+  CompileAndCopy({ dex->GetLocation() }, odex_location, fresh_odex, { updated_profile_arg });
+  CompileAndCopy({ dex->GetLocation() },
+                 odex_location,
+                 reused_odex,
+                 { updated_profile_arg, "--reuse-from=" + cache });
+  ExpectCacheStats(number_of_methods - 1u, 1u);
+  ExpectSameContents(fresh_odex, reused_odex);
+}
+
 TEST_F(Dex2oatTest, UncompressedTest) {
   std::unique_ptr<const DexFile> dex(OpenTestDexFile("MainUncompressedAligned"));
   std::string out_dir = GetScratchDir();
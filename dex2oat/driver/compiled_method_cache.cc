@@ -0,0 +1,1019 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compiled_method_cache.h"
+
+#include <openssl/sha.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string_view>
+#include <tuple>
+
+#include "android-base/stringprintf.h"
+
+#include "base/logging.h"
+#include "base/os.h"
+#include "base/utils.h"
+#include "base/unix_file/fd_file.h"
+#include "compiled_method.h"
+#include "dex/class_accessor-inl.h"
+#include "dex/code_item_accessors-inl.h"
+#include "dex/dex_file-inl.h"
+#include "dex/dex_file_annotations.h"
+#include "dex/dex_file_exception_helpers.h"
+#include "dex/dex_instruction-inl.h"
+#include "dex/method_reference.h"
+#include "driver/compiled_method_storage.h"
+#include "linker/linker_patch.h"
+#include "profile/profile_compilation_info.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+static_assert(CompiledMethodCache::kDigestSize == SHA256_DIGEST_LENGTH, "Digest size mismatch");
+
+static constexpr uint8_t kCacheMagic[] = { 'c', 'm', 'c', '\n' };
+static constexpr uint8_t kCacheVersion[] = { '0', '0', '1', '\0' };
+
+static constexpr uint32_t kNoClass = static_cast<uint32_t>(-1);
+static constexpr uint32_t kNoDexFile = static_cast<uint32_t>(-1);
+
+namespace {
+
+class DigestBuilder {
+ public:
+  DigestBuilder() {
+    SHA256_Init(&ctx_);
+  }
+
+  void Update(const void* data, size_t size) {
+    SHA256_Update(&ctx_, data, size);
+  }
+
+  void Update(uint32_t value) {
+    Update(&value, sizeof(value));
+  }
+
+  void Update(uint64_t value) {
+    Update(&value, sizeof(value));
+  }
+
+  void Update(const CompiledMethodCache::Digest& digest) {
+    Update(digest.data(), digest.size());
+  }
+
+  void Update(std::string_view str) {
+    Update(static_cast<uint32_t>(str.size()));
+    Update(str.data(), str.size());
+  }
+
+  CompiledMethodCache::Digest Finish() {
+    CompiledMethodCache::Digest digest;
+    SHA256_Final(digest.data(), &ctx_);
+    return digest;
+  }
+
+ private:
+  SHA256_CTX ctx_;
+};
+
+class ByteWriter {
+ public:
+  explicit ByteWriter(std::vector<uint8_t>* data) : data_(data) {}
+
+  void WriteU8(uint8_t value) {
+    data_->push_back(value);
+  }
+
+  void WriteU32(uint32_t value) {
+    WriteBytes(ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(&value), sizeof(value)));
+  }
+
+  void WriteBytes(ArrayRef<const uint8_t> bytes) {
+    data_->insert(data_->end(), bytes.begin(), bytes.end());
+  }
+
+  void WriteBlob(ArrayRef<const uint8_t> bytes) {
+    WriteU32(dchecked_integral_cast<uint32_t>(bytes.size()));
+    WriteBytes(bytes);
+  }
+
+ private:
+  std::vector<uint8_t>* const data_;
+};
+
+// Reads data written by `ByteWriter`. All reads fail once the input is exhausted.
+class ByteReader {
+ public:
+  explicit ByteReader(ArrayRef<const uint8_t> data) : data_(data), pos_(0u) {}
+
+  bool ReadU8(/*out*/ uint8_t* value) {
+    if (pos_ == data_.size()) {
+      return false;
+    }
+    *value = data_[pos_];
+    ++pos_;
+    return true;
+  }
+
+  bool ReadU32(/*out*/ uint32_t* value) {
+    ArrayRef<const uint8_t> bytes;
+    if (!ReadBytes(sizeof(*value), &bytes)) {
+      return false;
+    }
+    memcpy(value, bytes.data(), sizeof(*value));
+    return true;
+  }
+
+  bool ReadBytes(size_t size, /*out*/ ArrayRef<const uint8_t>* bytes) {
+    if (data_.size() - pos_ < size) {
+      return false;
+    }
+    *bytes = data_.SubArray(pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadBlob(/*out*/ ArrayRef<const uint8_t>* bytes) {
+    uint32_t size;
+    return ReadU32(&size) && ReadBytes(size, bytes);
+  }
+
+  bool IsAtEnd() const {
+    return pos_ == data_.size();
+  }
+
+ private:
+  const ArrayRef<const uint8_t> data_;
+  size_t pos_;
+};
+
+}  // namespace
+
+// Only the bits that the iterator sets for the value type are meaningful.
+static void UpdateWithEncodedValue(DigestBuilder* builder, const EncodedArrayValueIterator& it) {
+  builder->Update(static_cast<uint32_t>(it.GetValueType()));
+  if (it.GetValueType() == EncodedArrayValueIterator::kLong ||
+      it.GetValueType() == EncodedArrayValueIterator::kDouble) {
+    builder->Update(static_cast<uint64_t>(it.GetJavaValue().j));
+  } else if (it.GetValueType() != EncodedArrayValueIterator::kNull) {
+    builder->Update(static_cast<uint32_t>(it.GetJavaValue().i));
+  }
+}
+
+// Adds the inline caches that the `profile` holds for `method_ref`. Classes defined in
+// one of the `dex_files` are named by their descriptor rather than by their type index,
+// which shifts when types are added to their dex file.
+static void UpdateWithInlineCaches(DigestBuilder* builder,
+                                   const ProfileCompilationInfo& profile,
+                                   const MethodReference& method_ref,
+                                   const std::vector<const DexFile*>& dex_files) {
+  std::unique_ptr<ProfileCompilationInfo::OfflineProfileMethodInfo> info =
+      profile.GetHotMethodInfo(method_ref);
+  if (info == nullptr) {
+    builder->Update(0u);
+    return;
+  }
+  std::vector<const DexFile*> profile_dex_files;
+  for (const ProfileCompilationInfo::DexReference& dex_ref : info->dex_references) {
+    auto it = std::find_if(dex_files.begin(),
+                           dex_files.end(),
+                           [&](const DexFile* dex_file) { return dex_ref.MatchesDex(dex_file); });
+    profile_dex_files.push_back((it != dex_files.end()) ? *it : nullptr);
+  }
+  builder->Update(1u);
+  builder->Update(static_cast<uint32_t>(info->inline_caches->size()));
+  std::vector<std::string> classes;
+  for (const auto& [dex_pc, dex_pc_data] : *info->inline_caches) {
+    builder->Update(static_cast<uint32_t>(dex_pc));
+    builder->Update(static_cast<uint32_t>(dex_pc_data.is_missing_types ? 1u : 0u));
+    builder->Update(static_cast<uint32_t>(dex_pc_data.is_megamorphic ? 1u : 0u));
+    classes.clear();
+    for (const ProfileCompilationInfo::ClassReference& class_ref : dex_pc_data.classes) {
+      const DexFile* dex_file = profile_dex_files[class_ref.dex_profile_index];
+      if (dex_file != nullptr && class_ref.type_index.index_ < dex_file->NumTypeIds()) {
+        classes.push_back(dex_file->StringByTypeIdx(class_ref.type_index));
+      } else {
+        const ProfileCompilationInfo::DexReference& dex_ref =
+            info->dex_references[class_ref.dex_profile_index];
+        classes.push_back(StringPrintf("%s:%08x:%u",
+                                       dex_ref.profile_key.c_str(),
+                                       dex_ref.dex_checksum,
+                                       class_ref.type_index.index_));
+      }
+    }
+    // The order of the classes depends on their type indexes.
+    std::sort(classes.begin(), classes.end());
+    builder->Update(static_cast<uint32_t>(classes.size()));
+    for (const std::string& descriptor : classes) {
+      builder->Update(std::string_view(descriptor));
+    }
+  }
+}
+
+// The compiler can inline methods of the `other_dex_files` and use their inline caches,
+// so their profile data is part of the compilation environment.
+static CompiledMethodCache::Digest ComputeFingerprintDigest(
+    const std::string& fingerprint,
+    const ProfileCompilationInfo* profile,
+    const std::vector<const DexFile*>& dex_files,
+    const std::vector<const DexFile*>& other_dex_files) {
+  DigestBuilder builder;
+  builder.Update(std::string_view(fingerprint));
+  if (profile != nullptr) {
+    std::vector<const DexFile*> all_dex_files(dex_files);
+    all_dex_files.insert(all_dex_files.end(), other_dex_files.begin(), other_dex_files.end());
+    for (const DexFile* dex_file : other_dex_files) {
+      if (std::find(dex_files.begin(), dex_files.end(), dex_file) != dex_files.end()) {
+        continue;  // The profile data of the dex files being compiled is in the keys.
+      }
+      std::set<dex::TypeIndex> classes;
+      std::set<uint16_t> hot_methods;
+      std::set<uint16_t> startup_methods;
+      std::set<uint16_t> post_startup_methods;
+      profile->GetClassesAndMethods(
+          *dex_file, &classes, &hot_methods, &startup_methods, &post_startup_methods);
+      builder.Update(static_cast<uint32_t>(hot_methods.size()));
+      for (uint16_t method_idx : hot_methods) {
+        builder.Update(static_cast<uint32_t>(method_idx));
+        UpdateWithInlineCaches(
+            &builder, *profile, MethodReference(dex_file, method_idx), all_dex_files);
+      }
+    }
+  }
+  return builder.Finish();
+}
+
+// Digest of everything that dex indexes embedded in compiled code and in dex
+// instructions can refer to, i.e. the string, type, proto, field and method ids,
+// the method handles and the call sites.
+static CompiledMethodCache::Digest ComputeIdsDigest(const DexFile& dex_file) {
+  DigestBuilder builder;
+  builder.Update(static_cast<uint32_t>(dex_file.NumStringIds()));
+  for (size_t i = 0, num = dex_file.NumStringIds(); i != num; ++i) {
+    builder.Update(dex_file.StringViewByIdx(dex::StringIndex(i)));
+  }
+  builder.Update(dex_file.NumTypeIds());
+  for (size_t i = 0, num = dex_file.NumTypeIds(); i != num; ++i) {
+    builder.Update(dex_file.GetTypeId(dex::TypeIndex(i)).descriptor_idx_.index_);
+  }
+  builder.Update(static_cast<uint32_t>(dex_file.NumProtoIds()));
+  for (size_t i = 0, num = dex_file.NumProtoIds(); i != num; ++i) {
+    const dex::ProtoId& proto_id = dex_file.GetProtoId(dex::ProtoIndex(i));
+    builder.Update(proto_id.shorty_idx_.index_);
+    builder.Update(static_cast<uint32_t>(proto_id.return_type_idx_.index_));
+    const dex::TypeList* params = dex_file.GetProtoParameters(proto_id);
+    uint32_t num_params = (params != nullptr) ? params->Size() : 0u;
+    builder.Update(num_params);
+    for (uint32_t p = 0; p != num_params; ++p) {
+      builder.Update(static_cast<uint32_t>(params->GetTypeItem(p).type_idx_.index_));
+    }
+  }
+  builder.Update(static_cast<uint32_t>(dex_file.NumFieldIds()));
+  for (size_t i = 0, num = dex_file.NumFieldIds(); i != num; ++i) {
+    const dex::FieldId& field_id = dex_file.GetFieldId(i);
+    builder.Update(static_cast<uint32_t>(field_id.class_idx_.index_));
+    builder.Update(static_cast<uint32_t>(field_id.type_idx_.index_));
+    builder.Update(field_id.name_idx_.index_);
+  }
+  builder.Update(static_cast<uint32_t>(dex_file.NumMethodIds()));
+  for (size_t i = 0, num = dex_file.NumMethodIds(); i != num; ++i) {
+    const dex::MethodId& method_id = dex_file.GetMethodId(i);
+    builder.Update(static_cast<uint32_t>(method_id.class_idx_.index_));
+    builder.Update(static_cast<uint32_t>(method_id.proto_idx_.index_));
+    builder.Update(method_id.name_idx_.index_);
+  }
+  builder.Update(dex_file.NumMethodHandles());
+  for (size_t i = 0, num = dex_file.NumMethodHandles(); i != num; ++i) {
+    const dex::MethodHandleItem& method_handle = dex_file.GetMethodHandle(i);
+    builder.Update(static_cast<uint32_t>(method_handle.method_handle_type_));
+    builder.Update(static_cast<uint32_t>(method_handle.field_or_method_idx_));
+  }
+  builder.Update(dex_file.NumCallSiteIds());
+  for (size_t i = 0, num = dex_file.NumCallSiteIds(); i != num; ++i) {
+    CallSiteArrayValueIterator it(dex_file, dex_file.GetCallSiteId(i));
+    builder.Update(it.Size());
+    for (; it.HasNext(); it.Next()) {
+      UpdateWithEncodedValue(&builder, it);
+    }
+  }
+  return builder.Finish();
+}
+
+size_t CompiledMethodCache::DigestHash::operator()(const Digest& digest) const {
+  size_t hash;
+  memcpy(&hash, digest.data(), sizeof(hash));
+  return hash;
+}
+
+CompiledMethodCache::CompiledMethodCache(const std::string& fingerprint,
+                                         const std::vector<const DexFile*>& dex_files,
+                                         const std::vector<const DexFile*>& other_dex_files,
+                                         const ProfileCompilationInfo* profile)
+    : profile_(profile),
+      fingerprint_digest_(
+          ComputeFingerprintDigest(fingerprint, profile, dex_files, other_dex_files)),
+      dex_files_(dex_files),
+      num_compiled_dex_files_(dex_files.size()),
+      save_entries_(false),
+      lock_("compiled method cache lock"),
+      num_hits_(0u),
+      num_misses_(0u) {
+  dex_files_.insert(dex_files_.end(), other_dex_files.begin(), other_dex_files.end());
+  for (size_t i = 0; i != dex_files_.size(); ++i) {
+    // Keep the first index if a dex file is listed twice.
+    dex_file_indexes_.emplace(dex_files_[i], dchecked_integral_cast<uint32_t>(i));
+  }
+}
+
+CompiledMethodCache::~CompiledMethodCache() {}
+
+CompiledMethodCache::Digest CompiledMethodCache::ComputeClassDigest(
+    const DexFile& dex_file,
+    uint32_t dex_file_index,
+    uint16_t class_def_idx,
+    const Digest& ids_digest,
+    const std::vector<uint32_t>& type_to_class,
+    /*out*/ std::vector<uint32_t>* referenced_classes) const {
+  auto add_type = [&](dex::TypeIndex type_index) {
+    if (type_index.IsValid() && type_to_class[type_index.index_] != kNoClass) {
+      referenced_classes->push_back(type_to_class[type_index.index_]);
+    }
+  };
+
+  DigestBuilder builder;
+  // Patches refer to dex files by their index, so the index is part of the digest.
+  builder.Update(dex_file_index);
+  builder.Update(ids_digest);
+
+  const dex::ClassDef& class_def = dex_file.GetClassDef(class_def_idx);
+  builder.Update(static_cast<uint32_t>(class_def.class_idx_.index_));
+  builder.Update(class_def.access_flags_);
+  builder.Update(static_cast<uint32_t>(class_def.superclass_idx_.index_));
+  add_type(class_def.superclass_idx_);
+  const dex::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+  uint32_t num_interfaces = (interfaces != nullptr) ? interfaces->Size() : 0u;
+  builder.Update(num_interfaces);
+  for (uint32_t i = 0; i != num_interfaces; ++i) {
+    dex::TypeIndex type_index = interfaces->GetTypeItem(i).type_idx_;
+    builder.Update(static_cast<uint32_t>(type_index.index_));
+    add_type(type_index);
+  }
+  builder.Update(static_cast<uint32_t>(
+      annotations::HasDeadReferenceSafeAnnotation(dex_file, class_def) ? 1u : 0u));
+
+  for (EncodedStaticFieldValueIterator it(dex_file, class_def); it.HasNext(); it.Next()) {
+    UpdateWithEncodedValue(&builder, it);
+  }
+
+  ClassAccessor accessor(dex_file, class_def);
+  builder.Update(accessor.NumStaticFields());
+  builder.Update(accessor.NumInstanceFields());
+  builder.Update(accessor.NumDirectMethods());
+  builder.Update(accessor.NumVirtualMethods());
+  for (const ClassAccessor::Field& field : accessor.GetFields()) {
+    builder.Update(field.GetIndex());
+    builder.Update(field.GetAccessFlags());
+    builder.Update(field.GetHiddenapiFlags());
+    builder.Update(static_cast<uint32_t>(
+        annotations::FieldIsReachabilitySensitive(dex_file, class_def, field.GetIndex())
+            ? 1u : 0u));
+  }
+  for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+    builder.Update(method.GetIndex());
+    builder.Update(method.GetAccessFlags());
+    builder.Update(method.GetHiddenapiFlags());
+    builder.Update(static_cast<uint32_t>(
+        annotations::MethodIsReachabilitySensitive(dex_file, class_def, method.GetIndex())
+            ? 1u : 0u));
+    // The types of the arguments and of the return value seed reference type propagation.
+    const dex::ProtoId& proto_id =
+        dex_file.GetMethodPrototype(dex_file.GetMethodId(method.GetIndex()));
+    add_type(proto_id.return_type_idx_);
+    const dex::TypeList* params = dex_file.GetProtoParameters(proto_id);
+    for (uint32_t p = 0, num_params = (params != nullptr) ? params->Size() : 0u;
+         p != num_params;
+         ++p) {
+      add_type(params->GetTypeItem(p).type_idx_);
+    }
+
+    // Inlining the method into methods of other classes uses its inline caches.
+    if (profile_ != nullptr) {
+      UpdateWithInlineCaches(
+          &builder, *profile_, MethodReference(&dex_file, method.GetIndex()), dex_files_);
+    }
+
+    CodeItemDataAccessor code(dex_file, method.GetCodeItem());
+    if (!code.HasCodeItem()) {
+      builder.Update(0u);
+      continue;
+    }
+    builder.Update(1u);
+    builder.Update(static_cast<uint32_t>(code.RegistersSize()));
+    builder.Update(static_cast<uint32_t>(code.InsSize()));
+    builder.Update(static_cast<uint32_t>(code.OutsSize()));
+    builder.Update(code.InsnsSizeInCodeUnits());
+    builder.Update(code.Insns(), code.InsnsSizeInCodeUnits() * sizeof(uint16_t));
+    builder.Update(static_cast<uint32_t>(code.TriesSize()));
+    for (const dex::TryItem& try_item : code.TryItems()) {
+      builder.Update(try_item.start_addr_);
+      builder.Update(static_cast<uint32_t>(try_item.insn_count_));
+      for (CatchHandlerIterator it(code, try_item); it.HasNext(); it.Next()) {
+        builder.Update(static_cast<uint32_t>(it.GetHandlerTypeIndex().index_));
+        builder.Update(it.GetHandlerAddress());
+        add_type(it.GetHandlerTypeIndex());
+      }
+    }
+
+    for (const DexInstructionPcPair& inst : code) {
+      Instruction::Code opcode = inst->Opcode();
+      Instruction::IndexType index_type = Instruction::IndexTypeOf(opcode);
+      if (index_type == Instruction::kIndexNone) {
+        continue;
+      }
+      uint32_t index = (Instruction::FormatOf(opcode) == Instruction::k22c)
+          ? inst->VRegC_22c()
+          : inst->VRegB();
+      switch (index_type) {
+        case Instruction::kIndexTypeRef:
+          add_type(dex::TypeIndex(index));
+          break;
+        case Instruction::kIndexFieldRef: {
+          const dex::FieldId& field_id = dex_file.GetFieldId(index);
+          add_type(field_id.class_idx_);
+          add_type(field_id.type_idx_);
+          break;
+        }
+        case Instruction::kIndexMethodRef:
+        case Instruction::kIndexMethodAndProtoRef: {
+          const dex::MethodId& method_id = dex_file.GetMethodId(index);
+          add_type(method_id.class_idx_);
+          add_type(dex_file.GetProtoId(method_id.proto_idx_).return_type_idx_);
+          break;
+        }
+        default:
+          // Strings, call sites, method handles and protos are covered by the ids digest.
+          break;
+      }
+    }
+  }
+  return builder.Finish();
+}
+
+void CompiledMethodCache::ComputeClassDigests() {
+  DCHECK(class_digests_.empty());
+  uint32_t num_classes = 0u;
+  for (size_t i = 0; i != num_compiled_dex_files_; ++i) {
+    class_def_offsets_.push_back(num_classes);
+    num_classes += dex_files_[i]->NumClassDefs();
+  }
+
+  // Map descriptors to classes. As with the class loader, the first definition wins.
+  std::unordered_map<std::string_view, uint32_t> class_by_descriptor;
+  for (size_t i = 0; i != num_compiled_dex_files_; ++i) {
+    const DexFile& dex_file = *dex_files_[i];
+    for (uint32_t class_def_idx = 0; class_def_idx != dex_file.NumClassDefs(); ++class_def_idx) {
+      const dex::ClassDef& class_def = dex_file.GetClassDef(class_def_idx);
+      class_by_descriptor.emplace(dex_file.StringByTypeIdx(class_def.class_idx_),
+                                  class_def_offsets_[i] + class_def_idx);
+    }
+  }
+
+  // Compute the digest of each class on its own and record the classes it references
+  // in `edges` with the references of class `c` at [edge_starts[c], edge_starts[c + 1]).
+  std::vector<Digest> own_digests;
+  own_digests.reserve(num_classes);
+  std::vector<uint32_t> edge_starts;
+  edge_starts.reserve(num_classes + 1u);
+  std::vector<uint32_t> edges;
+  std::vector<uint32_t> referenced_classes;
+  for (size_t i = 0; i != num_compiled_dex_files_; ++i) {
+    const DexFile& dex_file = *dex_files_[i];
+    Digest ids_digest = ComputeIdsDigest(dex_file);
+    std::vector<uint32_t> type_to_class(dex_file.NumTypeIds(), kNoClass);
+    for (size_t t = 0; t != type_to_class.size(); ++t) {
+      std::string_view descriptor = dex_file.StringByTypeIdx(dex::TypeIndex(t));
+      size_t dims = descriptor.find_first_not_of('[');
+      if (dims != std::string_view::npos && descriptor[dims] == 'L') {
+        auto it = class_by_descriptor.find(descriptor.substr(dims));
+        if (it != class_by_descriptor.end()) {
+          type_to_class[t] = it->second;
+        }
+      }
+    }
+    for (uint32_t class_def_idx = 0; class_def_idx != dex_file.NumClassDefs(); ++class_def_idx) {
+      uint32_t class_index = class_def_offsets_[i] + class_def_idx;
+      referenced_classes.clear();
+      own_digests.push_back(ComputeClassDigest(dex_file,
+                                               dchecked_integral_cast<uint32_t>(i),
+                                               class_def_idx,
+                                               ids_digest,
+                                               type_to_class,
+                                               &referenced_classes));
+      std::sort(referenced_classes.begin(), referenced_classes.end());
+      referenced_classes.erase(
+          std::unique(referenced_classes.begin(), referenced_classes.end()),
+          referenced_classes.end());
+      edge_starts.push_back(dchecked_integral_cast<uint32_t>(edges.size()));
+      for (uint32_t referenced_class : referenced_classes) {
+        if (referenced_class != class_index) {
+          edges.push_back(referenced_class);
+        }
+      }
+    }
+  }
+  edge_starts.push_back(dchecked_integral_cast<uint32_t>(edges.size()));
+
+  // Compute the closure digests over the strongly connected components of the reference
+  // graph with an iterative Tarjan's algorithm. Components are completed in reverse
+  // topological order, so the closure digests of all components referenced from a
+  // component are known by the time it is completed. All classes of a component share
+  // the same closure digest; it depends only on the content of the classes, not on the
+  // traversal order.
+  static constexpr uint32_t kUnvisited = static_cast<uint32_t>(-1);
+  class_digests_.resize(num_classes);
+  std::vector<uint32_t> visit_index(num_classes, kUnvisited);
+  std::vector<uint32_t> low_link(num_classes);
+  std::vector<uint32_t> component(num_classes, kUnvisited);
+  std::vector<uint32_t> component_stack;
+  std::vector<std::pair<uint32_t, uint32_t>> dfs_stack;  // Class and next edge to visit.
+  std::vector<uint32_t> members;
+  std::vector<Digest> referenced_digests;
+  uint32_t next_visit_index = 0u;
+  auto visit = [&](uint32_t class_index) {
+    visit_index[class_index] = next_visit_index;
+    low_link[class_index] = next_visit_index;
+    ++next_visit_index;
+    component_stack.push_back(class_index);
+    dfs_stack.emplace_back(class_index, edge_starts[class_index]);
+  };
+  for (uint32_t root = 0; root != num_classes; ++root) {
+    if (visit_index[root] != kUnvisited) {
+      continue;
+    }
+    visit(root);
+    while (!dfs_stack.empty()) {
+      uint32_t class_index = dfs_stack.back().first;
+      uint32_t edge = dfs_stack.back().second;
+      if (edge != edge_starts[class_index + 1u]) {
+        dfs_stack.back().second = edge + 1u;
+        uint32_t target = edges[edge];
+        if (visit_index[target] == kUnvisited) {
+          visit(target);
+        } else if (component[target] == kUnvisited) {
+          // Still on the component stack.
+          low_link[class_index] = std::min(low_link[class_index], visit_index[target]);
+        }
+        continue;
+      }
+      dfs_stack.pop_back();
+      if (!dfs_stack.empty()) {
+        uint32_t parent = dfs_stack.back().first;
+        low_link[parent] = std::min(low_link[parent], low_link[class_index]);
+      }
+      if (low_link[class_index] != visit_index[class_index]) {
+        continue;
+      }
+      // `class_index` is the root of a component; pop it off the stack.
+      members.clear();
+      uint32_t member;
+      do {
+        member = component_stack.back();
+        component_stack.pop_back();
+        component[member] = class_index;
+        members.push_back(member);
+      } while (member != class_index);
+      std::sort(members.begin(), members.end());
+      referenced_digests.clear();
+      for (uint32_t m : members) {
+        for (uint32_t e = edge_starts[m], end = edge_starts[m + 1u]; e != end; ++e) {
+          if (component[edges[e]] != class_index) {
+            referenced_digests.push_back(class_digests_[edges[e]]);
+          }
+        }
+      }
+      std::sort(referenced_digests.begin(), referenced_digests.end());
+      referenced_digests.erase(
+          std::unique(referenced_digests.begin(), referenced_digests.end()),
+          referenced_digests.end());
+      DigestBuilder builder;
+      builder.Update(static_cast<uint32_t>(members.size()));
+      for (uint32_t m : members) {
+        builder.Update(own_digests[m]);
+      }
+      builder.Update(static_cast<uint32_t>(referenced_digests.size()));
+      for (const Digest& digest : referenced_digests) {
+        builder.Update(digest);
+      }
+      Digest closure_digest = builder.Finish();
+      for (uint32_t m : members) {
+        class_digests_[m] = closure_digest;
+      }
+    }
+  }
+  DCHECK(component_stack.empty());
+}
+
+CompiledMethodCache::Digest CompiledMethodCache::GetKey(const DexFile& dex_file,
+                                                        uint16_t class_def_idx,
+                                                        uint32_t method_idx,
+                                                        uint32_t access_flags) const {
+  auto it = dex_file_indexes_.find(&dex_file);
+  DCHECK(it != dex_file_indexes_.end());
+  DCHECK_LT(it->second, num_compiled_dex_files_);
+  DCHECK(!class_def_offsets_.empty()) << "Class digests have not been computed";
+  DigestBuilder builder;
+  builder.Update(fingerprint_digest_);
+  builder.Update(class_digests_[class_def_offsets_[it->second] + class_def_idx]);
+  builder.Update(it->second);
+  builder.Update(static_cast<uint32_t>(class_def_idx));
+  builder.Update(method_idx);
+  builder.Update(access_flags);
+  // The hotness of the method decides which of its call sites the inliner treats as cold.
+  // Its inline caches are covered by the closure digest of its class.
+  if (profile_ != nullptr) {
+    MethodReference method_ref(&dex_file, method_idx);
+    builder.Update(profile_->GetMethodHotness(method_ref).IsHot() ? 2u : 1u);
+  } else {
+    builder.Update(0u);
+  }
+  return builder.Finish();
+}
+
+bool CompiledMethodCache::Encode(const CompiledMethod* compiled_method,
+                                 CompiledMethodStorage* storage,
+                                 /*out*/ std::vector<uint8_t>* data) const {
+  ByteWriter writer(data);
+  writer.WriteU8(static_cast<uint8_t>(compiled_method->GetInstructionSet()));
+  writer.WriteU8(compiled_method->IsIntrinsic() ? 1u : 0u);
+  writer.WriteBlob(compiled_method->GetQuickCode());
+  writer.WriteBlob(compiled_method->GetVmapTable());
+  writer.WriteBlob(compiled_method->GetCFIInfo());
+  ArrayRef<const linker::LinkerPatch> patches = compiled_method->GetPatches();
+  writer.WriteU32(dchecked_integral_cast<uint32_t>(patches.size()));
+  for (const linker::LinkerPatch& patch : patches) {
+    const DexFile* target_dex_file = nullptr;
+    uint32_t value1 = 0u;
+    uint32_t value2 = 0u;
+    bool has_thunk = false;
+    switch (patch.GetType()) {
+      case linker::LinkerPatch::Type::kIntrinsicReference:
+        value1 = patch.IntrinsicData();
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kDataBimgRelRo:
+        value1 = patch.BootImageOffset();
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kMethodRelative:
+      case linker::LinkerPatch::Type::kMethodBssEntry:
+        target_dex_file = patch.TargetMethod().dex_file;
+        value1 = patch.TargetMethod().index;
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kCallRelative:
+        target_dex_file = patch.TargetMethod().dex_file;
+        value1 = patch.TargetMethod().index;
+        has_thunk = true;
+        break;
+      case linker::LinkerPatch::Type::kTypeRelative:
+      case linker::LinkerPatch::Type::kTypeBssEntry:
+        target_dex_file = patch.TargetTypeDexFile();
+        value1 = patch.TargetTypeIndex().index_;
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kStringRelative:
+      case linker::LinkerPatch::Type::kStringBssEntry:
+        target_dex_file = patch.TargetStringDexFile();
+        value1 = patch.TargetStringIndex().index_;
+        value2 = patch.PcInsnOffset();
+        break;
+      case linker::LinkerPatch::Type::kCallEntrypoint:
+        value1 = patch.EntrypointOffset();
+        has_thunk = true;
+        break;
+      case linker::LinkerPatch::Type::kBakerReadBarrierBranch:
+        value1 = patch.GetBakerCustomValue1();
+        value2 = patch.GetBakerCustomValue2();
+        has_thunk = true;
+        break;
+    }
+    uint32_t dex_file_index = kNoDexFile;
+    if (target_dex_file != nullptr) {
+      auto it = dex_file_indexes_.find(target_dex_file);
+      if (it == dex_file_indexes_.end()) {
+        return false;
+      }
+      dex_file_index = it->second;
+    }
+    writer.WriteU8(static_cast<uint8_t>(patch.GetType()));
+    writer.WriteU32(dchecked_integral_cast<uint32_t>(patch.LiteralOffset()));
+    writer.WriteU32(dex_file_index);
+    writer.WriteU32(value1);
+    writer.WriteU32(value2);
+    // Thunks are shared between methods, so store them with every patch that uses one.
+    std::string debug_name;
+    ArrayRef<const uint8_t> thunk_code =
+        has_thunk ? storage->GetThunkCode(patch, &debug_name) : ArrayRef<const uint8_t>();
+    writer.WriteBlob(thunk_code);
+    writer.WriteBlob(ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(debug_name.data()),
+                                             debug_name.size()));
+  }
+  return true;
+}
+
+CompiledMethod* CompiledMethodCache::Decode(ArrayRef<const uint8_t> data,
+                                            CompiledMethodStorage* storage) const {
+  ByteReader reader(data);
+  uint8_t isa;
+  uint8_t is_intrinsic;
+  ArrayRef<const uint8_t> code;
+  ArrayRef<const uint8_t> vmap_table;
+  ArrayRef<const uint8_t> cfi_info;
+  uint32_t num_patches;
+  if (!reader.ReadU8(&isa) ||
+      isa > static_cast<uint8_t>(InstructionSet::kLast) ||
+      !reader.ReadU8(&is_intrinsic) ||
+      !reader.ReadBlob(&code) ||
+      !reader.ReadBlob(&vmap_table) ||
+      !reader.ReadBlob(&cfi_info) ||
+      !reader.ReadU32(&num_patches)) {
+    return nullptr;
+  }
+  std::vector<linker::LinkerPatch> patches;
+  std::vector<std::tuple<size_t, ArrayRef<const uint8_t>, std::string>> thunks;
+  for (uint32_t i = 0; i != num_patches; ++i) {
+    uint8_t type;
+    uint32_t literal_offset;
+    uint32_t dex_file_index;
+    uint32_t value1;
+    uint32_t value2;
+    ArrayRef<const uint8_t> thunk_code;
+    ArrayRef<const uint8_t> debug_name;
+    if (!reader.ReadU8(&type) ||
+        type > static_cast<uint8_t>(linker::LinkerPatch::Type::kBakerReadBarrierBranch) ||
+        !reader.ReadU32(&literal_offset) ||
+        literal_offset >= code.size() ||
+        !reader.ReadU32(&dex_file_index) ||
+        (dex_file_index != kNoDexFile && dex_file_index >= dex_files_.size()) ||
+        !reader.ReadU32(&value1) ||
+        !reader.ReadU32(&value2) ||
+        !reader.ReadBlob(&thunk_code) ||
+        !reader.ReadBlob(&debug_name)) {
+      return nullptr;
+    }
+    const DexFile* dex_file = (dex_file_index != kNoDexFile) ? dex_files_[dex_file_index] : nullptr;
+    using Type = linker::LinkerPatch::Type;
+    Type patch_type = static_cast<Type>(type);
+    bool needs_dex_file = patch_type == Type::kMethodRelative ||
+                          patch_type == Type::kMethodBssEntry ||
+                          patch_type == Type::kCallRelative ||
+                          patch_type == Type::kTypeRelative ||
+                          patch_type == Type::kTypeBssEntry ||
+                          patch_type == Type::kStringRelative ||
+                          patch_type == Type::kStringBssEntry;
+    if (needs_dex_file != (dex_file != nullptr)) {
+      return nullptr;
+    }
+    switch (patch_type) {
+      case Type::kIntrinsicReference:
+        patches.push_back(
+            linker::LinkerPatch::IntrinsicReferencePatch(literal_offset, value2, value1));
+        break;
+      case Type::kDataBimgRelRo:
+        patches.push_back(linker::LinkerPatch::DataBimgRelRoPatch(literal_offset, value2, value1));
+        break;
+      case Type::kMethodRelative:
+        patches.push_back(
+            linker::LinkerPatch::RelativeMethodPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case Type::kMethodBssEntry:
+        patches.push_back(
+            linker::LinkerPatch::MethodBssEntryPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case Type::kCallRelative:
+        patches.push_back(linker::LinkerPatch::RelativeCodePatch(literal_offset, dex_file, value1));
+        break;
+      case Type::kTypeRelative:
+        patches.push_back(
+            linker::LinkerPatch::RelativeTypePatch(literal_offset, dex_file, value2, value1));
+        break;
+      case Type::kTypeBssEntry:
+        patches.push_back(
+            linker::LinkerPatch::TypeBssEntryPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case Type::kStringRelative:
+        patches.push_back(
+            linker::LinkerPatch::RelativeStringPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case Type::kStringBssEntry:
+        patches.push_back(
+            linker::LinkerPatch::StringBssEntryPatch(literal_offset, dex_file, value2, value1));
+        break;
+      case Type::kCallEntrypoint:
+        patches.push_back(linker::LinkerPatch::CallEntrypointPatch(literal_offset, value1));
+        break;
+      case Type::kBakerReadBarrierBranch:
+        patches.push_back(
+            linker::LinkerPatch::BakerReadBarrierBranchPatch(literal_offset, value1, value2));
+        break;
+    }
+    if (!thunk_code.empty()) {
+      thunks.emplace_back(patches.size() - 1u,
+                          thunk_code,
+                          std::string(reinterpret_cast<const char*>(debug_name.data()),
+                                      debug_name.size()));
+    }
+  }
+  if (!reader.IsAtEnd()) {
+    return nullptr;
+  }
+
+  for (const auto& [patch_index, thunk_code, debug_name] : thunks) {
+    const linker::LinkerPatch& patch = patches[patch_index];
+    if (storage->GetThunkCode(patch).empty()) {
+      storage->SetThunkCode(patch, thunk_code, debug_name);
+    }
+  }
+  CompiledMethod* compiled_method = CompiledMethod::SwapAllocCompiledMethod(
+      storage,
+      static_cast<InstructionSet>(isa),
+      code,
+      vmap_table,
+      cfi_info,
+      ArrayRef<const linker::LinkerPatch>(patches));
+  if (is_intrinsic != 0u) {
+    compiled_method->MarkAsIntrinsic();
+  }
+  return compiled_method;
+}
+
+std::string CompiledMethodCache::GetFileName() const {
+  DigestBuilder builder;
+  builder.Update(fingerprint_digest_);
+  builder.Update(dchecked_integral_cast<uint32_t>(num_compiled_dex_files_));
+  for (size_t i = 0; i != num_compiled_dex_files_; ++i) {
+    builder.Update(std::string_view(dex_files_[i]->GetLocation()));
+  }
+  Digest digest = builder.Finish();
+  std::string name;
+  for (uint8_t byte : digest) {
+    name += StringPrintf("%02x", byte);
+  }
+  return name + ".cmc";
+}
+
+CompiledMethod* CompiledMethodCache::Lookup(const Digest& key, CompiledMethodStorage* storage) {
+  std::vector<uint8_t> data;
+  auto it = loaded_entries_.find(key);
+  if (it != loaded_entries_.end()) {
+    data.assign(it->second.begin(), it->second.end());
+  }
+  CompiledMethod* compiled_method =
+      !data.empty() ? Decode(ArrayRef<const uint8_t>(data), storage) : nullptr;
+  if (compiled_method == nullptr) {
+    num_misses_.fetch_add(1u, std::memory_order_relaxed);
+    return nullptr;
+  }
+  num_hits_.fetch_add(1u, std::memory_order_relaxed);
+  if (save_entries_) {
+    MutexLock mu(Thread::Current(), lock_);
+    entries_.emplace(key, std::move(data));
+  }
+  return compiled_method;
+}
+
+void CompiledMethodCache::Insert(const Digest& key,
+                                 const CompiledMethod* compiled_method,
+                                 CompiledMethodStorage* storage) {
+  std::vector<uint8_t> data;
+  if (!Encode(compiled_method, storage, &data)) {
+    return;
+  }
+  if (save_entries_) {
+    MutexLock mu(Thread::Current(), lock_);
+    entries_.emplace(key, std::move(data));
+  }
+}
+
+bool CompiledMethodCache::Load(const std::string& filename, /*out*/ std::string* error_msg) {
+  std::unique_ptr<File> file(OS::OpenFileForReading(filename.c_str()));
+  if (file == nullptr) {
+    *error_msg = StringPrintf("Failed to open '%s' for reading", filename.c_str());
+    return false;
+  }
+  int64_t length = file->GetLength();
+  if (length < 0) {
+    *error_msg = StringPrintf("Failed to get the length of '%s'", filename.c_str());
+    return false;
+  }
+  loaded_data_.resize(static_cast<size_t>(length));
+  if (!file->ReadFully(loaded_data_.data(), loaded_data_.size())) {
+    *error_msg = StringPrintf("Failed to read '%s'", filename.c_str());
+    return false;
+  }
+
+  ByteReader reader{ArrayRef<const uint8_t>(loaded_data_)};
+  ArrayRef<const uint8_t> magic;
+  ArrayRef<const uint8_t> version;
+  ArrayRef<const uint8_t> fingerprint_digest;
+  uint32_t num_entries;
+  if (!reader.ReadBytes(sizeof(kCacheMagic), &magic) ||
+      memcmp(magic.data(), kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      !reader.ReadBytes(sizeof(kCacheVersion), &version) ||
+      memcmp(version.data(), kCacheVersion, sizeof(kCacheVersion)) != 0) {
+    *error_msg = StringPrintf("Invalid compiled method cache header in '%s'", filename.c_str());
+    return false;
+  }
+  if (!reader.ReadBytes(kDigestSize, &fingerprint_digest) ||
+      memcmp(fingerprint_digest.data(), fingerprint_digest_.data(), kDigestSize) != 0) {
+    // Nothing can be reused, the compilation environment changed.
+    VLOG(compiler) << "Ignoring compiled method cache '" << filename << "' with different inputs";
+    loaded_data_.clear();
+    return true;
+  }
+  if (!reader.ReadU32(&num_entries)) {
+    *error_msg = StringPrintf("Truncated compiled method cache '%s'", filename.c_str());
+    return false;
+  }
+  loaded_entries_.reserve(num_entries);
+  for (uint32_t i = 0; i != num_entries; ++i) {
+    ArrayRef<const uint8_t> key;
+    ArrayRef<const uint8_t> data;
+    if (!reader.ReadBytes(kDigestSize, &key) || !reader.ReadBlob(&data)) {
+      *error_msg = StringPrintf("Truncated compiled method cache '%s'", filename.c_str());
+      loaded_entries_.clear();
+      return false;
+    }
+    Digest digest;
+    std::copy(key.begin(), key.end(), digest.begin());
+    loaded_entries_.emplace(digest, data);
+  }
+  return true;
+}
+
+bool CompiledMethodCache::Save(const std::string& filename, /*out*/ std::string* error_msg) {
+  DCHECK(save_entries_);
+  std::vector<uint8_t> data;
+  ByteWriter writer(&data);
+  writer.WriteBytes(ArrayRef<const uint8_t>(kCacheMagic));
+  writer.WriteBytes(ArrayRef<const uint8_t>(kCacheVersion));
+  writer.WriteBytes(ArrayRef<const uint8_t>(fingerprint_digest_));
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    writer.WriteU32(dchecked_integral_cast<uint32_t>(entries_.size()));
+    for (const auto& [key, entry] : entries_) {
+      writer.WriteBytes(ArrayRef<const uint8_t>(key));
+      writer.WriteBlob(ArrayRef<const uint8_t>(entry));
+    }
+  }
+
+  // Write to a unique temporary file and rename it, so that readers in other processes
+  // never see a partially written file.
+  std::string temp_filename = StringPrintf("%s.%d.%d", filename.c_str(), getpid(), GetTid());
+  std::unique_ptr<File> file(OS::CreateEmptyFile(temp_filename.c_str()));
+  if (file == nullptr) {
+    *error_msg = StringPrintf("Failed to create '%s'", temp_filename.c_str());
+    return false;
+  }
+  if (!file->WriteFully(data.data(), data.size())) {
+    *error_msg = StringPrintf("Failed to write '%s'", temp_filename.c_str());
+    file->Erase(/*unlink=*/ true);
+    return false;
+  }
+  if (file->FlushCloseOrErase() != 0) {
+    *error_msg = StringPrintf("Failed to flush and close '%s'", temp_filename.c_str());
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+    *error_msg = StringPrintf("Failed to rename '%s' to '%s': %s",
+                              temp_filename.c_str(),
+                              filename.c_str(),
+                              strerror(errno));
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace art
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
+#define ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/array_ref.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompiledMethodStorage;
+class DexFile;
+class ProfileCompilationInfo;
+
+// Keeps compiled methods across dex2oat invocations so that an incremental
+// build only needs to compile the classes that changed. The entries are kept in a
+// file written by one invocation for the next.
+//
+// A method is keyed by a digest of the compilation environment (see `fingerprint`
+// below), the method index and access flags, and the closure digest of its
+// declaring class. The closure digest covers the definition and code of the class,
+// the id tables of its dex file, and the closure digests of every class the class
+// refers to (superclass, interfaces, and types, fields and methods used by its
+// code). The compiler only ever inlines or makes assumptions about classes
+// reachable that way, so equal keys mean that the compiler would produce the
+// same code.
+//
+// With a profile, the key also covers the hotness of the method, and the own digest
+// of each class covers the inline caches of its methods. The compiler uses the inline
+// caches of a method both when compiling it and when inlining it, so they belong with
+// the class like its code does. Editing the profile data of one method therefore only
+// invalidates the methods that can see it, not the whole compilation.
+//
+// Compiled code refers to strings, types and methods by their dex file indexes, so
+// the key also covers the id tables of the dex file and its position among the dex
+// files being compiled. Entries are therefore only shared by invocations compiling
+// the same dex files, or edits of them; a library bundled into the dex files of
+// different apps gets different keys in each of them.
+class CompiledMethodCache {
+ public:
+  static constexpr size_t kDigestSize = 32u;  // SHA-256.
+  using Digest = std::array<uint8_t, kDigestSize>;
+
+  // The `fingerprint` must describe every compilation input that is not part of the
+  // `dex_files` being compiled, such as the compiler options, the boot class path
+  // checksums and the class loader context. The `other_dex_files` are the boot class
+  // path and class path dex files, in a stable order, that linker patches may refer to.
+  // The `profile`, if any, must not be part of the `fingerprint`.
+  CompiledMethodCache(const std::string& fingerprint,
+                      const std::vector<const DexFile*>& dex_files,
+                      const std::vector<const DexFile*>& other_dex_files,
+                      const ProfileCompilationInfo* profile);
+  ~CompiledMethodCache();
+
+  // Loads the entries saved by a previous invocation. Entries saved with a different
+  // fingerprint are ignored.
+  bool Load(const std::string& filename, /*out*/ std::string* error_msg);
+
+  // Keeps the entries looked up or inserted by this invocation for `Save()`.
+  void EnableSaving() {
+    save_entries_ = true;
+  }
+
+  // Saves the entries that were looked up or inserted by this invocation. The file is
+  // replaced atomically, so concurrent invocations may load and save the same file.
+  bool Save(const std::string& filename, /*out*/ std::string* error_msg);
+
+  // Returns a file name for the entries of this invocation that only depends on the
+  // `fingerprint` and the locations of the dex files being compiled. Successive
+  // compilations of an app can use it to find each other's entries in a shared
+  // directory.
+  std::string GetFileName() const;
+
+  // Computes the closure digests of all classes of the dex files being compiled.
+  // Must be called before `GetKey()`.
+  void ComputeClassDigests() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  Digest GetKey(const DexFile& dex_file,
+                uint16_t class_def_idx,
+                uint32_t method_idx,
+                uint32_t access_flags) const;
+
+  // Returns a new compiled method for `key` allocated in `storage`, or null if
+  // there is no matching entry.
+  CompiledMethod* Lookup(const Digest& key, CompiledMethodStorage* storage);
+
+  // Records the `compiled_method` for `key`. Methods with linker patches referencing
+  // dex files we do not know about are not recorded.
+  void Insert(const Digest& key,
+              const CompiledMethod* compiled_method,
+              CompiledMethodStorage* storage);
+
+  size_t GetNumberOfHits() const {
+    return num_hits_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetNumberOfMisses() const {
+    return num_misses_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct DigestHash {
+    size_t operator()(const Digest& digest) const;
+  };
+
+  Digest ComputeClassDigest(const DexFile& dex_file,
+                            uint32_t dex_file_index,
+                            uint16_t class_def_idx,
+                            const Digest& ids_digest,
+                            const std::vector<uint32_t>& type_to_class,
+                            /*out*/ std::vector<uint32_t>* referenced_classes) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  bool Encode(const CompiledMethod* compiled_method,
+              CompiledMethodStorage* storage,
+              /*out*/ std::vector<uint8_t>* data) const;
+  CompiledMethod* Decode(ArrayRef<const uint8_t> data, CompiledMethodStorage* storage) const;
+
+  const ProfileCompilationInfo* const profile_;
+
+  // Covers the `fingerprint` and the profile data of the `other_dex_files`.
+  const Digest fingerprint_digest_;
+
+  // The dex files being compiled followed by the `other_dex_files`.
+  std::vector<const DexFile*> dex_files_;
+  std::unordered_map<const DexFile*, uint32_t> dex_file_indexes_;
+  const size_t num_compiled_dex_files_;
+
+  // Index of the first class of each dex file being compiled in `class_digests_`.
+  std::vector<uint32_t> class_def_offsets_;
+  std::vector<Digest> class_digests_;
+
+  // Entries loaded from a previous invocation. Immutable after `Load()`.
+  std::vector<uint8_t> loaded_data_;
+  std::unordered_map<Digest, ArrayRef<const uint8_t>, DigestHash> loaded_entries_;
+
+  bool save_entries_;
+  Mutex lock_;
+  // Entries to be saved by this invocation, ordered for deterministic output.
+  std::map<Digest, std::vector<uint8_t>> entries_ GUARDED_BY(lock_);
+
+  std::atomic<size_t> num_hits_;
+  std::atomic<size_t> num_misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompiledMethodCache);
+};
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
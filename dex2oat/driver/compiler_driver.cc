@@ -22,6 +22,7 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -34,6 +35,7 @@
 #include "art_method-inl.h"
 #include "base/arena_allocator.h"
 #include "base/array_ref.h"
+#include "base/bit_utils.h"
 #include "base/bit_vector.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG
@@ -55,6 +57,7 @@
 #include "dex/dex_to_dex_compiler.h"
 #include "dex/verification_results.h"
 #include "dex/verified_method.h"
+#include "driver/compiled_method_cache.h"
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
 #include "gc/accounting/card_table-inl.h"
@@ -266,6 +269,7 @@ CompilerDriver::CompilerDriver(
       parallel_thread_count_(thread_count),
       stats_(new AOTCompilationStats),
       compiled_method_storage_(swap_fd),
+      compiled_method_cache_(nullptr),
       max_arena_alloc_(0),
       dex_to_dex_compiler_(this) {
   DCHECK(compiler_options_ != nullptr);
@@ -586,15 +590,27 @@ static void CompileMethodQuick(
               driver->ShouldCompileBasedOnProfile(method_ref);
 
       if (compile) {
-        // NOTE: if compiler declines to compile this method, it will return null.
-        compiled_method = driver->GetCompiler()->Compile(code_item,
-                                                         access_flags,
-                                                         invoke_type,
-                                                         class_def_idx,
-                                                         method_idx,
-                                                         class_loader,
-                                                         dex_file,
-                                                         dex_cache);
+        // Reuse the code compiled by a previous invocation if none of its inputs changed.
+        CompiledMethodCache* cache = driver->GetCompiledMethodCache();
+        CompiledMethodCache::Digest cache_key = {};
+        if (cache != nullptr) {
+          cache_key = cache->GetKey(dex_file, class_def_idx, method_idx, access_flags);
+          compiled_method = cache->Lookup(cache_key, driver->GetCompiledMethodStorage());
+        }
+        if (compiled_method == nullptr) {
+          // NOTE: if compiler declines to compile this method, it will return null.
+          compiled_method = driver->GetCompiler()->Compile(code_item,
+                                                           access_flags,
+                                                           invoke_type,
+                                                           class_def_idx,
+                                                           method_idx,
+                                                           class_loader,
+                                                           dex_file,
+                                                           dex_cache);
+          if (cache != nullptr && compiled_method != nullptr) {
+            cache->Insert(cache_key, compiled_method, driver->GetCompiledMethodStorage());
+          }
+        }
         ProfileMethodsCheck check_type =
             driver->GetCompilerOptions().CheckProfiledMethodsCompiled();
         if (UNLIKELY(check_type != ProfileMethodsCheck::kNone)) {
@@ -2057,6 +2073,60 @@ class VerifyClassVisitor : public CompilationVisitor {
   const uint32_t sdk_version_;
 };
 
+// Returns the class def indexes of `dex_file` in the order in which to verify them with
+// several threads. Classes are grouped by the magnitude of their code size and the groups
+// with the most code come first, so that verifying a large class does not keep one thread
+// busy at the end while the others are idle. Within a group, superclasses defined in the
+// same dex file come before their subclasses, so that verifying a subclass is less likely
+// to wait for another thread verifying its superclass.
+static std::vector<uint32_t> GetVerificationOrder(const DexFile& dex_file) {
+  struct ClassInfo {
+    uint32_t code_size_bits;
+    uint32_t depth;
+    uint32_t class_def_index;
+  };
+  const uint32_t num_class_defs = dex_file.NumClassDefs();
+  std::vector<uint32_t> type_to_class_def(dex_file.NumTypeIds(), dex::kDexNoIndex);
+  for (uint32_t i = 0; i != num_class_defs; ++i) {
+    type_to_class_def[dex_file.GetClassDef(i).class_idx_.index_] = i;
+  }
+  std::vector<ClassInfo> classes;
+  classes.reserve(num_class_defs);
+  for (uint32_t i = 0; i != num_class_defs; ++i) {
+    const dex::ClassDef& class_def = dex_file.GetClassDef(i);
+    // Superclasses are defined before their subclasses in a valid dex file.
+    uint32_t depth = 0u;
+    if (class_def.superclass_idx_.IsValid()) {
+      uint32_t superclass_index = type_to_class_def[class_def.superclass_idx_.index_];
+      if (superclass_index < i) {
+        depth = classes[superclass_index].depth + 1u;
+      }
+    }
+    uint32_t code_size = 0u;
+    for (const ClassAccessor::Method& method : ClassAccessor(dex_file, i).GetMethods()) {
+      code_size += method.GetInstructions().InsnsSizeInCodeUnits();
+    }
+    classes.push_back({MinimumBitsToStore(code_size), depth, i});
+  }
+  std::sort(classes.begin(),
+            classes.end(),
+            [](const ClassInfo& lhs, const ClassInfo& rhs) {
+              if (lhs.code_size_bits != rhs.code_size_bits) {
+                return lhs.code_size_bits > rhs.code_size_bits;
+              }
+              if (lhs.depth != rhs.depth) {
+                return lhs.depth < rhs.depth;
+              }
+              return lhs.class_def_index < rhs.class_def_index;
+            });
+  std::vector<uint32_t> order;
+  order.reserve(num_class_defs);
+  for (const ClassInfo& info : classes) {
+    order.push_back(info.class_def_index);
+  }
+  return order;
+}
+
 void CompilerDriver::VerifyDexFile(jobject class_loader,
                                    const DexFile& dex_file,
                                    const std::vector<const DexFile*>& dex_files,
@@ -2073,7 +2143,15 @@ void CompilerDriver::VerifyDexFile(jobject class_loader,
                               ? verifier::HardFailLogMode::kLogInternalFatal
                               : verifier::HardFailLogMode::kLogWarning;
   VerifyClassVisitor visitor(&context, log_level);
-  context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  if (thread_count > 1u) {
+    std::vector<uint32_t> order = GetVerificationOrder(dex_file);
+    context.ForAllLambda(0,
+                         order.size(),
+                         [&visitor, &order](size_t index) { visitor.Visit(order[index]); },
+                         thread_count);
+  } else {
+    context.ForAll(0, dex_file.NumClassDefs(), &visitor, thread_count);
+  }
 
   // Make initialized classes visibly initialized.
   class_linker->MakeInitializedClassesVisiblyInitialized(Thread::Current(), /*wait=*/ true);
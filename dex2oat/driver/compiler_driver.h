@@ -61,6 +61,7 @@ class VerifierDepsTest;
 class ArtField;
 class BitVector;
 class CompiledMethod;
+class CompiledMethodCache;
 class CompilerOptions;
 class DexCompilationUnit;
 class DexFile;
@@ -229,6 +230,15 @@ class CompilerDriver {
     return dex_to_dex_compiler_;
   }
 
+  // Set the cache to reuse compiled code from and record compiled code into. Not owned.
+  void SetCompiledMethodCache(CompiledMethodCache* cache) {
+    compiled_method_cache_ = cache;
+  }
+
+  CompiledMethodCache* GetCompiledMethodCache() const {
+    return compiled_method_cache_;
+  }
+
  private:
   void LoadImageClasses(TimingLogger* timings, /*inout*/ HashSet<std::string>* image_classes)
       REQUIRES(!Locks::mutator_lock_);
@@ -336,6 +346,9 @@ class CompilerDriver {
 
   CompiledMethodStorage compiled_method_storage_;
 
+  // Compiled code of previous invocations, or null.
+  CompiledMethodCache* compiled_method_cache_;
+
   size_t max_arena_alloc_;
 
   // Compiler for dex to dex (quickening).
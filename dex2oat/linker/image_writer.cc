@@ -19,7 +19,9 @@
 #include <lz4.h>
 #include <lz4hc.h>
 #include <sys/stat.h>
+#include <zdict.h>
 #include <zlib.h>
+#include <zstd.h>
 
 #include <memory>
 #include <numeric>
@@ -80,6 +82,7 @@
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "subtype_check.h"
+#include "thread_pool.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "well_known_classes.h"
 
@@ -92,8 +95,24 @@ using ::art::mirror::String;
 namespace art {
 namespace linker {
 
+// Compression level for zstd. Higher levels improve the compression ratio only slightly
+// but are much slower, decompression speed does not depend on the level.
+static constexpr int kZstdCompressionLevel = 12;
+
+// Only train a zstd dictionary on images with at least this many blocks.
+static constexpr size_t kMinBlocksForDictionary = 2u;
+
+// Size of the samples, and maximum total size of the samples relative to the dictionary size,
+// used to train a zstd dictionary.
+static constexpr size_t kDictionarySampleSize = 4 * KB;
+static constexpr size_t kDictionarySamplesRatio = 100u;
+
+using ZstdCDictPtr = std::unique_ptr<ZSTD_CDict, decltype(&ZSTD_freeCDict)>;
+
 static ArrayRef<const uint8_t> MaybeCompressData(ArrayRef<const uint8_t> source,
                                                  ImageHeader::StorageMode image_storage_mode,
+                                                 ArrayRef<const uint8_t> dictionary,
+                                                 const ZSTD_CDict* zstd_dictionary,
                                                  /*out*/ std::vector<uint8_t>* storage) {
   const uint64_t compress_start_time = NanoTime();
 
@@ -120,6 +139,27 @@ static ArrayRef<const uint8_t> MaybeCompressData(ArrayRef<const uint8_t> source,
       storage->resize(data_size);
       break;
     }
+    case ImageHeader::kStorageModeZstd: {
+      storage->resize(ZSTD_compressBound(source.size()));
+      ZSTD_CCtx* context = ZSTD_createCCtx();
+      size_t data_size = (zstd_dictionary != nullptr)
+          ? ZSTD_compress_usingCDict(context,
+                                     storage->data(),
+                                     storage->size(),
+                                     source.data(),
+                                     source.size(),
+                                     zstd_dictionary)
+          : ZSTD_compressCCtx(context,
+                              storage->data(),
+                              storage->size(),
+                              source.data(),
+                              source.size(),
+                              kZstdCompressionLevel);
+      ZSTD_freeCCtx(context);
+      CHECK(!ZSTD_isError(data_size)) << ZSTD_getErrorName(data_size);
+      storage->resize(data_size);
+      break;
+    }
     case ImageHeader::kStorageModeUncompressed: {
       return source;
     }
@@ -129,23 +169,77 @@ static ArrayRef<const uint8_t> MaybeCompressData(ArrayRef<const uint8_t> source,
     }
   }
 
-  DCHECK(image_storage_mode == ImageHeader::kStorageModeLZ4 ||
-         image_storage_mode == ImageHeader::kStorageModeLZ4HC);
   VLOG(compiler) << "Compressed from " << source.size() << " to " << storage->size() << " in "
                  << PrettyDuration(NanoTime() - compress_start_time);
   if (kIsDebugBuild) {
     std::vector<uint8_t> decompressed(source.size());
-    const size_t decompressed_size = LZ4_decompress_safe(
-        reinterpret_cast<char*>(storage->data()),
-        reinterpret_cast<char*>(decompressed.data()),
-        storage->size(),
-        decompressed.size());
-    CHECK_EQ(decompressed_size, decompressed.size());
+    ImageHeader::Block block(image_storage_mode,
+                             /*data_offset=*/ 0u,
+                             /*data_size=*/ storage->size(),
+                             /*image_offset=*/ 0u,
+                             /*image_size=*/ source.size());
+    std::string error_msg;
+    CHECK(block.Decompress(decompressed.data(), storage->data(), dictionary, &error_msg))
+        << error_msg;
     CHECK_EQ(memcmp(source.data(), decompressed.data(), source.size()), 0) << image_storage_mode;
   }
   return ArrayRef<const uint8_t>(*storage);
 }
 
+// Train a zstd dictionary on evenly spread samples of the `data`. Returns an empty
+// dictionary if training fails, for example because there is too little data.
+static std::vector<uint8_t> TrainDictionary(ArrayRef<const uint8_t> data, size_t max_size) {
+  const size_t num_chunks = data.size() / kDictionarySampleSize;
+  const size_t max_samples = max_size * kDictionarySamplesRatio / kDictionarySampleSize;
+  const size_t stride = std::max<size_t>(1u, num_chunks / std::max<size_t>(1u, max_samples));
+  std::vector<uint8_t> samples;
+  std::vector<size_t> sample_sizes;
+  for (size_t chunk = 0; chunk < num_chunks; chunk += stride) {
+    ArrayRef<const uint8_t> sample = data.SubArray(chunk * kDictionarySampleSize,
+                                                   kDictionarySampleSize);
+    samples.insert(samples.end(), sample.begin(), sample.end());
+    sample_sizes.push_back(sample.size());
+  }
+  std::vector<uint8_t> dictionary(max_size);
+  const uint64_t train_start_time = NanoTime();
+  size_t dictionary_size = ZDICT_trainFromBuffer(dictionary.data(),
+                                                 dictionary.size(),
+                                                 samples.data(),
+                                                 sample_sizes.data(),
+                                                 sample_sizes.size());
+  if (ZDICT_isError(dictionary_size)) {
+    VLOG(compiler) << "Failed to train image dictionary: " << ZDICT_getErrorName(dictionary_size);
+    return std::vector<uint8_t>();
+  }
+  dictionary.resize(dictionary_size);
+  VLOG(compiler) << "Trained image dictionary of size " << dictionary_size << " from "
+                 << samples.size() << " bytes in " << PrettyDuration(NanoTime() - train_start_time);
+  return dictionary;
+}
+
+// Calls `function(begin, end)` for consecutive chunks of `[0, size)`, on the `thread_pool`
+// if there is one and there is more than one chunk. Chunks run with the mutator lock held.
+template <typename Function>
+static void ForEachChunk(ThreadPool* thread_pool, size_t size, const Function& function)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  static constexpr size_t kChunkSize = 1024u;
+  if (thread_pool == nullptr || size <= kChunkSize) {
+    function(0u, size);
+    return;
+  }
+  Thread* const self = Thread::Current();
+  for (size_t begin = 0u; begin < size; begin += kChunkSize) {
+    const size_t end = std::min(begin + kChunkSize, size);
+    thread_pool->AddTask(self, new FunctionTask([&function, begin, end](Thread* worker) {
+      ScopedObjectAccess soa(worker);
+      function(begin, end);
+    }));
+  }
+  // Go to native since we don't want to suspend while holding the mutator lock.
+  ScopedThreadSuspension sts(self, kNative);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+}
+
 // Separate objects into multiple bins to optimize dirty memory use.
 static constexpr bool kBinObjects = true;
 
@@ -413,11 +507,19 @@ bool ImageWriter::Write(int image_fd,
   CHECK_EQ(image_filenames.size(), oat_filenames_.size());
 
   Thread* const self = Thread::Current();
+  // Thread pool for copying and compressing the images. The work is split so that the output
+  // does not depend on the number of threads.
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (thread_count_ > 1u) {
+    thread_pool.reset(new ThreadPool("Image writer thread pool", thread_count_ - 1u));
+    thread_pool->StartWorkers(self);
+  }
+
   {
     ScopedObjectAccess soa(self);
     for (size_t i = 0; i < oat_filenames_.size(); ++i) {
       CreateHeader(i, component_count);
-      CopyAndFixupNativeData(i);
+      CopyAndFixupNativeData(i, thread_pool.get());
     }
   }
 
@@ -425,7 +527,7 @@ bool ImageWriter::Write(int image_fd,
     // TODO: heap validation can't handle these fix up passes.
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->DisableObjectValidation();
-    CopyAndFixupObjects();
+    CopyAndFixupObjects(thread_pool.get());
   }
 
   if (compiler_options_.IsAppImage()) {
@@ -493,14 +595,57 @@ bool ImageWriter::Write(int image_fd,
     image_checksum = adler32(image_checksum,
                              reinterpret_cast<const uint8_t*>(image_header),
                              sizeof(ImageHeader));
-    // Copy and compress blocks.
+    const size_t num_blocks = block_sources.size();
+
+    // Train a dictionary shared by the zstd compressed blocks. A dictionary mostly helps
+    // small blocks that cannot find enough redundancy on their own.
+    std::vector<uint8_t> dictionary;
+    ZstdCDictPtr zstd_dictionary(nullptr, ZSTD_freeCDict);
+    if (image_storage_mode_ == ImageHeader::kStorageModeZstd &&
+        compiler_options_.ImageDictionarySize() != 0u &&
+        num_blocks >= kMinBlocksForDictionary) {
+      ArrayRef<const uint8_t> image_data(image_info.image_.Begin() + sizeof(ImageHeader),
+                                         image_header->GetImageSize() - sizeof(ImageHeader));
+      dictionary = TrainDictionary(image_data, compiler_options_.ImageDictionarySize());
+      if (!dictionary.empty()) {
+        zstd_dictionary.reset(
+            ZSTD_createCDict(dictionary.data(), dictionary.size(), kZstdCompressionLevel));
+        CHECK(zstd_dictionary != nullptr);
+      }
+    }
+
+    // Compress blocks. Blocks are compressed independently, so we can compress them in
+    // parallel. The compressed data is still written out in block order below.
+    std::vector<std::vector<uint8_t>> compressed_data(num_blocks);
+    std::vector<ArrayRef<const uint8_t>> block_data(num_blocks);
+    static constexpr size_t kMinBlocks = 2u;
+    const bool use_parallel = thread_pool != nullptr && num_blocks >= kMinBlocks;
+    for (size_t block_index = 0; block_index != num_blocks; ++block_index) {
+      auto function = [&, block_index](Thread*) {
+        const std::pair<uint32_t, uint32_t>& block = block_sources[block_index];
+        ArrayRef<const uint8_t> raw_image_data(image_info.image_.Begin() + block.first,
+                                               block.second);
+        block_data[block_index] = MaybeCompressData(raw_image_data,
+                                                    image_storage_mode_,
+                                                    ArrayRef<const uint8_t>(dictionary),
+                                                    zstd_dictionary.get(),
+                                                    &compressed_data[block_index]);
+      };
+      if (use_parallel) {
+        thread_pool->AddTask(self, new FunctionTask(std::move(function)));
+      } else {
+        function(self);
+      }
+    }
+    if (use_parallel) {
+      thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+    }
+
+    // Copy blocks.
     size_t out_offset = sizeof(ImageHeader);
-    for (const std::pair<uint32_t, uint32_t> block : block_sources) {
-      ArrayRef<const uint8_t> raw_image_data(image_info.image_.Begin() + block.first,
-                                             block.second);
-      std::vector<uint8_t> compressed_data;
-      ArrayRef<const uint8_t> image_data =
-          MaybeCompressData(raw_image_data, image_storage_mode_, &compressed_data);
+    for (size_t block_index = 0; block_index != num_blocks; ++block_index) {
+      const std::pair<uint32_t, uint32_t>& block = block_sources[block_index];
+      ArrayRef<const uint8_t> image_data = block_data[block_index];
 
       if (!is_compressed) {
         // For uncompressed, preserve alignment since the image will be directly mapped.
@@ -541,6 +686,19 @@ bool ImageWriter::Write(int image_fd,
       image_header->blocks_offset_ = out_offset;
       image_header->blocks_count_ = blocks.size();
       out_offset += blocks_bytes;
+
+      // Write the dictionary, if any, after the block metadata.
+      if (!dictionary.empty()) {
+        if (!image_file->PwriteFully(dictionary.data(), dictionary.size(), out_offset)) {
+          PLOG(ERROR) << "Failed to write image dictionary " << image_filename;
+          image_file->Erase();
+          return false;
+        }
+        image_header->dictionary_offset_ = out_offset;
+        image_header->dictionary_size_ = dictionary.size();
+        out_offset += dictionary.size();
+        image_checksum = adler32(image_checksum, dictionary.data(), dictionary.size());
+      }
     }
 
     // Data size includes everything except the bitmap.
@@ -2790,74 +2948,87 @@ void ImageWriter::CopyAndFixupImtConflictTable(ImtConflictTable* orig, ImtConfli
   }
 }
 
-void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
+void ImageWriter::CopyAndFixupNativeObject(void* orig,
+                                           const NativeObjectRelocation& relocation,
+                                           size_t oat_index) {
   const ImageInfo& image_info = GetImageInfo(oat_index);
-  // Copy ArtFields and methods to their locations and update the array for convenience.
-  for (auto& pair : native_object_relocations_) {
-    NativeObjectRelocation& relocation = pair.second;
-    // Only work with fields and methods that are in the current oat file.
-    if (relocation.oat_index != oat_index) {
-      continue;
+  auto* dest = image_info.image_.Begin() + relocation.offset;
+  DCHECK_GE(dest, image_info.image_.Begin() + image_info.image_end_);
+  DCHECK(!IsInBootImage(orig));
+  switch (relocation.type) {
+    case NativeObjectRelocationType::kArtField: {
+      memcpy(dest, orig, sizeof(ArtField));
+      CopyAndFixupReference(
+          reinterpret_cast<ArtField*>(dest)->GetDeclaringClassAddressWithoutBarrier(),
+          reinterpret_cast<ArtField*>(orig)->GetDeclaringClass());
+      break;
     }
-    auto* dest = image_info.image_.Begin() + relocation.offset;
-    DCHECK_GE(dest, image_info.image_.Begin() + image_info.image_end_);
-    DCHECK(!IsInBootImage(pair.first));
-    switch (relocation.type) {
-      case NativeObjectRelocationType::kArtField: {
-        memcpy(dest, pair.first, sizeof(ArtField));
-        CopyAndFixupReference(
-            reinterpret_cast<ArtField*>(dest)->GetDeclaringClassAddressWithoutBarrier(),
-            reinterpret_cast<ArtField*>(pair.first)->GetDeclaringClass());
-        break;
-      }
-      case NativeObjectRelocationType::kRuntimeMethod:
-      case NativeObjectRelocationType::kArtMethodClean:
-      case NativeObjectRelocationType::kArtMethodDirty: {
-        CopyAndFixupMethod(reinterpret_cast<ArtMethod*>(pair.first),
-                           reinterpret_cast<ArtMethod*>(dest),
-                           oat_index);
-        break;
-      }
-      // For arrays, copy just the header since the elements will get copied by their corresponding
-      // relocations.
-      case NativeObjectRelocationType::kArtFieldArray: {
-        memcpy(dest, pair.first, LengthPrefixedArray<ArtField>::ComputeSize(0));
-        break;
-      }
-      case NativeObjectRelocationType::kArtMethodArrayClean:
-      case NativeObjectRelocationType::kArtMethodArrayDirty: {
-        size_t size = ArtMethod::Size(target_ptr_size_);
-        size_t alignment = ArtMethod::Alignment(target_ptr_size_);
-        memcpy(dest, pair.first, LengthPrefixedArray<ArtMethod>::ComputeSize(0, size, alignment));
-        // Clear padding to avoid non-deterministic data in the image.
-        // Historical note: We also did that to placate Valgrind.
-        reinterpret_cast<LengthPrefixedArray<ArtMethod>*>(dest)->ClearPadding(size, alignment);
-        break;
-      }
-      case NativeObjectRelocationType::kDexCacheArray:
-        // Nothing to copy here, everything is done in FixupDexCache().
-        break;
-      case NativeObjectRelocationType::kIMTable: {
-        ImTable* orig_imt = reinterpret_cast<ImTable*>(pair.first);
-        ImTable* dest_imt = reinterpret_cast<ImTable*>(dest);
-        CopyAndFixupImTable(orig_imt, dest_imt);
-        break;
-      }
-      case NativeObjectRelocationType::kIMTConflictTable: {
-        auto* orig_table = reinterpret_cast<ImtConflictTable*>(pair.first);
-        CopyAndFixupImtConflictTable(
-            orig_table,
-            new(dest)ImtConflictTable(orig_table->NumEntries(target_ptr_size_), target_ptr_size_));
-        break;
-      }
-      case NativeObjectRelocationType::kGcRootPointer: {
-        auto* orig_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(pair.first);
-        auto* dest_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(dest);
-        CopyAndFixupReference(dest_pointer->AddressWithoutBarrier(), orig_pointer->Read());
-        break;
-      }
+    case NativeObjectRelocationType::kRuntimeMethod:
+    case NativeObjectRelocationType::kArtMethodClean:
+    case NativeObjectRelocationType::kArtMethodDirty: {
+      CopyAndFixupMethod(reinterpret_cast<ArtMethod*>(orig),
+                         reinterpret_cast<ArtMethod*>(dest),
+                         oat_index);
+      break;
+    }
+    // For arrays, copy just the header since the elements will get copied by their corresponding
+    // relocations.
+    case NativeObjectRelocationType::kArtFieldArray: {
+      memcpy(dest, orig, LengthPrefixedArray<ArtField>::ComputeSize(0));
+      break;
+    }
+    case NativeObjectRelocationType::kArtMethodArrayClean:
+    case NativeObjectRelocationType::kArtMethodArrayDirty: {
+      size_t size = ArtMethod::Size(target_ptr_size_);
+      size_t alignment = ArtMethod::Alignment(target_ptr_size_);
+      memcpy(dest, orig, LengthPrefixedArray<ArtMethod>::ComputeSize(0, size, alignment));
+      // Clear padding to avoid non-deterministic data in the image.
+      // Historical note: We also did that to placate Valgrind.
+      reinterpret_cast<LengthPrefixedArray<ArtMethod>*>(dest)->ClearPadding(size, alignment);
+      break;
+    }
+    case NativeObjectRelocationType::kDexCacheArray:
+      // Nothing to copy here, everything is done in FixupDexCache().
+      break;
+    case NativeObjectRelocationType::kIMTable: {
+      ImTable* orig_imt = reinterpret_cast<ImTable*>(orig);
+      ImTable* dest_imt = reinterpret_cast<ImTable*>(dest);
+      CopyAndFixupImTable(orig_imt, dest_imt);
+      break;
+    }
+    case NativeObjectRelocationType::kIMTConflictTable: {
+      auto* orig_table = reinterpret_cast<ImtConflictTable*>(orig);
+      CopyAndFixupImtConflictTable(
+          orig_table,
+          new(dest)ImtConflictTable(orig_table->NumEntries(target_ptr_size_), target_ptr_size_));
+      break;
+    }
+    case NativeObjectRelocationType::kGcRootPointer: {
+      auto* orig_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(orig);
+      auto* dest_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(dest);
+      CopyAndFixupReference(dest_pointer->AddressWithoutBarrier(), orig_pointer->Read());
+      break;
+    }
+  }
+}
+
+void ImageWriter::CopyAndFixupNativeData(size_t oat_index, ThreadPool* thread_pool) {
+  const ImageInfo& image_info = GetImageInfo(oat_index);
+  // Only work with fields and methods that are in the current oat file. Each of them is
+  // copied to its own location, so we can do that in parallel.
+  std::vector<const std::pair<void* const, NativeObjectRelocation>*> relocations;
+  for (const auto& pair : native_object_relocations_) {
+    if (pair.second.oat_index == oat_index) {
+      relocations.push_back(&pair);
     }
   }
+  // Copy ArtFields and methods to their locations.
+  ForEachChunk(thread_pool, relocations.size(), [&](size_t begin, size_t end)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t i = begin; i != end; ++i) {
+      CopyAndFixupNativeObject(relocations[i]->first, relocations[i]->second, oat_index);
+    }
+  });
   // Fixup the image method roots.
   auto* image_header = reinterpret_cast<ImageHeader*>(image_info.image_.Begin());
   for (size_t i = 0; i < ImageHeader::kImageMethodsCount; ++i) {
@@ -2966,7 +3137,8 @@ void ImageWriter::CopyAndFixupObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  image_info.image_bitmap_.Set(dst);  // Mark the obj as live.
+  // Mark the obj as live. Neighbouring objects may be copied concurrently.
+  image_info.image_bitmap_.AtomicTestAndSet(dst);
 
   const size_t n = obj->SizeOf();
 
@@ -3030,12 +3202,23 @@ class ImageWriter::FixupVisitor {
   mirror::Object* const copy_;
 };
 
-void ImageWriter::CopyAndFixupObjects() {
+void ImageWriter::CopyAndFixupObjects(ThreadPool* thread_pool) {
+  // Collect the objects that go into the images. Each object is copied to its own bin slot,
+  // so we can copy and fix them up in parallel.
+  std::vector<Object*> objects;
   auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
     DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
+    if (IsImageBinSlotAssigned(obj)) {
+      objects.push_back(obj);
+    }
   };
   Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  ForEachChunk(thread_pool, objects.size(), [&](size_t begin, size_t end)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t i = begin; i != end; ++i) {
+      CopyAndFixupObject(objects[i]);
+    }
+  });
   // Fill the padding objects since they are required for in order traversal of the image space.
   for (ImageInfo& image_info : image_infos_) {
     for (const size_t start_offset : image_info.padding_offsets_) {
@@ -3059,6 +3242,7 @@ void ImageWriter::CopyAndFixupObjects() {
   }
   // We no longer need the hashcode map, values have already been copied to target objects.
   saved_hashcode_map_.clear();
+  pointer_arrays_.clear();
 }
 
 class ImageWriter::FixupClassVisitor final : public FixupVisitor {
@@ -3184,9 +3368,8 @@ void ImageWriter::FixupObject(Object* orig, Object* copy) {
     // Is this a native pointer array?
     auto it = pointer_arrays_.find(down_cast<mirror::PointerArray*>(orig));
     if (it != pointer_arrays_.end()) {
-      // Should only need to fixup every pointer array exactly once.
+      // Objects are fixed up in parallel, so leave the map unchanged until all are done.
       FixupPointerArray(copy, down_cast<mirror::PointerArray*>(orig), it->second);
-      pointer_arrays_.erase(it);
       return;
     }
   }
@@ -3622,7 +3805,8 @@ ImageWriter::ImageWriter(
     const std::vector<std::string>& oat_filenames,
     const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map,
     jobject class_loader,
-    const HashSet<std::string>* dirty_image_objects)
+    const HashSet<std::string>* dirty_image_objects,
+    size_t thread_count)
     : compiler_options_(compiler_options),
       boot_image_begin_(Runtime::Current()->GetHeap()->GetBootImagesStartAddress()),
       boot_image_size_(Runtime::Current()->GetHeap()->GetBootImagesSize()),
@@ -3637,7 +3821,8 @@ ImageWriter::ImageWriter(
       image_storage_mode_(image_storage_mode),
       oat_filenames_(oat_filenames),
       dex_file_oat_index_map_(dex_file_oat_index_map),
-      dirty_image_objects_(dirty_image_objects) {
+      dirty_image_objects_(dirty_image_objects),
+      thread_count_(thread_count) {
   DCHECK(compiler_options.IsBootImage() ||
          compiler_options.IsBootImageExtension() ||
          compiler_options.IsAppImage());
@@ -69,6 +69,7 @@ class CompilerOptions;
 template<class T> class Handle;
 class ImTable;
 class ImtConflictTable;
+class ThreadPool;
 class TimingLogger;
 
 static constexpr int kInvalidFd = -1;
@@ -84,7 +85,8 @@ class ImageWriter final {
               const std::vector<std::string>& oat_filenames,
               const std::unordered_map<const DexFile*, size_t>& dex_file_oat_index_map,
               jobject class_loader,
-              const HashSet<std::string>* dirty_image_objects);
+              const HashSet<std::string>* dirty_image_objects,
+              size_t thread_count);
 
   /*
    * Modifies the heap and collects information about objects and code so that
@@ -482,9 +484,11 @@ class ImageWriter final {
   void CalculateObjectBinSlots(mirror::Object* obj)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Creates the contiguous image in memory and adjusts pointers.
-  void CopyAndFixupNativeData(size_t oat_index) REQUIRES_SHARED(Locks::mutator_lock_);
-  void CopyAndFixupObjects() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Creates the contiguous image in memory and adjusts pointers. The work is distributed
+  // over the `thread_pool`, if not null.
+  void CopyAndFixupNativeData(size_t oat_index, ThreadPool* thread_pool)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  void CopyAndFixupObjects(ThreadPool* thread_pool) REQUIRES_SHARED(Locks::mutator_lock_);
   void CopyAndFixupObject(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_);
   void CopyAndFixupMethod(ArtMethod* orig, ArtMethod* copy, size_t oat_index)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -596,6 +600,11 @@ class ImageWriter final {
 
   NativeObjectRelocation GetNativeRelocation(void* obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  void CopyAndFixupNativeObject(void* orig,
+                                const NativeObjectRelocation& relocation,
+                                size_t oat_index)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Location of where the object will be when the image is loaded at runtime.
   template <typename T>
   T* NativeLocationInImage(T* obj) REQUIRES_SHARED(Locks::mutator_lock_);
@@ -725,6 +734,9 @@ class ImageWriter final {
   // Set of objects known to be dirty in the image. Can be nullptr if there are none.
   const HashSet<std::string>* dirty_image_objects_;
 
+  // Number of threads used to copy and compress the images.
+  const size_t thread_count_;
+
   // Objects are guaranteed to not cross the region size boundary.
   size_t region_size_ = 0u;
 
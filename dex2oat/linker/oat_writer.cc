@@ -1046,9 +1046,28 @@ struct OatWriter::OrderedMethodData {
     return debug_info_idx != kDebugInfoIdxInvalid;
   }
 
+  // Code regions of the oat file, in layout order. Methods executed during startup come
+  // first, followed by the other hot methods, so that the pages touched at startup and in
+  // steady state are packed together. The remaining methods form the cold region.
+  enum class CodeRegion : uint8_t {
+    kStartup,
+    kHot,
+    kCold,
+  };
+
+  CodeRegion GetCodeRegion() const {
+    if (method_hotness.IsStartup()) {
+      return CodeRegion::kStartup;
+    } else if (method_hotness.IsHot()) {
+      return CodeRegion::kHot;
+    } else {
+      return CodeRegion::kCold;
+    }
+  }
+
   // Bin each method according to the profile flags.
   //
-  // Groups by e.g.
+  // Orders by the code region first and within each region groups by e.g.
   //  -- not hot at all
   //  -- hot
   //  -- hot and startup
@@ -1069,6 +1088,9 @@ struct OatWriter::OrderedMethodData {
     }
 
     // Use the profile's method hotness to determine sort order.
+    if (GetCodeRegion() != other.GetCodeRegion()) {
+      return GetCodeRegion() < other.GetCodeRegion();
+    }
     if (GetMethodHotnessOrder() < other.GetMethodHotnessOrder()) {
       return true;
     }
@@ -1079,7 +1101,7 @@ struct OatWriter::OrderedMethodData {
 
  private:
   // Used to determine relative order for OAT code layout when determining
-  // binning.
+  // binning within a code region.
   size_t GetMethodHotnessOrder() const {
     bool hotness[] = {
       method_hotness.IsHot(),
@@ -1088,9 +1110,9 @@ struct OatWriter::OrderedMethodData {
     };
 
 
-    // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
-    // any memory, it only goes into the buffer cache and does not grow the PSS until the first
-    // time that memory is referenced in the process.
+    // Note: Bin-to-bin order within a region does not matter. If the kernel does or does not
+    // read-ahead any memory, it only goes into the buffer cache and does not grow the PSS until
+    // the first time that memory is referenced in the process.
 
     size_t hotness_bits = 0;
     for (size_t i = 0; i < arraysize(hotness); ++i) {
@@ -1278,6 +1300,13 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
 
   bool VisitComplete() override {
     offset_ = writer_->relative_patcher_->ReserveSpaceEnd(offset_);
+    // Empty trailing regions start at the end of the code.
+    if (hot_code_offset_ == 0u) {
+      hot_code_offset_ = offset_;
+    }
+    if (cold_code_offset_ == 0u) {
+      cold_code_offset_ = offset_;
+    }
     if (generate_debug_info_) {
       std::vector<debug::MethodDebugInfo> thunk_infos =
           relative_patcher_->GenerateThunkDebugInfo(executable_offset_);
@@ -1301,6 +1330,15 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
 
     DCHECK(HasCompiledCode(compiled_method)) << method_ref.PrettyMethod();
 
+    // Record where the hot and cold code regions start. Methods are sorted by region.
+    OrderedMethodData::CodeRegion region = method_data.GetCodeRegion();
+    if (region != OrderedMethodData::CodeRegion::kStartup && hot_code_offset_ == 0u) {
+      hot_code_offset_ = offset_;
+    }
+    if (region == OrderedMethodData::CodeRegion::kCold && cold_code_offset_ == 0u) {
+      cold_code_offset_ = offset_;
+    }
+
     // Derived from CompiledMethod.
     uint32_t quick_code_offset = 0;
 
@@ -1402,6 +1440,14 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
     return offset_;
   }
 
+  size_t GetHotCodeOffset() const {
+    return hot_code_offset_;
+  }
+
+  size_t GetColdCodeOffset() const {
+    return cold_code_offset_;
+  }
+
  private:
   LayoutReserveOffsetCodeMethodVisitor(OatWriter* writer,
                                        size_t offset,
@@ -1451,6 +1497,10 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
   // Offset of the code of the compiled methods.
   size_t offset_;
 
+  // Offsets of the first hot and cold code, or 0 if not reached yet.
+  size_t hot_code_offset_ = 0u;
+  size_t cold_code_offset_ = 0u;
+
   // Deduplication is already done on a pointer basis by the compiler driver,
   // so we can simply compare the pointers to find out if things are duplicated.
   SafeMap<const CompiledMethod*, uint32_t, CodeOffsetsKeyComparator> dedupe_map_;
@@ -1649,10 +1699,14 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
                          OutputStream* out,
                          const size_t file_offset,
                          size_t relative_offset,
+                         bool release_written_code,
                          OrderedMethodList ordered_methods)
       : OrderedMethodVisitor(std::move(ordered_methods)),
         writer_(writer),
         offset_(relative_offset),
+        release_written_code_(release_written_code),
+        release_debug_info_data_(
+            release_written_code && !writer->GetCompilerOptions().GenerateAnyDebugInfo()),
         dex_file_(nullptr),
         pointer_size_(GetInstructionSetPointerSize(writer_->compiler_options_.GetInstructionSet())),
         class_loader_(writer->HasImage() ? writer->image_writer_->GetAppClassLoader() : nullptr),
@@ -1709,18 +1763,18 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
 
     // No thread suspension since dex_cache_ that may get invalidated if that occurs.
     ScopedAssertNoThreadSuspension tsc(__FUNCTION__);
-    DCHECK(HasCompiledCode(compiled_method)) << method_ref.PrettyMethod();
 
     // TODO: cleanup DCHECK_OFFSET_ to accept file_offset as parameter.
     size_t file_offset = file_offset_;  // Used by DCHECK_OFFSET_ macro.
     OutputStream* out = out_;
 
-    ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
-    uint32_t code_size = quick_code.size() * sizeof(uint8_t);
-
-    // Deduplicate code arrays.
+    // Deduplicate code arrays. The code of a method listed more than once, or deduplicated
+    // with an earlier method, has already been written and may have been released.
     const OatMethodOffsets& method_offsets = oat_class->method_offsets_[method_offsets_index];
     if (method_offsets.code_offset_ > offset_) {
+      DCHECK(HasCompiledCode(compiled_method)) << method_ref.PrettyMethod();
+      ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
+      uint32_t code_size = quick_code.size() * sizeof(uint8_t);
       offset_ = writer_->relative_patcher_->WriteThunks(out, offset_);
       if (offset_ == 0u) {
         ReportWriteFailure("relative call thunk", method_ref);
@@ -1864,6 +1918,16 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
     }
     DCHECK_OFFSET_();
 
+    // Nothing reads the code and patches after this point, so release them (and the stack
+    // maps and CFI, which were copied at layout time, unless the debug info still needs
+    // them) to keep the memory use from growing with the size of the oat file.
+    if (release_written_code_) {
+      compiled_method->ReleaseCodeAndPatches();
+      if (release_debug_info_data_) {
+        compiled_method->ReleaseVmapTableAndCFIInfo();
+      }
+    }
+
     return true;
   }
 
@@ -1877,6 +1941,10 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
   // Updated in VisitMethod as methods are written out.
   size_t offset_;
 
+  // Whether to release the data of each compiled method once it has been written.
+  const bool release_written_code_;
+  const bool release_debug_info_data_;
+
   // Potentially varies with every different VisitMethod.
   // Used to determine which DexCache to use when finding ArtMethods.
   const DexFile* dex_file_;
@@ -2263,6 +2331,10 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
     success = layout_reserve_code_visitor.Visit();
     DCHECK(success);
     offset = layout_reserve_code_visitor.GetOffset();
+    if (profile_compilation_info_ != nullptr) {
+      oat_header_->SetCodeRegionOffsets(layout_reserve_code_visitor.GetHotCodeOffset(),
+                                        layout_reserve_code_visitor.GetColdCodeOffset());
+    }
 
     // Save the method order because the WriteCodeMethodVisitor will need this
     // order again.
@@ -2674,7 +2746,7 @@ bool OatWriter::WriteVerifierDeps(OutputStream* vdex_out, verifier::VerifierDeps
   return true;
 }
 
-bool OatWriter::WriteCode(OutputStream* out) {
+bool OatWriter::WriteCode(OutputStream* out, bool release_written_code) {
   CHECK(write_state_ == WriteState::kWriteText);
 
   // Wrap out to update checksum with each write.
@@ -2693,7 +2765,7 @@ bool OatWriter::WriteCode(OutputStream* out) {
     return false;
   }
 
-  relative_offset = WriteCodeDexFiles(out, file_offset, relative_offset);
+  relative_offset = WriteCodeDexFiles(out, file_offset, relative_offset, release_written_code);
   if (relative_offset == 0) {
     LOG(ERROR) << "Failed to write oat code for dex files to " << out->GetLocation();
     return false;
@@ -3112,7 +3184,8 @@ size_t OatWriter::WriteCode(OutputStream* out, size_t file_offset, size_t relati
 
 size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
                                     size_t file_offset,
-                                    size_t relative_offset) {
+                                    size_t relative_offset,
+                                    bool release_written_code) {
   if (!GetCompilerOptions().IsAnyCompilationEnabled()) {
     // As with InitOatCodeDexFiles, also skip the writer if
     // compilation was disabled.
@@ -3132,6 +3205,7 @@ size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
                                  out,
                                  file_offset,
                                  relative_offset,
+                                 release_written_code,
                                  std::move(*ordered_methods_ptr));
   if (UNLIKELY(!visitor.Visit())) {
     return 0;
@@ -193,8 +193,11 @@ class OatWriter {
   void PrepareLayout(MultiOatRelativePatcher* relative_patcher);
   // Write the rest of .rodata section (ClassOffsets[], OatClass[], maps).
   bool WriteRodata(OutputStream* out);
-  // Write the code to the .text section.
-  bool WriteCode(OutputStream* out);
+  // Write the code to the .text section. With `release_written_code`, the code and linker
+  // patches of each compiled method are released as soon as it has been written, as are the
+  // stack maps and CFI when no debug info is generated. The compiled methods cannot be used
+  // to check the written code afterwards.
+  bool WriteCode(OutputStream* out, bool release_written_code = false);
   // Write the boot image relocation data to the .data.bimg.rel.ro section.
   bool WriteDataBimgRelRo(OutputStream* out);
   // Check the size of the written oat file.
@@ -335,7 +338,10 @@ class OatWriter {
   size_t WriteIndexBssMappings(OutputStream* out, size_t file_offset, size_t relative_offset);
   size_t WriteOatDexFiles(OutputStream* out, size_t file_offset, size_t relative_offset);
   size_t WriteCode(OutputStream* out, size_t file_offset, size_t relative_offset);
-  size_t WriteCodeDexFiles(OutputStream* out, size_t file_offset, size_t relative_offset);
+  size_t WriteCodeDexFiles(OutputStream* out,
+                           size_t file_offset,
+                           size_t relative_offset,
+                           bool release_written_code);
   size_t WriteDataBimgRelRo(OutputStream* out, size_t file_offset, size_t relative_offset);
 
   bool RecordOatDataOffset(OutputStream* out);
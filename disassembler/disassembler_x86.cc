@@ -1209,6 +1209,17 @@ DISASSEMBLER_ENTRY(cmp,
           opcode1 = opcode_tmp.c_str();
         }
         break;
+      case 0xD7:
+        if (prefix[2] == 0x66) {
+          src_reg_file = SSE;
+          prefix[2] = 0;  // clear prefix now it's served its purpose as part of the opcode
+        } else {
+          src_reg_file = MMX;
+        }
+        opcode1 = "pmovmskb";
+        has_modrm = true;
+        load = true;
+        break;
       case 0xD8:
       case 0xD9:
       case 0xDA:
@@ -458,6 +458,8 @@ class OatDumper {
                            GetQuickResolutionTrampolineOffset);
     DUMP_OAT_HEADER_OFFSET("QUICK TO INTERPRETER BRIDGE",
                            GetQuickToInterpreterBridgeOffset);
+    DUMP_OAT_HEADER_OFFSET("HOT CODE", GetHotCodeOffset);
+    DUMP_OAT_HEADER_OFFSET("COLD CODE", GetColdCodeOffset);
 #undef DUMP_OAT_HEADER_OFFSET
 
     // Print the key-value store.
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_COMPILATION_KIND_H_
+#define ART_RUNTIME_COMPILATION_KIND_H_
+
+#include <iosfwd>
+#include <stddef.h>
+
+namespace art {
+
+// The kind of code the JIT produces for a method. Apart from kOsr, the kinds
+// are JIT tiers ordered from the cheapest to compile to the most optimized:
+//
+// kBaseline: no optimizations, collects inline caches and hotness.
+// kFast: inlining from inline caches and cheap optimizations only, still counts
+//        hotness to trigger the kOptimized compilation.
+// kOptimized: the full optimizing pipeline.
+enum class CompilationKind {
+  kOsr,
+  kBaseline,
+  kFast,
+  kOptimized,
+  kLast = kOptimized,
+};
+
+static constexpr size_t kNumberOfCompilationKinds =
+    static_cast<size_t>(CompilationKind::kLast) + 1u;
+
+std::ostream& operator<<(std::ostream& os, CompilationKind rhs);
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_COMPILATION_KIND_H_
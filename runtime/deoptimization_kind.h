@@ -30,7 +30,8 @@ enum class DeoptimizationKind {
   kBlockBCE,
   kCHA,
   kFullFrame,
-  kLast = kFullFrame
+  kBaselineOsr,
+  kLast = kBaselineOsr
 };
 
 inline const char* GetDeoptimizationKindName(DeoptimizationKind kind) {
@@ -43,6 +44,7 @@ inline const char* GetDeoptimizationKindName(DeoptimizationKind kind) {
     case DeoptimizationKind::kBlockBCE: return "block bounds check elimination";
     case DeoptimizationKind::kCHA: return "class hierarchy analysis";
     case DeoptimizationKind::kFullFrame: return "full frame";
+    case DeoptimizationKind::kBaselineOsr: return "baseline on-stack replacement";
   }
   LOG(FATAL) << "Unexpected kind " << static_cast<size_t>(kind);
   UNREACHABLE();
@@ -50,6 +52,12 @@ inline const char* GetDeoptimizationKindName(DeoptimizationKind kind) {
 
 std::ostream& operator<<(std::ostream& os, const DeoptimizationKind& kind);
 
+// Returns the bit representing `kind` in a mask of deoptimization kinds, as used
+// by the JIT to record which speculations must not be used when recompiling a method.
+constexpr uint32_t DeoptimizationKindMask(DeoptimizationKind kind) {
+  return 1u << static_cast<uint32_t>(kind);
+}
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_DEOPTIMIZATION_KIND_H_
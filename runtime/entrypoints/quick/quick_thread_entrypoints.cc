@@ -15,16 +15,30 @@
  */
 
 #include "callee_save_frame.h"
+#include "deoptimization_kind.h"
 #include "jit/jit.h"
 #include "runtime.h"
 #include "thread-inl.h"
 
 namespace art {
 
+extern "C" NO_RETURN void artDeoptimizeFromCompiledCode(DeoptimizationKind kind, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
 extern "C" void artTestSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
   // Called when suspend count check value is 0 and thread->suspend_count_ != 0
   ScopedQuickEntrypointChecks sqec(self);
   self->CheckSuspend();
+
+  ArtMethod* baseline_osr_method = self->GetBaselineOsrMethod();
+  if (UNLIKELY(baseline_osr_method != nullptr)) {
+    self->SetBaselineOsrMethod(nullptr);
+    // Move a baseline frame looping at this suspend check to the interpreter, which
+    // enters the OSR compiled code at the loop back edge.
+    if (Runtime::Current()->GetJit()->CanTransferBaselineFrameToOsr(self, baseline_osr_method)) {
+      artDeoptimizeFromCompiledCode(DeoptimizationKind::kBaselineOsr, self);
+    }
+  }
 }
 
 extern "C" void artCompileOptimized(ArtMethod* method, Thread* self)
@@ -20,6 +20,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <random>
 
 #include "android-base/stringprintf.h"
@@ -1209,15 +1210,20 @@ class ImageSpace::Loader {
         Thread* const self = Thread::Current();
         static constexpr size_t kMinBlocks = 2u;
         const bool use_parallel = pool != nullptr && image_header.GetBlockCount() >= kMinBlocks;
+        const ArrayRef<const uint8_t> dictionary = image_header.GetDictionary(temp_map.Begin());
+        std::atomic<bool> failed(false);
         for (const ImageHeader::Block& block : image_header.GetBlocks(temp_map.Begin())) {
           auto function = [&](Thread*) {
             const uint64_t start2 = NanoTime();
-            ScopedTrace trace("LZ4 decompress block");
+            ScopedTrace trace("Decompress image block");
+            std::string block_error_msg;
             bool result = block.Decompress(/*out_ptr=*/map.Begin(),
                                            /*in_ptr=*/temp_map.Begin(),
-                                           error_msg);
-            if (!result && error_msg != nullptr) {
-              *error_msg = "Failed to decompress image block " + *error_msg;
+                                           dictionary,
+                                           &block_error_msg);
+            // Only report the first failure, other blocks may be decompressed concurrently.
+            if (!result && !failed.exchange(true) && error_msg != nullptr) {
+              *error_msg = "Failed to decompress image block " + block_error_msg;
             }
             VLOG(image) << "Decompress block " << block.GetDataSize() << " -> "
                         << block.GetImageSize() << " in " << PrettyDuration(NanoTime() - start2);
@@ -1234,6 +1240,9 @@ class ImageSpace::Loader {
           ScopedThreadSuspension sts(Thread::Current(), kNative);
           pool->Wait(self, true, false);
         }
+        if (failed.load(std::memory_order_relaxed)) {
+          return MemMap::Invalid();
+        }
         const uint64_t time = NanoTime() - start;
         // Add one 1 ns to prevent possible divide by 0.
         VLOG(image) << "Decompressing image took " << PrettyDuration(time) << " ("
@@ -1364,7 +1373,9 @@ class ImageSpace::Loader {
 
     void operator()(mirror::Object* obj) const
         NO_THREAD_SAFETY_ANALYSIS {
-      if (!visited_->Set(obj)) {
+      // Each object is visited only once by this visitor, so we do not need to Set(). This
+      // also lets us visit different parts of the image concurrently.
+      if (!visited_->Test(obj)) {
         // Not already visited.
         obj->VisitReferences</*visit native roots*/false, kVerifyNone, kWithoutReadBarrier>(
             *this,
@@ -1509,7 +1520,33 @@ class ImageSpace::Loader {
       uintptr_t objects_begin = reinterpret_cast<uintptr_t>(target_base + objects_section.Offset());
       uintptr_t objects_end = reinterpret_cast<uintptr_t>(target_base + objects_section.End());
       FixupObjectVisitor<ForwardObject> fixup_object_visitor(&visited_bitmap, forward_object);
-      bitmap->VisitMarkedRange(objects_begin, objects_end, fixup_object_visitor);
+      // With the classes patched above, each object can be patched independently, so we split
+      // the objects section into page ranges and patch them in parallel. Each object is visited
+      // by the range containing its start.
+      Runtime::ScopedThreadPoolUsage stpu;
+      ThreadPool* const pool = stpu.GetThreadPool();
+      static constexpr size_t kChunkSize = 64 * kPageSize;
+      static constexpr size_t kMinChunks = 2u;
+      const bool use_parallel =
+          pool != nullptr && objects_end - objects_begin >= kMinChunks * kChunkSize;
+      if (use_parallel) {
+        Thread* const self = soa.Self();
+        for (uintptr_t begin = objects_begin; begin < objects_end; ) {
+          const uintptr_t end = std::min(RoundDown(begin + kChunkSize, kPageSize), objects_end);
+          pool->AddTask(self, new FunctionTask([=, &fixup_object_visitor](Thread* worker) {
+            ScopedTrace trace("Fixup app image objects");
+            ScopedObjectAccess worker_soa(worker);
+            bitmap->VisitMarkedRange(begin, end, fixup_object_visitor);
+          }));
+          begin = end;
+        }
+        ScopedTrace trace("Waiting for workers");
+        // Go to native since we don't want to suspend while holding the mutator lock.
+        ScopedThreadSuspension sts(self, kNative);
+        pool->Wait(self, true, false);
+      } else {
+        bitmap->VisitMarkedRange(objects_begin, objects_end, fixup_object_visitor);
+      }
       // Fixup image roots.
       CHECK(app_image_objects.InSource(reinterpret_cast<uintptr_t>(
           image_header->GetImageRoots<kWithoutReadBarrier>().Ptr())));
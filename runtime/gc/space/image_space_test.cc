@@ -221,6 +221,90 @@ TEST_F(ImageSpaceTest, StringDeduplication) {
   EXPECT_FALSE(contains_test_string(app_image_space.get()));
 }
 
+TEST_F(ImageSpaceTest, ParallelAppImageRelocation) {
+  ScratchDir scratch;
+  const std::string& scratch_dir = scratch.GetPath();
+  std::string app_jar_name = GetTestDexFileName("LargeAppImage");
+  std::string app_odex_name = scratch_dir + "LargeAppImage.odex";
+  std::string app_image_name = scratch_dir + "LargeAppImage.art";
+  {
+    ArrayRef<const std::string> dex_files(&app_jar_name, /*size=*/ 1u);
+    ScratchFile profile_file;
+    GenerateProfile(dex_files, profile_file.GetFile());
+    std::vector<std::string> argv;
+    std::string error_msg;
+    bool success = StartDex2OatCommandLine(&argv, &error_msg);
+    ASSERT_TRUE(success) << error_msg;
+    argv.insert(argv.end(), {
+        "--profile-file=" + profile_file.GetFilename(),
+        "--dex-file=" + app_jar_name,
+        "--dex-location=" + app_jar_name,
+        "--oat-file=" + app_odex_name,
+        "--app-image-file=" + app_image_name,
+        "--initialize-app-image-classes=true",
+    });
+    success = RunDex2Oat(argv, &error_msg);
+    ASSERT_TRUE(success) << error_msg;
+  }
+
+  std::string error_msg;
+  std::unique_ptr<OatFile> odex_file(OatFile::Open(/*zip_fd=*/ -1,
+                                                   app_odex_name.c_str(),
+                                                   app_odex_name.c_str(),
+                                                   /*executable=*/ false,
+                                                   /*low_4gb=*/ false,
+                                                   app_jar_name,
+                                                   &error_msg));
+  ASSERT_TRUE(odex_file != nullptr) << error_msg;
+
+  // Without the runtime thread pool, the objects are relocated on this thread.
+  std::unique_ptr<ImageSpace> serial_space;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    serial_space = ImageSpace::CreateFromAppImage(
+        app_image_name.c_str(), odex_file.get(), &error_msg);
+  }
+  ASSERT_TRUE(serial_space != nullptr) << error_msg;
+  // The objects must span enough 64-page chunks for the relocation to use the thread pool.
+  const ImageSection& objects_section = serial_space->GetImageHeader().GetObjectsSection();
+  ASSERT_GE(objects_section.Size(), 2u * 64u * kPageSize);
+
+  std::unique_ptr<ImageSpace> parallel_space;
+  Runtime::Current()->CreateThreadPool();
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    parallel_space = ImageSpace::CreateFromAppImage(
+        app_image_name.c_str(), odex_file.get(), &error_msg);
+  }
+  EXPECT_TRUE(Runtime::Current()->DeleteThreadPool());
+  ASSERT_TRUE(parallel_space != nullptr) << error_msg;
+  ASSERT_EQ(objects_section.Size(), parallel_space->GetImageHeader().GetObjectsSection().Size());
+
+  // The two images are at different addresses. Each 32-bit word of the objects must be the
+  // same in both, or be a reference into the respective image at the same offset.
+  const uint32_t serial_begin = reinterpret_cast32<uint32_t>(serial_space->Begin());
+  const uint32_t parallel_begin = reinterpret_cast32<uint32_t>(parallel_space->Begin());
+  ASSERT_NE(serial_begin, parallel_begin);
+  const uint32_t* serial_words =
+      reinterpret_cast<const uint32_t*>(serial_space->Begin() + objects_section.Offset());
+  const uint32_t* parallel_words =
+      reinterpret_cast<const uint32_t*>(parallel_space->Begin() + objects_section.Offset());
+  size_t num_mismatches = 0u;
+  for (size_t i = 0, num_words = objects_section.Size() / sizeof(uint32_t); i != num_words; ++i) {
+    uint32_t serial_word = serial_words[i];
+    uint32_t parallel_word = parallel_words[i];
+    if (kPoisonHeapReferences) {
+      serial_word = -serial_word;
+      parallel_word = -parallel_word;
+    }
+    if (serial_word != parallel_word &&
+        serial_word - serial_begin != parallel_word - parallel_begin) {
+      ++num_mismatches;
+    }
+  }
+  EXPECT_EQ(num_mismatches, 0u);
+}
+
 TEST_F(DexoptTest, ValidateOatFile) {
   std::string dex1 = GetScratchDir() + "/Dex1.jar";
   std::string multidex1 = GetScratchDir() + "/MultiDex1.jar";
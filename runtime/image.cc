@@ -18,6 +18,7 @@
 
 #include <lz4.h>
 #include <sstream>
+#include <zstd.h>
 
 #include "base/bit_utils.h"
 #include "base/length_prefixed_array.h"
@@ -29,7 +30,7 @@
 namespace art {
 
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-const uint8_t ImageHeader::kImageVersion[] = { '0', '8', '5', '\0' };  // Single-image.
+const uint8_t ImageHeader::kImageVersion[] = { '0', '8', '6', '\0' };  // Single-image.
 
 ImageHeader::ImageHeader(uint32_t image_reservation_size,
                          uint32_t component_count,
@@ -171,6 +172,7 @@ PointerSize ImageHeader::GetPointerSize() const {
 
 bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
                                     const uint8_t* in_ptr,
+                                    ArrayRef<const uint8_t> dictionary,
                                     std::string* error_msg) const {
   switch (storage_mode_) {
     case kStorageModeUncompressed: {
@@ -189,6 +191,27 @@ bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
       CHECK_EQ(decompressed_size, image_size_);
       break;
     }
+    case kStorageModeZstd: {
+      ZSTD_DCtx* context = ZSTD_createDCtx();
+      const size_t decompressed_size = ZSTD_decompress_usingDict(
+          context,
+          out_ptr + image_offset_,
+          image_size_,
+          in_ptr + data_offset_,
+          data_size_,
+          dictionary.data(),
+          dictionary.size());
+      ZSTD_freeDCtx(context);
+      if (ZSTD_isError(decompressed_size) || decompressed_size != image_size_) {
+        if (error_msg != nullptr) {
+          *error_msg = ZSTD_isError(decompressed_size)
+              ? std::string(ZSTD_getErrorName(decompressed_size))
+              : "Unexpected decompressed size " + std::to_string(decompressed_size);
+        }
+        return false;
+      }
+      break;
+    }
     default: {
       if (error_msg != nullptr) {
         *error_msg = (std::ostringstream() << "Invalid image format " << storage_mode_).str();
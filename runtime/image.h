@@ -19,6 +19,7 @@
 
 #include <string.h>
 
+#include "base/array_ref.h"
 #include "base/enums.h"
 #include "base/iteration_range.h"
 #include "mirror/object.h"
@@ -78,6 +79,7 @@ class PACKED(8) ImageHeader {
     kStorageModeUncompressed,
     kStorageModeLZ4,
     kStorageModeLZ4HC,
+    kStorageModeZstd,
     kStorageModeCount,  // Number of elements in enum.
   };
   static constexpr StorageMode kDefaultStorageMode = kStorageModeUncompressed;
@@ -96,7 +98,11 @@ class PACKED(8) ImageHeader {
           image_offset_(image_offset),
           image_size_(image_size) {}
 
-    bool Decompress(uint8_t* out_ptr, const uint8_t* in_ptr, std::string* error_msg) const;
+    // The `dictionary` is only used by zstd blocks and may be empty.
+    bool Decompress(uint8_t* out_ptr,
+                    const uint8_t* in_ptr,
+                    ArrayRef<const uint8_t> dictionary,
+                    std::string* error_msg) const;
 
     StorageMode GetStorageMode() const {
       return storage_mode_;
@@ -417,6 +423,11 @@ class PACKED(8) ImageHeader {
     return blocks_count_;
   }
 
+  // Return the dictionary shared by the zstd compressed blocks, empty if there is none.
+  ArrayRef<const uint8_t> GetDictionary(const uint8_t* image_begin) const {
+    return ArrayRef<const uint8_t>(image_begin + dictionary_offset_, dictionary_size_);
+  }
+
  private:
   static const uint8_t kImageMagic[4];
   static const uint8_t kImageVersion[4];
@@ -502,6 +513,10 @@ class PACKED(8) ImageHeader {
   uint32_t blocks_offset_ = 0u;
   uint32_t blocks_count_ = 0u;
 
+  // Dictionary for zstd compressed blocks, stored after the blocks. Size is zero if unused.
+  uint32_t dictionary_offset_ = 0u;
+  uint32_t dictionary_size_ = 0u;
+
   friend class linker::ImageWriter;
 };
 
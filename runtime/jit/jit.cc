@@ -91,11 +91,14 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_jit_compilation_ = options.GetOrDefault(RuntimeArgumentMap::UseJitCompilation);
   jit_options->use_tiered_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseTieredJitCompilation);
+  jit_options->use_baseline_osr_ = options.GetOrDefault(RuntimeArgumentMap::UseBaselineOsr);
 
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
   jit_options->code_cache_max_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheMaxCapacity);
+  jit_options->published_code_capacity_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPublishedCodeCapacity);
   jit_options->dump_info_on_shutdown_ =
       options.Exists(RuntimeArgumentMap::DumpJITInfoOnShutdown);
   jit_options->profile_saver_options_ =
@@ -148,6 +151,11 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   }
   jit_options->osr_threshold_ = RoundUp(jit_options->osr_threshold_, kJitThresholdStep);
 
+  // The fast tier threshold is counted by baseline compiled code in the 16-bit
+  // hotness counter of the ProfilingInfo.
+  jit_options->fast_tier_threshold_ = std::min(
+      options.GetOrDefault(RuntimeArgumentMap::JITFastTierThreshold), kJitMaxThreshold);
+
   // Enforce ordering constraints between thresholds if not jit-on-first-use (when the compile
   // threshold is 0).
   if (jit_options->compile_threshold_ != 0) {
@@ -200,10 +208,43 @@ void Jit::DumpInfo(std::ostream& os) {
   cumulative_timings_.Dump(os);
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
+  DumpCompilationKindStats(os);
+}
+
+void Jit::DumpCompilationKindStats(std::ostream& os) {
+  for (size_t i = 0; i < kNumberOfCompilationKinds; ++i) {
+    const CompilationKindStats& stats = compilation_kind_stats_[i];
+    if (stats.number_of_compilations == 0u) {
+      continue;
+    }
+    os << "JIT " << static_cast<CompilationKind>(i) << " compilations: "
+       << stats.number_of_compilations
+       << ", total time: " << PrettyDuration(stats.compilation_time_ns)
+       << ", mean time: " << PrettyDuration(stats.compilation_time_ns / stats.number_of_compilations)
+       << ", total code size: " << PrettySize(stats.code_size)
+       << ", mean code size: " << PrettySize(stats.code_size / stats.number_of_compilations)
+       << "\n";
+  }
+}
+
+void Jit::AddCompilationTime(CompilationKind compilation_kind, uint64_t duration_ns) {
+  MutexLock mu(Thread::Current(), lock_);
+  CompilationKindStats& stats = compilation_kind_stats_[static_cast<size_t>(compilation_kind)];
+  ++stats.number_of_compilations;
+  stats.compilation_time_ns += duration_ns;
+}
+
+void Jit::AddCodeSize(CompilationKind compilation_kind, size_t bytes) {
+  MutexLock mu(Thread::Current(), lock_);
+  compilation_kind_stats_[static_cast<size_t>(compilation_kind)].code_size += bytes;
 }
 
 void Jit::DumpForSigQuit(std::ostream& os) {
   DumpInfo(os);
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    code_cache_->DumpDeoptimizedMethods(os);
+  }
   ProfileSaver::DumpInstanceInfo(os);
 }
 
@@ -211,9 +252,15 @@ void Jit::AddTimingLogger(const TimingLogger& logger) {
   cumulative_timings_.AddLogger(logger);
 }
 
+class BaselineOsrCheckpoint final : public Closure {
+ public:
+  void Run(Thread* self ATTRIBUTE_UNUSED) override {}
+};
+
 Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
     : code_cache_(code_cache),
       options_(options),
+      baseline_osr_checkpoint_(new BaselineOsrCheckpoint()),
       boot_completed_lock_("Jit::boot_completed_lock_"),
       cumulative_timings_("JIT timings"),
       memory_use_("Memory used for compilation", 16),
@@ -289,7 +336,11 @@ bool Jit::LoadCompilerLibrary(std::string* error_msg) {
   return true;
 }
 
-bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr, bool prejit) {
+bool Jit::CompileMethod(ArtMethod* method,
+                        Thread* self,
+                        CompilationKind compilation_kind,
+                        bool prejit,
+                        uint64_t queue_wait_ns) {
   DCHECK(Runtime::Current()->UseJitCompilation());
   DCHECK(!method->IsRuntimeMethod());
 
@@ -319,7 +370,7 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr
   }
 
   JitMemoryRegion* region = GetCodeCache()->GetCurrentRegion();
-  if (osr && GetCodeCache()->IsSharedRegion(*region)) {
+  if ((compilation_kind == CompilationKind::kOsr) && GetCodeCache()->IsSharedRegion(*region)) {
     VLOG(jit) << "JIT not osr compiling "
               << method->PrettyMethod()
               << " due to using shared region";
@@ -329,20 +380,48 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr
   // If we get a request to compile a proxy method, we pass the actual Java method
   // of that proxy method, as the compiler does not expect a proxy method.
   ArtMethod* method_to_compile = method->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, osr, prejit, baseline, region)) {
+  if (!code_cache_->NotifyCompilationOf(
+          method_to_compile, self, compilation_kind, prejit, region)) {
     return false;
   }
 
+  // Children of a child zygote use the code it published for boot image methods
+  // instead of compiling their own.
+  if (compilation_kind != CompilationKind::kOsr &&
+      !prejit &&
+      code_cache_->UsePublishedCode(method_to_compile)) {
+    code_cache_->DoneCompiling(method_to_compile, self, /* osr= */ false);
+    return true;
+  }
+
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
-            << " osr=" << std::boolalpha << osr
-            << " baseline=" << std::boolalpha << baseline;
-  bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, baseline, osr);
-  code_cache_->DoneCompiling(method_to_compile, self, osr);
+            << " kind=" << compilation_kind;
+  // With the baseline compiler, every request produces baseline code.
+  const CompilationKind compiled_kind =
+      options_->UseBaselineCompiler() ? CompilationKind::kBaseline : compilation_kind;
+  uint64_t start_ns = NanoTime();
+  bool success = jit_compiler_->CompileMethod(
+      self, region, method_to_compile, compilation_kind, queue_wait_ns);
+  if (success) {
+    AddCompilationTime(compiled_kind, NanoTime() - start_ns);
+    if (compilation_kind != CompilationKind::kOsr &&
+        (compiled_kind == CompilationKind::kBaseline || compiled_kind == CompilationKind::kFast)) {
+      // The baseline hotness counter triggers the next tier when it wraps around.
+      // Baseline code moves to the fast tier after `GetFastTierThreshold()` samples,
+      // fast tier code moves to optimized after a full period of the counter.
+      ProfilingInfo* info = method_to_compile->GetProfilingInfo(kRuntimePointerSize);
+      if (info != nullptr) {
+        info->SetBaselineHotnessCount(options_->GetInitialBaselineHotnessCount(compiled_kind));
+        info->SetIsPollingLiveness(false);
+      }
+    }
+  }
+  code_cache_->DoneCompiling(method_to_compile, self, compilation_kind == CompilationKind::kOsr);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
-              << " osr=" << std::boolalpha << osr;
+              << " kind=" << compilation_kind;
   }
   if (kIsDebugBuild) {
     if (self->IsExceptionPending()) {
@@ -759,11 +838,14 @@ class JitCompileTask final : public Task {
     kAllocateProfile,
     kCompile,
     kCompileBaseline,
+    kCompileFast,
     kCompileOsr,
     kPreCompile,
+    kRecompileAfterDeoptimization,
   };
 
-  JitCompileTask(ArtMethod* method, TaskKind kind) : method_(method), kind_(kind), klass_(nullptr) {
+  JitCompileTask(ArtMethod* method, TaskKind kind)
+      : method_(method), kind_(kind), klass_(nullptr), enqueue_time_ns_(NanoTime()) {
     ScopedObjectAccess soa(Thread::Current());
     // For a non-bootclasspath class, add a global ref to the class to prevent class unloading
     // until compilation is done.
@@ -790,13 +872,29 @@ class JitCompileTask final : public Task {
         case TaskKind::kPreCompile:
         case TaskKind::kCompile:
         case TaskKind::kCompileBaseline:
+        case TaskKind::kCompileFast:
         case TaskKind::kCompileOsr: {
           Runtime::Current()->GetJit()->CompileMethod(
               method_,
               self,
-              /* baseline= */ (kind_ == TaskKind::kCompileBaseline),
-              /* osr= */ (kind_ == TaskKind::kCompileOsr),
-              /* prejit= */ (kind_ == TaskKind::kPreCompile));
+              GetCompilationKind(),
+              /* prejit= */ (kind_ == TaskKind::kPreCompile),
+              /* queue_wait_ns= */ NanoTime() - enqueue_time_ns_);
+          break;
+        }
+        case TaskKind::kRecompileAfterDeoptimization: {
+          Runtime::Current()->GetJit()->CompileMethod(
+              method_,
+              self,
+              CompilationKind::kOptimized,
+              /* prejit= */ false,
+              /* queue_wait_ns= */ NanoTime() - enqueue_time_ns_);
+          // Let the next deoptimization, of the code we just compiled, queue a
+          // recompilation again.
+          ProfilingInfo* info = method_->GetProfilingInfo(kRuntimePointerSize);
+          if (info != nullptr) {
+            info->ClearQueuedRecompilation();
+          }
           break;
         }
         case TaskKind::kAllocateProfile: {
@@ -815,9 +913,27 @@ class JitCompileTask final : public Task {
   }
 
  private:
+  CompilationKind GetCompilationKind() const {
+    switch (kind_) {
+      case TaskKind::kCompileBaseline:
+        return CompilationKind::kBaseline;
+      case TaskKind::kCompileFast:
+        return CompilationKind::kFast;
+      case TaskKind::kCompileOsr:
+        return CompilationKind::kOsr;
+      case TaskKind::kPreCompile:
+      case TaskKind::kCompile:
+      case TaskKind::kRecompileAfterDeoptimization:
+      case TaskKind::kAllocateProfile:
+        return CompilationKind::kOptimized;
+    }
+  }
+
   ArtMethod* const method_;
   const TaskKind kind_;
   jobject klass_;
+  // Time the task was created, to report how long it waited in the queue.
+  const uint64_t enqueue_time_ns_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
@@ -1339,7 +1455,7 @@ bool Jit::CompileMethodFromProfile(Thread* self,
       (entry_point == GetQuickResolutionStub())) {
     method->SetPreCompiled();
     if (!add_to_queue) {
-      CompileMethod(method, self, /* baseline= */ false, /* osr= */ false, /* prejit= */ true);
+      CompileMethod(method, self, CompilationKind::kOptimized, /* prejit= */ true);
     } else {
       Task* task = new JitCompileTask(method, JitCompileTask::TaskKind::kPreCompile);
       if (compile_after_boot) {
@@ -1557,8 +1673,10 @@ bool Jit::MaybeCompileMethod(Thread* self,
     if (old_count < HotMethodThreshold() && new_count >= HotMethodThreshold()) {
       if (!code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
         DCHECK(thread_pool_ != nullptr);
+        // Baseline code needs a ProfilingInfo, which zygote regions cannot hold.
         JitCompileTask::TaskKind kind =
-            (options_->UseTieredJitCompilation() || options_->UseBaselineCompiler())
+            (options_->UseTieredJitCompilation() || options_->UseBaselineCompiler()) &&
+                    code_cache_->CanAllocateProfilingInfo()
                 ? JitCompileTask::TaskKind::kCompileBaseline
                 : JitCompileTask::TaskKind::kCompile;
         thread_pool_->AddTask(self, new JitCompileTask(method, kind));
@@ -1583,13 +1701,145 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   if (thread_pool_ == nullptr) {
     return;
   }
-  // We arrive here after a baseline compiled code has reached its baseline
-  // hotness threshold. If tiered compilation is enabled, enqueue a compilation
-  // task that will compile optimize the method.
+  // We arrive here after a baseline or fast tier compiled code has reached its
+  // baseline hotness threshold. If tiered compilation is enabled, enqueue a
+  // compilation task for the next tier: baseline code goes through the fast
+  // tier if enabled, anything else gets compiled optimized.
   if (options_->UseTieredJitCompilation()) {
-    thread_pool_->AddTask(
-        self, new JitCompileTask(method, JitCompileTask::TaskKind::kCompile));
+    JitCompileTask::TaskKind kind = JitCompileTask::TaskKind::kCompile;
+    if (options_->UseFastTierCompilation()) {
+      const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+      if (code_cache_->ContainsPc(entry_point) &&
+          CodeInfo::IsBaseline(
+              OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr())) {
+        kind = JitCompileTask::TaskKind::kCompileFast;
+      }
+    }
+    thread_pool_->AddTask(self, new JitCompileTask(method, kind));
+    if (options_->UseBaselineOsr()) {
+      MaybeRequestBaselineOsr(method, self);
+    }
+  }
+}
+
+// Returns whether `method` has a loop, ie a branch to itself or a previous instruction.
+static bool HasBackwardBranch(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+  for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+    if (inst->IsBranch() && inst->GetTargetOffset() <= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns whether `dex_pc` is the target of a backward branch of `method`, ie a loop header.
+static bool IsLoopHeader(ArtMethod* method, uint32_t dex_pc)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+    if (inst->IsBranch() &&
+        inst->GetTargetOffset() <= 0 &&
+        inst.DexPc() + inst->GetTargetOffset() == dex_pc) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Jit::MaybeRequestBaselineOsr(ArtMethod* method, Thread* self) {
+  if (!HasBackwardBranch(method)) {
+    return;
+  }
+  // Compiled code only reaches the runtime at suspend checks when the thread has
+  // pending flags, so request an empty checkpoint to make the suspend check that
+  // follows the hotness update take the slow path. When the update happened at a
+  // loop back edge, that suspend check is the one of the loop header, which is
+  // what CanTransferBaselineFrameToOsr looks for.
+  self->SetBaselineOsrMethod(method);
+  MutexLock mu(self, *Locks::thread_suspend_count_lock_);
+  self->RequestCheckpoint(baseline_osr_checkpoint_.get());
+}
+
+bool Jit::CanTransferBaselineFrameToOsr(Thread* self, ArtMethod* method) {
+  if (!options_->UseBaselineOsr() ||
+      Runtime::Current()->GetRuntimeCallbacks()->IsMethodBeingInspected(method)) {
+    return false;
+  }
+  // Find the dex pc of the top frame, if it is a non-inlined baseline frame of `method`.
+  // Fast tier and optimized frames don't move to OSR code.
+  uint32_t dex_pc = dex::kDexNoIndex;
+  StackVisitor::WalkStack(
+      [&](const StackVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+        ArtMethod* m = visitor->GetMethod();
+        if (m == nullptr || m->IsRuntimeMethod()) {
+          // The frame of the suspend check entrypoint.
+          return true;
+        }
+        const OatQuickMethodHeader* header = visitor->GetCurrentOatQuickMethodHeader();
+        if (m == method &&
+            visitor->GetCurrentQuickFrame() != nullptr &&
+            !visitor->IsInInlinedFrame() &&
+            header != nullptr &&
+            header->IsOptimized() &&
+            code_cache_->ContainsPc(header->GetCode()) &&
+            CodeInfo::IsBaseline(header->GetOptimizedCodeInfoPtr())) {
+          dex_pc = visitor->GetDexPc(/* abort_on_failure= */ false);
+        }
+        return false;
+      },
+      self,
+      /* context= */ nullptr,
+      StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+  // The suspend check of a loop back edge records the state at the loop header. Any other
+  // suspend check means the hotness count did not overflow at a back edge of the loop.
+  if (dex_pc == dex::kDexNoIndex || !IsLoopHeader(method, dex_pc)) {
+    return false;
+  }
+  const OatQuickMethodHeader* osr_method = code_cache_->LookupOsrMethodHeader(method);
+  if (osr_method == nullptr) {
+    // The loop is hot, compile the OSR code. The frame moves to it at a later overflow of
+    // the hotness count. Duplicate requests are dropped by the code cache when the
+    // compilation starts.
+    if (thread_pool_ != nullptr) {
+      thread_pool_->AddTask(
+          self, new JitCompileTask(method, JitCompileTask::TaskKind::kCompileOsr));
+    }
+    return false;
+  }
+  // The OSR compiled code has its entries at loop headers.
+  if (!CodeInfo(osr_method).GetOsrStackMapForDexPc(dex_pc).IsValid()) {
+    return false;
   }
+  VLOG(jit) << "Moving baseline frame of " << method->PrettyMethod() << " to OSR code";
+  return true;
+}
+
+void Jit::NotifyDeoptimization(ArtMethod* method, Thread* self, DeoptimizationKind kind) {
+  if (kind == DeoptimizationKind::kFullFrame || method->IsNative()) {
+    // Not a failed speculation of the compiled code.
+    return;
+  }
+  ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+  if (info == nullptr) {
+    // Without a profiling info, the method goes through the regular hotness counters.
+    return;
+  }
+  uint16_t number_of_deoptimizations = info->AddDeoptimization(kind);
+  if (number_of_deoptimizations == kDeoptimizationsBeforeDisablingSpeculation) {
+    VLOG(jit) << "Disabling all speculations for " << method->PrettyMethod()
+              << " after " << number_of_deoptimizations << " deoptimizations";
+    info->DisableAllSpeculations();
+  }
+  if (thread_pool_ == nullptr ||
+      number_of_deoptimizations > kMaxEagerRecompilationsAfterDeoptimization) {
+    return;
+  }
+  // Several threads can deoptimize from the same compiled code, only queue the first
+  // recompilation. The other deoptimizations are still recorded above.
+  if (!info->TryQueueRecompilation()) {
+    return;
+  }
+  thread_pool_->AddTask(
+      self, new JitCompileTask(method, JitCompileTask::TaskKind::kRecompileAfterDeoptimization));
 }
 
 class ScopedSetRuntimeThread {
@@ -1740,7 +1990,17 @@ void Jit::PostForkChildAction(bool is_system_server, bool is_zygote) {
         "Methods maps thread");
   }
 
-  if (is_zygote || runtime->IsSafeMode()) {
+  if (is_zygote && !runtime->IsSafeMode() && options_->GetPublishedCodeCapacity() != 0) {
+    // A child zygote runs the same application as its children: compile the methods
+    // that get hot in it in a region they inherit.
+    std::string error_msg;
+    if (!code_cache_->InitializePublishedRegion(options_->GetPublishedCodeCapacity(),
+                                                &error_msg)) {
+      LOG(WARNING) << "Could not create published JIT region: " << error_msg;
+    }
+  }
+
+  if ((is_zygote && !code_cache_->HasPublishedRegion()) || runtime->IsSafeMode()) {
     // Delete the thread pool, we are not going to JIT.
     thread_pool_.reset(nullptr);
     return;
@@ -1749,6 +2009,11 @@ void Jit::PostForkChildAction(bool is_system_server, bool is_zygote) {
   // of the forked child. Parse them again.
   jit_compiler_->ParseCompilerOptions();
 
+  if (is_zygote) {
+    // Like the zygote, a child zygote never collects the code it shares.
+    return;
+  }
+
   // Adjust the status of code cache collection: the status from zygote was to not collect.
   code_cache_->SetGarbageCollectCode(!jit_compiler_->GenerateDebugInfo() &&
       !Runtime::Current()->GetInstrumentation()->AreExitStubsInstalled());
@@ -1775,19 +2040,20 @@ void Jit::PreZygoteFork() {
 }
 
 void Jit::PostZygoteFork() {
-  if (thread_pool_ == nullptr) {
+  if (thread_pool_ == nullptr || code_cache_->HasPublishedRegion()) {
     // If this is a child zygote, check if we need to remap the boot image
-    // methods.
+    // methods. A child zygote only reads the zygote map of its parent.
     if (Runtime::Current()->IsZygote() &&
         fd_methods_ != -1 &&
         code_cache_->GetZygoteMap()->IsCompilationNotified()) {
       ScopedSuspendAll ssa(__FUNCTION__);
       MapBootImageMethods();
     }
-    return;
-  }
-  if (Runtime::Current()->IsZygote() &&
-      code_cache_->GetZygoteMap()->IsCompilationDoneButNotNotified()) {
+    if (thread_pool_ == nullptr) {
+      return;
+    }
+  } else if (Runtime::Current()->IsZygote() &&
+             code_cache_->GetZygoteMap()->IsCompilationDoneButNotNotified()) {
     // Copy the boot image methods data to the mappings we created to share
     // with the children. We do this here as we are the only thread running and
     // we don't risk other threads concurrently updating the ArtMethod's.
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <array>
+#include <limits>
+
 #include <android-base/unique_fd.h>
 
 #include "base/histogram-inl.h"
@@ -24,6 +27,8 @@
 #include "base/mutex.h"
 #include "base/runtime_debug.h"
 #include "base/timing_logger.h"
+#include "compilation_kind.h"
+#include "deoptimization_kind.h"
 #include "handle.h"
 #include "offsets.h"
 #include "interpreter/mterp/mterp.h"
@@ -80,6 +85,10 @@ class JitOptions {
     return osr_threshold_;
   }
 
+  uint16_t GetFastTierThreshold() const {
+    return fast_tier_threshold_;
+  }
+
   uint16_t GetPriorityThreadWeight() const {
     return priority_thread_weight_;
   }
@@ -96,6 +105,12 @@ class JitOptions {
     return code_cache_max_capacity_;
   }
 
+  // Capacity of the region in which a child zygote publishes JIT code for its
+  // children. Zero if it doesn't.
+  size_t GetPublishedCodeCapacity() const {
+    return published_code_capacity_;
+  }
+
   bool DumpJitInfoOnShutdown() const {
     return dump_info_on_shutdown_;
   }
@@ -120,6 +135,29 @@ class JitOptions {
     return use_tiered_jit_compilation_;
   }
 
+  // Whether baseline compiled methods go through the fast tier before being
+  // compiled optimized.
+  bool UseFastTierCompilation() const {
+    return use_tiered_jit_compilation_ && fast_tier_threshold_ != 0;
+  }
+
+  // Returns the value the baseline hotness count of a method starts from when it gets
+  // compiled code of `compilation_kind`, and when the code cache starts polling the
+  // liveness of that code. The code moves to the next tier when the count wraps around.
+  uint16_t GetInitialBaselineHotnessCount(CompilationKind compilation_kind) const {
+    if (UseFastTierCompilation() && compilation_kind == CompilationKind::kBaseline) {
+      return static_cast<uint16_t>(
+          std::numeric_limits<uint16_t>::max() + 1u - fast_tier_threshold_);
+    }
+    return 0u;
+  }
+
+  // Whether loops running in baseline compiled code move to OSR compiled code. Off by
+  // default, enabled with -Xjitbaselineosr:true.
+  bool UseBaselineOsr() const {
+    return use_tiered_jit_compilation_ && use_baseline_osr_;
+  }
+
   bool CanCompileBaseline() const {
     return use_tiered_jit_compilation_ ||
            use_baseline_compiler_ ||
@@ -158,12 +196,15 @@ class JitOptions {
 
   bool use_jit_compilation_;
   bool use_tiered_jit_compilation_;
+  bool use_baseline_osr_;
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
+  size_t published_code_capacity_;
   uint32_t compile_threshold_;
   uint32_t warmup_threshold_;
   uint32_t osr_threshold_;
+  uint32_t fast_tier_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
   bool dump_info_on_shutdown_;
@@ -173,12 +214,15 @@ class JitOptions {
   JitOptions()
       : use_jit_compilation_(false),
         use_tiered_jit_compilation_(false),
+        use_baseline_osr_(false),
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
+        published_code_capacity_(0),
         compile_threshold_(0),
         warmup_threshold_(0),
         osr_threshold_(0),
+        fast_tier_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
@@ -191,8 +235,13 @@ class JitOptions {
 class JitCompilerInterface {
  public:
   virtual ~JitCompilerInterface() {}
-  virtual bool CompileMethod(
-      Thread* self, JitMemoryRegion* region, ArtMethod* method, bool baseline, bool osr)
+  // `queue_wait_ns` is the time the compilation request waited in the JIT thread pool,
+  // reported in the compilation event log.
+  virtual bool CompileMethod(Thread* self,
+                             JitMemoryRegion* region,
+                             ArtMethod* method,
+                             CompilationKind compilation_kind,
+                             uint64_t queue_wait_ns)
       REQUIRES_SHARED(Locks::mutator_lock_) = 0;
   virtual void TypesLoaded(mirror::Class**, size_t count)
       REQUIRES_SHARED(Locks::mutator_lock_) = 0;
@@ -235,6 +284,12 @@ class Jit {
   static constexpr size_t kDefaultInvokeTransitionWeightRatio = 500;
   // How frequently should the interpreter check to see if OSR compilation is ready.
   static constexpr int16_t kJitRecheckOSRThreshold = 101;  // Prime number to avoid patterns.
+  // Number of deoptimizations of a method after which it gets recompiled without
+  // any speculation.
+  static constexpr uint16_t kDeoptimizationsBeforeDisablingSpeculation = 3;
+  // Number of deoptimizations of a method after which we stop recompiling it eagerly,
+  // and let it warm up again through the regular hotness counters.
+  static constexpr uint16_t kMaxEagerRecompilationsAfterDeoptimization = 8;
 
   DECLARE_RUNTIME_DEBUG_FLAG(kSlowMode);
 
@@ -243,7 +298,11 @@ class Jit {
   // Create JIT itself.
   static Jit* Create(JitCodeCache* code_cache, JitOptions* options);
 
-  bool CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr, bool prejit)
+  bool CompileMethod(ArtMethod* method,
+                     Thread* self,
+                     CompilationKind compilation_kind,
+                     bool prejit,
+                     uint64_t queue_wait_ns = 0u)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   const JitCodeCache* GetCodeCache() const {
@@ -272,6 +331,10 @@ class Jit {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Add the size of the code generated for a method compiled with `compilation_kind`
+  // to the per-tier statistics.
+  void AddCodeSize(CompilationKind compilation_kind, size_t bytes) REQUIRES(!lock_);
+
   int GetThreadPoolPthreadPriority() const {
     return options_->GetThreadPoolPthreadPriority();
   }
@@ -440,14 +503,39 @@ class Jit {
   // class path methods.
   void NotifyZygoteCompilationDone();
 
-  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
+  // Called by baseline and fast tier compiled code once it reaches its hotness
+  // threshold. Enqueues the compilation of the next tier.
+  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   void EnqueueCompilationFromNterp(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called by the suspend check entrypoint when the thread has a pending baseline OSR
+  // request for `method`. Returns whether the top compiled frame is a baseline frame of
+  // `method` stopped at a loop header which OSR compiled code can be entered at. The
+  // caller then deoptimizes the frame, and the interpreter jumps to the OSR compiled code
+  // at its next back edge. If the frame is stopped at a loop header but `method` has no
+  // OSR compiled code yet, enqueues its compilation.
+  bool CanTransferBaselineFrameToOsr(Thread* self, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Called when compiled code of `method` deoptimized because of a failed speculation.
+  // Records the failure so that the speculation is not used anymore, and enqueues the
+  // recompilation of the method instead of waiting for it to get hot again.
+  void NotifyDeoptimization(ArtMethod* method, Thread* self, DeoptimizationKind kind)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   Jit(JitCodeCache* code_cache, JitOptions* options);
 
+  // Called when compiled code of `method` reaches its hotness threshold. Loops running in
+  // baseline code can only exit it through OSR, so ask the next suspend check of `self`
+  // to check whether the threshold was reached at a loop back edge of baseline code,
+  // see CanTransferBaselineFrameToOsr.
+  void MaybeRequestBaselineOsr(ArtMethod* method, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Compile an individual method listed in a profile. If `add_to_queue` is
   // true and the method was resolved, return true. Otherwise return false.
   bool CompileMethodFromProfile(Thread* self,
@@ -470,6 +558,13 @@ class Jit {
 
   static bool BindCompilerMethods(std::string* error_msg);
 
+  // Record the compilation time of a successful compilation of `compilation_kind`.
+  void AddCompilationTime(CompilationKind compilation_kind, uint64_t duration_ns)
+      REQUIRES(!lock_);
+
+  // Dump the per-tier compilation statistics.
+  void DumpCompilationKindStats(std::ostream& os) REQUIRES(lock_);
+
   // JIT compiler
   static void* jit_library_handle_;
   static JitCompilerInterface* jit_compiler_;
@@ -483,6 +578,10 @@ class Jit {
   std::unique_ptr<ThreadPool> thread_pool_;
   std::vector<std::unique_ptr<OatDexFile>> type_lookup_tables_;
 
+  // Empty checkpoint requested to make the next suspend check of a thread take the
+  // slow path, where pending baseline OSR requests are handled.
+  const std::unique_ptr<Closure> baseline_osr_checkpoint_;
+
   Mutex boot_completed_lock_;
   bool boot_completed_ GUARDED_BY(boot_completed_lock_) = false;
   std::deque<Task*> tasks_after_boot_ GUARDED_BY(boot_completed_lock_);
@@ -490,6 +589,16 @@ class Jit {
   // Performance monitoring.
   CumulativeLogger cumulative_timings_;
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
+
+  // Per-tier statistics, indexed by CompilationKind.
+  struct CompilationKindStats {
+    size_t number_of_compilations = 0u;
+    uint64_t compilation_time_ns = 0u;
+    size_t code_size = 0u;
+  };
+  std::array<CompilationKindStats, kNumberOfCompilationKinds> compilation_kind_stats_
+      GUARDED_BY(lock_);
+
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
   // In the JIT zygote configuration, after all compilation is done, the zygote
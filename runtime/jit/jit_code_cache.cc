@@ -64,6 +64,42 @@ namespace jit {
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
+// Returns the JIT tier of the compiled code at `entry_point`, which must be in the code cache
+// and not be a JNI stub.
+static CompilationKind GetCompilationKindOfCode(const void* entry_point) {
+  const uint8_t* code_info =
+      OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr();
+  if (CodeInfo::IsBaseline(code_info)) {
+    return CompilationKind::kBaseline;
+  } else if (CodeInfo::IsFastTier(code_info)) {
+    return CompilationKind::kFast;
+  } else {
+    return CompilationKind::kOptimized;
+  }
+}
+
+// Returns whether `method` and the methods inlined in its compiled code are in the boot
+// image. The inline info of JIT code references methods by their ArtMethod*, and only
+// boot image ArtMethods are at the same address in children forked before the code was
+// compiled.
+static bool IsBootImageCode(ArtMethod* method, const OatQuickMethodHeader* method_header)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (!heap->ObjectIsInBootImageSpace(method->GetDeclaringClass())) {
+    return false;
+  }
+  CodeInfo code_info = CodeInfo::DecodeInlineInfoOnly(method_header);
+  for (StackMap stack_map : code_info.GetStackMaps()) {
+    for (InlineInfo inline_info : code_info.GetInlineInfosOf(stack_map)) {
+      if (inline_info.EncodesArtMethod() &&
+          !heap->ObjectIsInBootImageSpace(inline_info.GetArtMethod()->GetDeclaringClass())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 class JitCodeCache::JniStubKey {
  public:
   explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
@@ -259,6 +295,7 @@ JitCodeCache::JitCodeCache()
     : is_weak_access_enabled_(true),
       inline_cache_cond_("Jit inline cache condition variable", *Locks::jit_lock_),
       zygote_map_(&shared_region_),
+      published_map_(&published_region_),
       lock_cond_("Jit code cache condition variable", *Locks::jit_lock_),
       collection_in_progress_(false),
       last_collection_increased_code_cache_(false),
@@ -278,7 +315,7 @@ bool JitCodeCache::PrivateRegionContainsPc(const void* ptr) const {
 }
 
 bool JitCodeCache::ContainsPc(const void* ptr) const {
-  return PrivateRegionContainsPc(ptr) || shared_region_.IsInExecSpace(ptr);
+  return PrivateRegionContainsPc(ptr) || IsInZygoteExecSpace(ptr);
 }
 
 bool JitCodeCache::WillExecuteJitCode(ArtMethod* method) {
@@ -307,7 +344,7 @@ bool JitCodeCache::ContainsMethod(ArtMethod* method) {
         return true;
       }
     }
-    if (zygote_map_.ContainsMethod(method)) {
+    if (zygote_map_.ContainsMethod(method) || published_map_.ContainsMethod(method)) {
       return true;
     }
   }
@@ -421,7 +458,9 @@ void JitCodeCache::SweepRootTables(IsMarkedVisitor* visitor) {
     const uint8_t* root_table = GetRootTable(entry.first, &number_of_roots);
     uint8_t* roots_data = private_region_.IsInDataSpace(root_table)
         ? private_region_.GetWritableDataAddress(root_table)
-        : shared_region_.GetWritableDataAddress(root_table);
+        : published_region_.IsInDataSpace(root_table)
+            ? published_region_.GetWritableDataAddress(root_table)
+            : shared_region_.GetWritableDataAddress(root_table);
     GcRoot<mirror::Object>* roots = reinterpret_cast<GcRoot<mirror::Object>*>(roots_data);
     for (uint32_t i = 0; i < number_of_roots; ++i) {
       // This does not need a read barrier because this is called by GC.
@@ -716,10 +755,19 @@ bool JitCodeCache::Commit(Thread* self,
       data->SetCode(code_ptr);
       data->UpdateEntryPoints(method_header->GetEntryPoint());
     } else {
-      if (method->IsPreCompiled() && IsSharedRegion(*region)) {
-        zygote_map_.Put(code_ptr, method);
-      } else {
-        method_code_map_.Put(code_ptr, method);
+      // Children of a child zygote, including the ones already forked, look up the
+      // published code when the method gets hot.
+      bool published = IsPublishedRegion(*region) &&
+          !osr &&
+          GetCompilationKindOfCode(method_header->GetEntryPoint()) == CompilationKind::kOptimized &&
+          IsBootImageCode(method, method_header) &&
+          published_map_.Put(code_ptr, method);
+      if (!published) {
+        if (method->IsPreCompiled() && region == &shared_region_) {
+          zygote_map_.Put(code_ptr, method);
+        } else {
+          method_code_map_.Put(code_ptr, method);
+        }
       }
       if (osr) {
         number_of_osr_compilations_++;
@@ -907,6 +955,12 @@ void JitCodeCache::TransitionToDebuggable() {
         DCHECK(!IsInZygoteExecSpace(method->GetEntryPointFromQuickCompiledCode()));
       }
     }
+    for (const auto& entry : published_map_) {
+      ArtMethod* method = entry.method;
+      if (method != nullptr) {
+        DCHECK(!IsInZygoteExecSpace(method->GetEntryPointFromQuickCompiledCode()));
+      }
+    }
   }
 }
 
@@ -1138,9 +1192,20 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
 
       // Start polling the liveness of compiled code to prepare for the next full collection.
       if (next_collection_will_be_full) {
-        if (Runtime::Current()->GetJITOptions()->CanCompileBaseline()) {
+        const JitOptions* jit_options = Runtime::Current()->GetJITOptions();
+        if (jit_options->CanCompileBaseline()) {
+          // Reset the hotness count of baseline and fast tier code to the count the code
+          // started from. Each tier starts from its own count, so the code whose count
+          // has not moved at the next collection was not executed in between.
           for (ProfilingInfo* info : profiling_infos_) {
-            info->SetBaselineHotnessCount(0);
+            const void* entry_point = info->GetMethod()->GetEntryPointFromQuickCompiledCode();
+            if (ContainsPc(entry_point)) {
+              CompilationKind kind = GetCompilationKindOfCode(entry_point);
+              if (kind == CompilationKind::kBaseline || kind == CompilationKind::kFast) {
+                info->SetBaselineHotnessCount(jit_options->GetInitialBaselineHotnessCount(kind));
+                info->SetIsPollingLiveness(true);
+              }
+            }
           }
         } else {
           // Save the entry point of methods we have compiled, and update the entry
@@ -1245,20 +1310,25 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
   {
     MutexLock mu(self, *Locks::jit_lock_);
 
-    if (Runtime::Current()->GetJITOptions()->CanCompileBaseline()) {
-      // Update to interpreter the methods that have baseline entrypoints and whose baseline
-      // hotness count is zero.
+    const JitOptions* jit_options = Runtime::Current()->GetJITOptions();
+    if (jit_options->CanCompileBaseline()) {
+      // Update to interpreter the methods that have baseline or fast tier entrypoints and
+      // whose baseline hotness count did not move since the previous collection reset it.
+      // Methods compiled since then are not polled.
       // Note that these methods may be in thread stack or concurrently revived
       // between. That's OK, as the thread executing it will mark it.
       for (ProfilingInfo* info : profiling_infos_) {
-        if (info->GetBaselineHotnessCount() == 0) {
-          const void* entry_point = info->GetMethod()->GetEntryPointFromQuickCompiledCode();
-          if (ContainsPc(entry_point)) {
-            OatQuickMethodHeader* method_header =
-                OatQuickMethodHeader::FromEntryPoint(entry_point);
-            if (CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())) {
-              info->GetMethod()->SetEntryPointFromQuickCompiledCode(GetQuickToInterpreterBridge());
-            }
+        if (!info->IsPollingLiveness()) {
+          continue;
+        }
+        info->SetIsPollingLiveness(false);
+        const void* entry_point = info->GetMethod()->GetEntryPointFromQuickCompiledCode();
+        if (ContainsPc(entry_point)) {
+          CompilationKind kind = GetCompilationKindOfCode(entry_point);
+          if ((kind == CompilationKind::kBaseline || kind == CompilationKind::kFast) &&
+              (info->GetBaselineHotnessCount() ==
+                   jit_options->GetInitialBaselineHotnessCount(kind))) {
+            info->GetMethod()->SetEntryPointFromQuickCompiledCode(GetQuickToInterpreterBridge());
           }
         }
       }
@@ -1394,6 +1464,11 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
       if (code_ptr != nullptr) {
         return OatQuickMethodHeader::FromCodePointer(code_ptr);
       }
+    } else if (published_region_.IsInExecSpace(reinterpret_cast<const void*>(pc))) {
+      const void* code_ptr = published_map_.GetCodeFor(method, pc);
+      if (code_ptr != nullptr) {
+        return OatQuickMethodHeader::FromCodePointer(code_ptr);
+      }
     }
     auto it = method_code_map_.lower_bound(reinterpret_cast<const void*>(pc));
     if (it != method_code_map_.begin()) {
@@ -1440,7 +1515,8 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
-                                              const std::vector<uint32_t>& entries,
+                                              const std::vector<uint32_t>& inline_cache_entries,
+                                              const std::vector<uint32_t>& branch_cache_entries,
                                               bool retry_allocation)
     // No thread safety analysis as we are using TryLock/Unlock explicitly.
     NO_THREAD_SAFETY_ANALYSIS {
@@ -1450,29 +1526,36 @@ ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
     // If we are allocating for the interpreter, just try to lock, to avoid
     // lock contention with the JIT.
     if (Locks::jit_lock_->ExclusiveTryLock(self)) {
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(
+          self, method, inline_cache_entries, branch_cache_entries);
       Locks::jit_lock_->ExclusiveUnlock(self);
     }
   } else {
     {
       MutexLock mu(self, *Locks::jit_lock_);
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(
+          self, method, inline_cache_entries, branch_cache_entries);
     }
 
     if (info == nullptr) {
       GarbageCollectCache(self);
       MutexLock mu(self, *Locks::jit_lock_);
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(
+          self, method, inline_cache_entries, branch_cache_entries);
     }
   }
   return info;
 }
 
-ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNUSED,
-                                                      ArtMethod* method,
-                                                      const std::vector<uint32_t>& entries) {
+ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
+    Thread* self ATTRIBUTE_UNUSED,
+    ArtMethod* method,
+    const std::vector<uint32_t>& inline_cache_entries,
+    const std::vector<uint32_t>& branch_cache_entries) {
   size_t profile_info_size = RoundUp(
-      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size(),
+      sizeof(ProfilingInfo) +
+          sizeof(InlineCache) * inline_cache_entries.size() +
+          sizeof(BranchCache) * branch_cache_entries.size(),
       sizeof(void*));
 
   // Check whether some other thread has concurrently created it.
@@ -1486,7 +1569,7 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  info = new (writable_data) ProfilingInfo(method, entries);
+  info = new (writable_data) ProfilingInfo(method, inline_cache_entries, branch_cache_entries);
 
   // Make sure other threads see the data in the profiling info object before the
   // store in the ArtMethod's ProfilingInfo pointer.
@@ -1499,8 +1582,11 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
 }
 
 void* JitCodeCache::MoreCore(const void* mspace, intptr_t increment) {
-  return shared_region_.OwnsSpace(mspace)
-      ? shared_region_.MoreCore(mspace, increment)
+  if (shared_region_.OwnsSpace(mspace)) {
+    return shared_region_.MoreCore(mspace, increment);
+  }
+  return published_region_.OwnsSpace(mspace)
+      ? published_region_.MoreCore(mspace, increment)
       : private_region_.MoreCore(mspace, increment);
 }
 
@@ -1595,19 +1681,22 @@ bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
 
 bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
                                        Thread* self,
-                                       bool osr,
+                                       CompilationKind compilation_kind,
                                        bool prejit,
-                                       bool baseline,
                                        JitMemoryRegion* region) {
+  const bool osr = (compilation_kind == CompilationKind::kOsr);
+  const bool baseline = (compilation_kind == CompilationKind::kBaseline);
   const void* existing_entry_point = method->GetEntryPointFromQuickCompiledCode();
   if (!osr && ContainsPc(existing_entry_point)) {
-    OatQuickMethodHeader* method_header =
-        OatQuickMethodHeader::FromEntryPoint(existing_entry_point);
-    if (CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr()) == baseline) {
+    CompilationKind existing_kind = GetCompilationKindOfCode(existing_entry_point);
+    // Don't compile the fast tier on top of optimized code either.
+    if (existing_kind == compilation_kind ||
+        (compilation_kind == CompilationKind::kFast &&
+         existing_kind == CompilationKind::kOptimized)) {
       VLOG(jit) << "Not compiling "
                 << method->PrettyMethod()
                 << " because it has already been compiled"
-                << " baseline=" << std::boolalpha << baseline;
+                << " kind=" << existing_kind;
       return false;
     }
   }
@@ -1812,6 +1901,14 @@ void JitCodeCache::Dump(std::ostream& os) {
        << "Zygote JIT data cache size (at point of fork): "
        << shared_region_.GetUsedMemoryForData() / KB << "KB / "
        << shared_region_.GetResidentMemoryForData() / KB << "KB\n";
+    if (published_region_.GetUsedMemoryForCode() != 0) {
+      os << "Published JIT code cache size (at point of fork): "
+         << published_region_.GetUsedMemoryForCode() / KB << "KB / "
+         << published_region_.GetResidentMemoryForCode() / KB << "KB\n"
+         << "Published JIT data cache size (at point of fork): "
+         << published_region_.GetUsedMemoryForData() / KB << "KB / "
+         << published_region_.GetResidentMemoryForData() / KB << "KB\n";
+    }
   }
   os << "Current JIT mini-debug-info size: " << PrettySize(GetJitMiniDebugInfoMemUsage()) << "\n"
      << "Current JIT capacity: " << PrettySize(GetCurrentRegion()->GetCurrentCapacity()) << "\n"
@@ -1826,6 +1923,33 @@ void JitCodeCache::Dump(std::ostream& os) {
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
 }
 
+void JitCodeCache::DumpDeoptimizedMethods(std::ostream& os) {
+  // Only report methods which deoptimized more than once, the first deoptimization
+  // of a method is expected when its inline caches or class hierarchy change.
+  static constexpr uint16_t kMinDeoptimizationsToReport = 2;
+  static constexpr size_t kMaxMethodsToReport = 20;
+  std::vector<std::pair<uint16_t, ArtMethod*>> methods;
+  {
+    MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+    for (const ProfilingInfo* info : profiling_infos_) {
+      if (info->GetNumberOfDeoptimizations() >= kMinDeoptimizationsToReport) {
+        methods.emplace_back(info->GetNumberOfDeoptimizations(), info->GetMethod());
+      }
+    }
+  }
+  if (methods.empty()) {
+    return;
+  }
+  std::sort(methods.begin(), methods.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first > rhs.first;
+  });
+  os << "Methods with repeated JIT deoptimizations: " << methods.size() << "\n";
+  for (size_t i = 0; i < std::min(methods.size(), kMaxMethodsToReport); ++i) {
+    os << "  " << methods[i].second->PrettyMethod() << ": " << methods[i].first
+       << " deoptimizations\n";
+  }
+}
+
 void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   Thread* self = Thread::Current();
 
@@ -1843,6 +1967,7 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   // Reset potential writable MemMaps inherited from the zygote. We never want
   // to write to them.
   shared_region_.ResetWritableMappings();
+  published_region_.ResetWritableMappings();
 
   if (is_zygote || Runtime::Current()->IsSafeMode()) {
     // Don't create a private region for a child zygote. Regions are usually map shared
@@ -1870,8 +1995,59 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   }
 }
 
+bool JitCodeCache::InitializePublishedRegion(size_t capacity, std::string* error_msg) {
+  DCHECK(Runtime::Current()->IsZygote());
+  {
+    MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+    // Reuse the zygote memory: the writable views are not inherited by children and
+    // the memory is sealed against new writable mappings.
+    if (!published_region_.Initialize(capacity,
+                                      capacity,
+                                      /* rwx_memory_allowed= */ false,
+                                      /* is_zygote= */ true,
+                                      error_msg)) {
+      return false;
+    }
+  }
+  // The map is fixed size. Assume methods take 1KB of code and data on average.
+  published_map_.Initialize(capacity / KB);
+  return true;
+}
+
+bool JitCodeCache::UsePublishedCode(ArtMethod* method) {
+  if (Runtime::Current()->IsJavaDebuggable()) {
+    // Published code is not debuggable.
+    return false;
+  }
+  const void* code_ptr = published_map_.GetCodeFor(method);
+  if (code_ptr == nullptr) {
+    return false;
+  }
+  // Only the child zygote can write the map. Still, make sure we don't jump outside of
+  // the code it published.
+  if (!published_region_.IsInExecSpace(code_ptr)) {
+    LOG(WARNING) << "Ignoring published code of " << method->PrettyMethod()
+                 << " outside of the published region";
+    return false;
+  }
+  ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+  if (info != nullptr && info->GetNumberOfDeoptimizations() != 0) {
+    // The method deoptimized in this process. Let the JIT compile it with the
+    // speculations that failed disabled.
+    return false;
+  }
+  VLOG(jit) << "Using published code of " << method->PrettyMethod();
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+  Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
+      method, method_header->GetEntryPoint());
+  return true;
+}
+
 JitMemoryRegion* JitCodeCache::GetCurrentRegion() {
-  return Runtime::Current()->IsZygote() ? &shared_region_ : &private_region_;
+  if (!Runtime::Current()->IsZygote()) {
+    return &private_region_;
+  }
+  return published_region_.IsValid() ? &published_region_ : &shared_region_;
 }
 
 void ZygoteMap::Initialize(uint32_t number_of_methods) {
@@ -1942,11 +2118,15 @@ const void* ZygoteMap::GetCodeFor(ArtMethod* method, uintptr_t pc) const {
   }
 }
 
-void ZygoteMap::Put(const void* code, ArtMethod* method) {
+bool ZygoteMap::Put(const void* code, ArtMethod* method) {
   if (map_.empty()) {
-    return;
+    return false;
   }
   CHECK(Runtime::Current()->IsZygote());
+  // The map is allocated for 40-80% capacity, see `Initialize`.
+  if (size_ >= map_.size() * 80 / 100) {
+    return false;
+  }
   std::hash<ArtMethod*> hf;
   size_t index = hf(method) & (map_.size() - 1);
   size_t original_index = index;
@@ -1964,7 +2144,9 @@ void ZygoteMap::Put(const void* code, ArtMethod* method) {
     index = (index + 1) & (map_.size() - 1);
     DCHECK_NE(original_index, index);
   }
+  ++size_;
   DCHECK_EQ(GetCodeFor(method), code);
+  return true;
 }
 
 }  // namespace jit
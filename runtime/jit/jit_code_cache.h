@@ -32,6 +32,7 @@
 #include "base/mem_map.h"
 #include "base/mutex.h"
 #include "base/safe_map.h"
+#include "compilation_kind.h"
 #include "jit_memory_region.h"
 
 namespace art {
@@ -113,14 +114,15 @@ class ZygoteMap {
   };
 
   explicit ZygoteMap(JitMemoryRegion* region)
-      : map_(), region_(region), compilation_state_(nullptr) {}
+      : map_(), region_(region), compilation_state_(nullptr), size_(0) {}
 
   // Initialize the data structure so it can hold `number_of_methods` mappings.
   // Note that the map is fixed size and never grows.
   void Initialize(uint32_t number_of_methods) REQUIRES(!Locks::jit_lock_);
 
-  // Add the mapping method -> code.
-  void Put(const void* code, ArtMethod* method) REQUIRES(Locks::jit_lock_);
+  // Add the mapping method -> code. Return false if the map already holds
+  // the number of methods it was initialized for.
+  bool Put(const void* code, ArtMethod* method) REQUIRES(Locks::jit_lock_);
 
   // Return the code pointer for the given method. If pc is not zero, check that
   // the pc falls into that code range. Return null otherwise.
@@ -172,6 +174,9 @@ class ZygoteMap {
   // and should end with kNotifiedOk or kNotifiedFailure.
   const ZygoteCompilationState* compilation_state_;
 
+  // The number of methods added to the map. Only meaningful in the zygote.
+  size_t size_;
+
   DISALLOW_COPY_AND_ASSIGN(ZygoteMap);
 };
 
@@ -195,9 +200,8 @@ class JitCodeCache {
 
   bool NotifyCompilationOf(ArtMethod* method,
                            Thread* self,
-                           bool osr,
+                           CompilationKind compilation_kind,
                            bool prejit,
-                           bool baseline,
                            JitMemoryRegion* region)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::jit_lock_);
@@ -313,13 +317,16 @@ class JitCodeCache {
   // will collect and retry if the first allocation is unsuccessful.
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
-                                  const std::vector<uint32_t>& entries,
+                                  const std::vector<uint32_t>& inline_cache_entries,
+                                  const std::vector<uint32_t>& branch_cache_entries,
                                   bool retry_allocation)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool OwnsSpace(const void* mspace) const NO_THREAD_SAFETY_ANALYSIS {
-    return private_region_.OwnsSpace(mspace) || shared_region_.OwnsSpace(mspace);
+    return private_region_.OwnsSpace(mspace) ||
+        shared_region_.OwnsSpace(mspace) ||
+        published_region_.OwnsSpace(mspace);
   }
 
   void* MoreCore(const void* mspace, intptr_t increment);
@@ -340,6 +347,11 @@ class JitCodeCache {
 
   void Dump(std::ostream& os) REQUIRES(!Locks::jit_lock_);
 
+  // Dump the methods whose compiled code deoptimized repeatedly, most deoptimized first.
+  void DumpDeoptimizedMethods(std::ostream& os)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   bool IsOsrCompiled(ArtMethod* method) REQUIRES(!Locks::jit_lock_);
 
   void SweepRootTables(IsMarkedVisitor* visitor)
@@ -384,6 +396,22 @@ class JitCodeCache {
 
   void PostForkChildAction(bool is_system_server, bool is_zygote);
 
+  // Create the region in which a child zygote compiles code, and the map through which
+  // it publishes the code of boot image methods to its children. Like the zygote region,
+  // the region is only writable by the child zygote.
+  bool InitializePublishedRegion(size_t capacity, std::string* error_msg)
+      REQUIRES(!Locks::jit_lock_);
+
+  bool HasPublishedRegion() const NO_THREAD_SAFETY_ANALYSIS {
+    return published_region_.IsValid();
+  }
+
+  // Install the code the child zygote published for `method`, if any. Return whether
+  // the method now uses it.
+  bool UsePublishedCode(ArtMethod* method)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Clear the entrypoints of JIT compiled methods that belong in the zygote space.
   // This is used for removing non-debuggable JIT code at the point we realize the runtime
   // is debuggable. Also clear the Precompiled flag from all methods so the non-debuggable code
@@ -391,7 +419,13 @@ class JitCodeCache {
   void TransitionToDebuggable() REQUIRES(!Locks::jit_lock_) REQUIRES(Locks::mutator_lock_);
 
   JitMemoryRegion* GetCurrentRegion();
-  bool IsSharedRegion(const JitMemoryRegion& region) const { return &region == &shared_region_; }
+  // Whether code in `region` is compiled by a zygote for use in other processes.
+  bool IsSharedRegion(const JitMemoryRegion& region) const {
+    return &region == &shared_region_ || IsPublishedRegion(region);
+  }
+  bool IsPublishedRegion(const JitMemoryRegion& region) const {
+    return &region == &published_region_;
+  }
   bool CanAllocateProfilingInfo() {
     // If we don't have a private region, we cannot allocate a profiling info.
     // A shared region doesn't support in general GC objects, which a profiling info
@@ -400,9 +434,10 @@ class JitCodeCache {
     return region->IsValid() && !IsSharedRegion(*region);
   }
 
-  // Return whether the given `ptr` is in the zygote executable memory space.
+  // Return whether the given `ptr` is in the executable memory space of the zygote or
+  // of a child zygote.
   bool IsInZygoteExecSpace(const void* ptr) const {
-    return shared_region_.IsInExecSpace(ptr);
+    return shared_region_.IsInExecSpace(ptr) || published_region_.IsInExecSpace(ptr);
   }
 
  private:
@@ -410,7 +445,8 @@ class JitCodeCache {
 
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
-                                          const std::vector<uint32_t>& entries)
+                                          const std::vector<uint32_t>& inline_cache_entries,
+                                          const std::vector<uint32_t>& branch_cache_entries)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -477,7 +513,7 @@ class JitCodeCache {
   }
 
   bool IsInZygoteDataSpace(const void* ptr) const {
-    return shared_region_.IsInDataSpace(ptr);
+    return shared_region_.IsInDataSpace(ptr) || published_region_.IsInDataSpace(ptr);
   }
 
   bool IsWeakAccessEnabled(Thread* self) const;
@@ -501,6 +537,10 @@ class JitCodeCache {
   // Shared region, inherited from the zygote.
   JitMemoryRegion shared_region_;
 
+  // Region of a child zygote, inherited by its children. Only valid when the child zygote
+  // publishes code.
+  JitMemoryRegion published_region_;
+
   // Process's own region.
   JitMemoryRegion private_region_;
 
@@ -526,6 +566,10 @@ class JitCodeCache {
   // forked from the zygote.
   ZygoteMap zygote_map_;
 
+  // Boot image methods that a child zygote has compiled in `published_region_`,
+  // for its children to use.
+  ZygoteMap published_map_;
+
   // -------------- JIT GC related data structures ----------------------- //
 
   // Condition to wait on during collection.
@@ -492,6 +492,75 @@ class TestZygoteMemory : public testing::Test {
     munmap(addr, kPageSize);
     munmap(shared, kPageSize);
   }
+
+  // Test the property that a child zygote relies on when publishing code in a zygote
+  // region: its children see what it writes after they are forked, but don't inherit
+  // the writable view of the region.
+  void TestZygoteRegionAfterFork() NO_THREAD_SAFETY_ANALYSIS {
+    // Zygote JIT memory only works on kernels that don't segfault on flush.
+    TEST_DISABLED_FOR_KERNELS_WITH_CACHE_SEGFAULT();
+    MemMap::Init();
+    std::string error_msg;
+    JitMemoryRegion region;
+    size_t capacity = 4 * kPageSize;
+    bool res = region.Initialize(capacity,
+                                 capacity,
+                                 /* rwx_memory_allowed= */ false,
+                                 /* is_zygote= */ true,
+                                 &error_msg);
+    CHECK(res) << error_msg;
+    const int32_t* addr = reinterpret_cast<const int32_t*>(region.data_pages_.Begin());
+    int32_t* writable_addr = region.GetWritableDataAddress(addr);
+    CHECK_NE(writable_addr, addr);
+
+    // Create a mapping of atomic ints to communicate between processes.
+    android::base::unique_fd fd(JitMemoryRegion::CreateZygoteMemory(kPageSize, &error_msg));
+    CHECK_NE(fd.get(), -1);
+    std::atomic<int32_t>* shared = reinterpret_cast<std::atomic<int32_t>*>(
+        mmap(nullptr, kPageSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0));
+
+    // Values used for the tests below.
+    const int32_t parent_value = 66;
+    const int32_t child_value = 33;
+    const int32_t starting_value = 22;
+
+    shared[0] = 0;
+    region.WriteData(addr, starting_value);
+    CHECK_EQ(addr[0], starting_value);
+    pid_t pid = fork();
+    if (pid == 0) {
+      CHECK_EQ(addr[0], starting_value);
+
+      // Notify parent process.
+      shared[0] = 1;
+
+      // Wait for parent process for new value.
+      while (shared[0] != 2) {
+        sched_yield();
+      }
+
+      CHECK_EQ(addr[0], parent_value);
+      // Test that the writable view is not mapped in the child. The signal handler
+      // will exit the process.
+      gAddrToFaultOn = writable_addr;
+      registerSignalHandler();
+      writable_addr[0] = child_value;
+      exit(0);
+    } else {
+      while (shared[0] != 1) {
+        sched_yield();
+      }
+      region.WriteData(addr, parent_value);
+      // Notify the child of the new value.
+      shared[0] = 2;
+      int status;
+      CHECK_EQ(waitpid(pid, &status, 0), pid);
+      CHECK(WIFEXITED(status)) << strerror(errno);
+      CHECK_EQ(WEXITSTATUS(status), kReturnFromFault);
+      CHECK_EQ(addr[0], parent_value);
+      munmap(shared, kPageSize);
+    }
+  }
 };
 
 TEST_F(TestZygoteMemory, BasicTest) {
@@ -510,6 +579,10 @@ TEST_F(TestZygoteMemory, TestFromSharedToPrivate) {
   TestFromSharedToPrivate();
 }
 
+TEST_F(TestZygoteMemory, TestZygoteRegionAfterFork) {
+  TestZygoteRegionAfterFork();
+}
+
 #endif  // defined (__BIONIC__)
 
 }  // namespace jit
@@ -16,6 +16,8 @@
 
 #include "profiling_info.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "dex/dex_instruction.h"
 #include "jit/jit.h"
@@ -25,17 +27,29 @@
 
 namespace art {
 
-ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
+ProfilingInfo::ProfilingInfo(ArtMethod* method,
+                             const std::vector<uint32_t>& inline_cache_entries,
+                             const std::vector<uint32_t>& branch_cache_entries)
       : baseline_hotness_count_(0),
         method_(method),
         saved_entry_point_(nullptr),
-        number_of_inline_caches_(entries.size()),
+        number_of_inline_caches_(inline_cache_entries.size()),
+        number_of_branch_caches_(branch_cache_entries.size()),
         current_inline_uses_(0),
+        number_of_deoptimizations_(0),
+        disabled_speculations_(0),
+        is_recompilation_queued_(false),
         is_method_being_compiled_(false),
-        is_osr_method_being_compiled_(false) {
+        is_osr_method_being_compiled_(false),
+        is_polling_liveness_(false) {
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
-    cache_[i].dex_pc_ = entries[i];
+    cache_[i].dex_pc_ = inline_cache_entries[i];
+  }
+  BranchCache* branch_caches = GetBranchCaches();
+  memset(branch_caches, 0, number_of_branch_caches_ * sizeof(BranchCache));
+  for (size_t i = 0; i < number_of_branch_caches_; ++i) {
+    branch_caches[i].dex_pc_ = branch_cache_entries[i];
   }
 }
 
@@ -44,7 +58,8 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
   // instructions we are interested in profiling.
   DCHECK(!method->IsNative());
 
-  std::vector<uint32_t> entries;
+  std::vector<uint32_t> inline_cache_entries;
+  std::vector<uint32_t> branch_cache_entries;
   for (const DexInstructionPcPair& inst : method->DexInstructions()) {
     switch (inst->Opcode()) {
       case Instruction::INVOKE_VIRTUAL:
@@ -53,7 +68,22 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
       case Instruction::INVOKE_VIRTUAL_RANGE_QUICK:
       case Instruction::INVOKE_INTERFACE:
       case Instruction::INVOKE_INTERFACE_RANGE:
-        entries.push_back(inst.DexPc());
+        inline_cache_entries.push_back(inst.DexPc());
+        break;
+
+      case Instruction::IF_EQ:
+      case Instruction::IF_EQZ:
+      case Instruction::IF_NE:
+      case Instruction::IF_NEZ:
+      case Instruction::IF_LT:
+      case Instruction::IF_LTZ:
+      case Instruction::IF_GE:
+      case Instruction::IF_GEZ:
+      case Instruction::IF_GT:
+      case Instruction::IF_GTZ:
+      case Instruction::IF_LE:
+      case Instruction::IF_LEZ:
+        branch_cache_entries.push_back(inst.DexPc());
         break;
 
       default:
@@ -66,7 +96,8 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, entries, retry_allocation) != nullptr;
+  return code_cache->AddProfilingInfo(
+      self, method, inline_cache_entries, branch_cache_entries, retry_allocation) != nullptr;
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -80,6 +111,17 @@ InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
   UNREACHABLE();
 }
 
+BranchCache* ProfilingInfo::GetBranchCache(uint32_t dex_pc) {
+  // The branch caches are sorted by dex pc, as they are created in instruction order.
+  BranchCache* begin = GetBranchCaches();
+  BranchCache* end = begin + number_of_branch_caches_;
+  BranchCache* it = std::lower_bound(
+      begin, end, dex_pc, [](const BranchCache& cache, uint32_t pc) {
+        return cache.dex_pc_ < pc;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
@@ -19,7 +19,9 @@
 
 #include <vector>
 
+#include "base/atomic.h"
 #include "base/macros.h"
+#include "deoptimization_kind.h"
 #include "gc_root.h"
 #include "offsets.h"
 
@@ -57,6 +59,34 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Structure to store the number of times a branch was taken and not taken at runtime,
+// by baseline compiled code. Counts saturate at the maximum value of uint16_t.
+class BranchCache {
+ public:
+  // The compiled code indexes this structure with the condition (0 or 1), so the
+  // counts must be adjacent, false first.
+  static constexpr MemberOffset FalseOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, false_));
+  }
+
+  static constexpr MemberOffset TrueOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, true_));
+  }
+
+  uint32_t GetDexPc() const { return dex_pc_; }
+  uint16_t GetFalse() const { return false_; }
+  uint16_t GetTrue() const { return true_; }
+
+ private:
+  uint32_t dex_pc_;
+  uint16_t false_;
+  uint16_t true_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(BranchCache);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -83,6 +113,10 @@ class ProfilingInfo {
   InlineCache* GetInlineCache(uint32_t dex_pc)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns the branch cache of the IF instruction at `dex_pc`, or null if the
+  // branch is not profiled.
+  BranchCache* GetBranchCache(uint32_t dex_pc);
+
   bool IsMethodBeingCompiled(bool osr) const {
     return osr
         ? is_osr_method_being_compiled_
@@ -138,8 +172,67 @@ class ProfilingInfo {
     return baseline_hotness_count_;
   }
 
+  // Whether the code cache reset the baseline hotness count to poll the liveness of
+  // the baseline or fast tier compiled code of the method. That code is removed at
+  // the next full collection if the count has not moved.
+  bool IsPollingLiveness() const {
+    return is_polling_liveness_;
+  }
+
+  void SetIsPollingLiveness(bool value) {
+    is_polling_liveness_ = value;
+  }
+
+  // Records that compiled code of the method deoptimized because a speculation of
+  // the given kind failed, and disables that speculation for future compilations.
+  // Returns the number of deoptimizations recorded so far.
+  uint16_t AddDeoptimization(DeoptimizationKind kind) {
+    disabled_speculations_ |= DeoptimizationKindMask(kind);
+    if (number_of_deoptimizations_ != std::numeric_limits<uint16_t>::max()) {
+      number_of_deoptimizations_++;
+    }
+    return number_of_deoptimizations_;
+  }
+
+  uint16_t GetNumberOfDeoptimizations() const {
+    return number_of_deoptimizations_;
+  }
+
+  // Marks the recompilation of the method after a deoptimization as queued. Returns
+  // false if it already was, in which case the caller must not queue it again.
+  bool TryQueueRecompilation() {
+    return !is_recompilation_queued_.exchange(true, std::memory_order_relaxed);
+  }
+
+  bool IsRecompilationQueued() const {
+    return is_recompilation_queued_.load(std::memory_order_relaxed);
+  }
+
+  void ClearQueuedRecompilation() {
+    is_recompilation_queued_.store(false, std::memory_order_relaxed);
+  }
+
+  void DisableAllSpeculations() {
+    disabled_speculations_ = std::numeric_limits<uint32_t>::max();
+  }
+
+  // Returns the mask of `DeoptimizationKind`s the compiler must not speculate on.
+  uint32_t GetDisabledSpeculations() const {
+    return disabled_speculations_;
+  }
+
+  bool IsSpeculationDisabled(DeoptimizationKind kind) const {
+    return (disabled_speculations_ & DeoptimizationKindMask(kind)) != 0u;
+  }
+
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& inline_cache_entries,
+                const std::vector<uint32_t>& branch_cache_entries);
+
+  BranchCache* GetBranchCaches() {
+    return reinterpret_cast<BranchCache*>(&cache_[number_of_inline_caches_]);
+  }
 
   // Hotness count for methods compiled with the JIT baseline compiler. Once
   // a threshold is hit (currentily the maximum value of uint16_t), we will
@@ -158,17 +251,38 @@ class ProfilingInfo {
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of branches we are profiling in the ArtMethod.
+  const uint32_t number_of_branch_caches_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
+  // Number of deoptimizations of the compiled code of the method, saturating.
+  // Like `disabled_speculations_`, this is updated racily by the deoptimizing
+  // threads: losing an update only delays the recompilation policy.
+  uint16_t number_of_deoptimizations_;
+
+  // Mask of the speculations (see `DeoptimizationKindMask`) that failed for this
+  // method, and that the JIT compiler should not use anymore.
+  uint32_t disabled_speculations_;
+
+  // Whether a recompilation of the method is queued after a deoptimization. Threads
+  // deoptimizing from the same compiled code queue a single recompilation.
+  Atomic<bool> is_recompilation_queued_;
+
   // Whether the ArtMethod is currently being compiled. This flag
   // is implicitly guarded by the JIT code cache lock.
   // TODO: Make the JIT code cache lock global.
   bool is_method_being_compiled_;
   bool is_osr_method_being_compiled_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Whether the code cache is polling the liveness of the compiled code of the
+  // method. Cleared when the method gets new baseline or fast tier code.
+  bool is_polling_liveness_;
+
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed by
+  // `number_of_branch_caches_` branch caches sorted by dex pc.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
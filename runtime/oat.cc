@@ -77,7 +77,9 @@ OatHeader::OatHeader(InstructionSet instruction_set,
       quick_generic_jni_trampoline_offset_(0),
       quick_imt_conflict_trampoline_offset_(0),
       quick_resolution_trampoline_offset_(0),
-      quick_to_interpreter_bridge_offset_(0) {
+      quick_to_interpreter_bridge_offset_(0),
+      hot_code_offset_(0),
+      cold_code_offset_(0) {
   // Don't want asserts in header as they would be checked in each file that includes it. But the
   // fields are private, so we check inside a method.
   static_assert(sizeof(magic_) == sizeof(kOatMagic),
@@ -107,6 +109,9 @@ bool OatHeader::IsValid() const {
   if (!IsValidInstructionSet(instruction_set_)) {
     return false;
   }
+  if (cold_code_offset_ < hot_code_offset_) {
+    return false;
+  }
   return true;
 }
 
@@ -129,6 +134,11 @@ std::string OatHeader::GetValidationErrorMessage() const {
   if (!IsValidInstructionSet(instruction_set_)) {
     return StringPrintf("Invalid instruction set, %d.", static_cast<int>(instruction_set_));
   }
+  if (cold_code_offset_ < hot_code_offset_) {
+    return StringPrintf("Cold code offset 0x%x is below hot code offset 0x%x.",
+                        cold_code_offset_,
+                        hot_code_offset_);
+  }
   return "";
 }
 
@@ -306,6 +316,27 @@ void OatHeader::SetQuickToInterpreterBridgeOffset(uint32_t offset) {
   quick_to_interpreter_bridge_offset_ = offset;
 }
 
+uint32_t OatHeader::GetHotCodeOffset() const {
+  DCHECK(IsValid());
+  return hot_code_offset_;
+}
+
+uint32_t OatHeader::GetColdCodeOffset() const {
+  DCHECK(IsValid());
+  return cold_code_offset_;
+}
+
+void OatHeader::SetCodeRegionOffsets(uint32_t hot_code_offset, uint32_t cold_code_offset) {
+  CHECK(hot_code_offset == 0u || hot_code_offset >= executable_offset_);
+  CHECK_GE(cold_code_offset, hot_code_offset);
+  DCHECK(IsValid());
+  DCHECK_EQ(hot_code_offset_, 0U) << hot_code_offset;
+  DCHECK_EQ(cold_code_offset_, 0U) << cold_code_offset;
+
+  hot_code_offset_ = hot_code_offset;
+  cold_code_offset_ = cold_code_offset;
+}
+
 uint32_t OatHeader::GetKeyValueStoreSize() const {
   CHECK(IsValid());
   return key_value_store_size_;
@@ -32,8 +32,8 @@ class InstructionSetFeatures;
 class PACKED(4) OatHeader {
  public:
   static constexpr std::array<uint8_t, 4> kOatMagic { { 'o', 'a', 't', '\n' } };
-  // Last oat version changed reason: Direct calls to @CriticalNative code.
-  static constexpr std::array<uint8_t, 4> kOatVersion { { '1', '8', '4', '\0' } };
+  // Last oat version changed reason: Profile-guided code regions.
+  static constexpr std::array<uint8_t, 4> kOatVersion { { '1', '8', '5', '\0' } };
 
   static constexpr const char* kDex2OatCmdLineKey = "dex2oat-cmdline";
   static constexpr const char* kDebuggableKey = "debuggable";
@@ -89,6 +89,13 @@ class PACKED(4) OatHeader {
   uint32_t GetQuickToInterpreterBridgeOffset() const;
   void SetQuickToInterpreterBridgeOffset(uint32_t offset);
 
+  // With a profile, the compiled code is laid out in three regions: startup code from the
+  // executable offset, hot code from the hot code offset and cold code from the cold code
+  // offset to the end of the executable section. Both offsets are 0 without a profile.
+  uint32_t GetHotCodeOffset() const;
+  uint32_t GetColdCodeOffset() const;
+  void SetCodeRegionOffsets(uint32_t hot_code_offset, uint32_t cold_code_offset);
+
   InstructionSet GetInstructionSet() const;
   uint32_t GetInstructionSetFeaturesBitmap() const;
 
@@ -131,6 +138,8 @@ class PACKED(4) OatHeader {
   uint32_t quick_imt_conflict_trampoline_offset_;
   uint32_t quick_resolution_trampoline_offset_;
   uint32_t quick_to_interpreter_bridge_offset_;
+  uint32_t hot_code_offset_;
+  uint32_t cold_code_offset_;
 
   uint32_t key_value_store_size_;
   uint8_t key_value_store_[0];  // note variable width data at end
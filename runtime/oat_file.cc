@@ -38,6 +38,7 @@
 
 #include "arch/instruction_set_features.h"
 #include "art_method.h"
+#include "base/bit_utils.h"
 #include "base/bit_vector.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
@@ -2068,6 +2069,31 @@ void OatDexFile::MadviseDexFile(const DexFile& dex_file, MadviseState state) {
   }
 }
 
+void OatFile::MadviseCodeRegions() const {
+  if (!IsExecutable()) {
+    return;
+  }
+  const OatHeader& oat_header = GetOatHeader();
+  uint32_t hot_code_offset = oat_header.GetHotCodeOffset();
+  uint32_t cold_code_offset = oat_header.GetColdCodeOffset();
+  if (cold_code_offset == 0u) {
+    // Not compiled with a profile.
+    return;
+  }
+  // Read ahead the startup code, including the partial pages at the ends of the region.
+  const uint8_t* code_begin = Begin() + oat_header.GetExecutableOffset();
+  DexLayoutSection::MadviseLargestPageAlignedRegion(
+      AlignDown(code_begin, kPageSize),
+      AlignUp(Begin() + hot_code_offset, kPageSize),
+      MADV_WILLNEED);
+  if (Runtime::Current()->MAdviseRandomAccess()) {
+    // Cold code is rarely executed, do not read ahead around it.
+    DexLayoutSection::MadviseLargestPageAlignedRegion(Begin() + cold_code_offset,
+                                                      End(),
+                                                      MADV_RANDOM);
+  }
+}
+
 OatFile::OatClass::OatClass(const OatFile* oat_file,
                             ClassStatus status,
                             OatClassType type,
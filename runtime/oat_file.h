@@ -346,6 +346,9 @@ class OatFile {
   const uint8_t* Begin() const;
   const uint8_t* End() const;
 
+  // Madvise the code regions of an oat file laid out with a profile when it is loaded.
+  void MadviseCodeRegions() const;
+
   const uint8_t* DataBimgRelRoBegin() const { return data_bimg_rel_ro_begin_; }
   const uint8_t* DataBimgRelRoEnd() const { return data_bimg_rel_ro_end_; }
 
@@ -592,9 +592,14 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
               << GetDeoptimizationKindName(kind);
     DumpFramesWithType(self_, /* details= */ true);
   }
-  if (Runtime::Current()->UseJitCompilation()) {
+  if (kind == DeoptimizationKind::kBaselineOsr) {
+    // The baseline frame is only moved to the interpreter to enter OSR compiled code
+    // at its next loop back edge, the compiled code itself remains valid.
+    DCHECK(Runtime::Current()->UseJitCompilation());
+  } else if (Runtime::Current()->UseJitCompilation()) {
     Runtime::Current()->GetJit()->GetCodeCache()->InvalidateCompiledCodeFor(
         deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader());
+    Runtime::Current()->GetJit()->NotifyDeoptimization(deopt_method, self_, kind);
   } else {
     // Transfer the code to interpreter.
     Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
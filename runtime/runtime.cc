@@ -1051,15 +1051,7 @@ void Runtime::InitNonZygoteOrPostFork(
   // Avoid creating the runtime thread pool for system server since it will not be used and would
   // waste memory.
   if (!is_system_server) {
-    ScopedTrace timing("CreateThreadPool");
-    constexpr size_t kStackSize = 64 * KB;
-    constexpr size_t kMaxRuntimeWorkers = 4u;
-    const size_t num_workers =
-        std::min(static_cast<size_t>(std::thread::hardware_concurrency()), kMaxRuntimeWorkers);
-    MutexLock mu(Thread::Current(), *Locks::runtime_thread_pool_lock_);
-    CHECK(thread_pool_ == nullptr);
-    thread_pool_.reset(new ThreadPool("Runtime", num_workers, /*create_peers=*/false, kStackSize));
-    thread_pool_->StartWorkers(Thread::Current());
+    CreateThreadPool();
   }
 
   // Reset the gc performance data at zygote fork so that the GCs
@@ -2922,6 +2914,18 @@ Runtime::ScopedThreadPoolUsage::~ScopedThreadPoolUsage() {
   Runtime::Current()->ReleaseThreadPool();
 }
 
+void Runtime::CreateThreadPool() {
+  ScopedTrace timing("CreateThreadPool");
+  constexpr size_t kStackSize = 64 * KB;
+  constexpr size_t kMaxRuntimeWorkers = 4u;
+  const size_t num_workers =
+      std::min(static_cast<size_t>(std::thread::hardware_concurrency()), kMaxRuntimeWorkers);
+  MutexLock mu(Thread::Current(), *Locks::runtime_thread_pool_lock_);
+  CHECK(thread_pool_ == nullptr);
+  thread_pool_.reset(new ThreadPool("Runtime", num_workers, /*create_peers=*/false, kStackSize));
+  thread_pool_->StartWorkers(Thread::Current());
+}
+
 bool Runtime::DeleteThreadPool() {
   // Make sure workers are started to prevent thread shutdown errors.
   WaitForThreadPoolWorkersToStart();
@@ -927,6 +927,9 @@ class Runtime {
     return verifier_logging_threshold_ms_;
   }
 
+  // Create the thread pool used for loading app images and other startup work.
+  void CreateThreadPool() REQUIRES(!Locks::runtime_thread_pool_lock_);
+
   // Atomically delete the thread pool if the reference count is 0.
   bool DeleteThreadPool() REQUIRES(!Locks::runtime_thread_pool_lock_);
 
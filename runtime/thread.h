@@ -1003,6 +1003,16 @@ class Thread {
     is_runtime_thread_ = is_runtime_thread;
   }
 
+  // The method whose baseline compiled frame should check, at its next suspend point,
+  // whether it can move to OSR compiled code. See Jit::CanTransferBaselineFrameToOsr.
+  ArtMethod* GetBaselineOsrMethod() const {
+    return baseline_osr_method_;
+  }
+
+  void SetBaselineOsrMethod(ArtMethod* method) {
+    baseline_osr_method_ = method;
+  }
+
   uint32_t CorePlatformApiCookie() {
     return core_platform_api_cookie_;
   }
@@ -1886,6 +1896,10 @@ class Thread {
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // Set by the JIT when a baseline compiled frame of this method should be moved to OSR
+  // compiled code. Only accessed by this thread.
+  ArtMethod* baseline_osr_method_ = nullptr;
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Point {
+  int x;
+  int y;
+
+  Point(int x, int y) {
+    this.x = x;
+    this.y = y;
+  }
+}
+
+public class Main {
+  static Object sink;
+
+  /// CHECK-START: int Main.$noinline$escapeOnOnePath(int, int, boolean) partial_escape_analysis (before)
+  /// CHECK:     NewInstance
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$escapeOnOnePath(int, int, boolean) partial_escape_analysis (after)
+  /// CHECK:     If
+  /// CHECK:     NewInstance
+  /// CHECK:     InstanceFieldSet
+  /// CHECK:     InstanceFieldSet
+  /// CHECK:     StaticFieldSet
+  /// CHECK-NOT: NewInstance
+
+  /// CHECK-START: int Main.$noinline$escapeOnOnePath(int, int, boolean) partial_escape_analysis (after)
+  /// CHECK-NOT: InstanceFieldGet
+  static int $noinline$escapeOnOnePath(int x, int y, boolean escape) {
+    Point p = new Point(x, y);
+    if (escape) {
+      sink = p;
+      return -1;
+    }
+    return p.x + p.y;
+  }
+
+  // The object escapes before the merge, and the loads after the merge would need
+  // a phi of the materialized object and the scalar replaced one.
+
+  /// CHECK-START: int Main.$noinline$escapeBeforeMerge(int, int, boolean) partial_escape_analysis (after)
+  /// CHECK:     NewInstance
+  /// CHECK:     If
+  /// CHECK-NOT: NewInstance
+  static int $noinline$escapeBeforeMerge(int x, int y, boolean escape) {
+    Point p = new Point(x, y);
+    if (escape) {
+      sink = p;
+    }
+    return p.x - p.y;
+  }
+
+  public static void main(String[] args) {
+    System.out.println($noinline$escapeOnOnePath(1, 2, false));
+    System.out.println($noinline$escapeOnOnePath(1, 2, true));
+    System.out.println(((Point) sink).y - ((Point) sink).x);
+    System.out.println($noinline$escapeBeforeMerge(3, 1, true));
+  }
+}
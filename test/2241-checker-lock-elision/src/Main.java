@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static int a;
+  static int b;
+
+  /// CHECK-START: int Main.$noinline$elide(int) lock_elision (before)
+  /// CHECK:     MonitorOperation kind:enter
+
+  /// CHECK-START: int Main.$noinline$elide(int) lock_elision (after)
+  /// CHECK-NOT: MonitorOperation
+  static int $noinline$elide(int x) {
+    Object lock = new Object();
+    synchronized (lock) {
+      a += x;
+    }
+    return a;
+  }
+
+  /// CHECK-START: void Main.$noinline$coarsen(java.lang.Object) lock_elision (before)
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK:     MonitorOperation kind:exit
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK:     MonitorOperation kind:exit
+
+  /// CHECK-START: void Main.$noinline$coarsen(java.lang.Object) lock_elision (after)
+  /// CHECK:     MonitorOperation kind:enter
+  /// CHECK-NOT: MonitorOperation kind:enter
+  static void $noinline$coarsen(Object lock) {
+    synchronized (lock) {
+      a++;
+    }
+    synchronized (lock) {
+      b++;
+    }
+  }
+
+  public static void main(String[] args) {
+    System.out.println($noinline$elide(42));
+    Object lock = new Object();
+    for (int i = 0; i < 3; ++i) {
+      $noinline$coarsen(lock);
+    }
+    System.out.println(b);
+    System.out.println(!Thread.holdsLock(lock));
+  }
+}
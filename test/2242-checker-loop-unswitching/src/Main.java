@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static int sideEffect;
+
+  /// CHECK-START: void Main.$noinline$xorOrMul(int[], boolean) loop_optimization (before)
+  /// CHECK-DAG: Xor loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: Mul loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START: void Main.$noinline$xorOrMul(int[], boolean) loop_optimization (after)
+  /// CHECK-DAG: Xor loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-DAG: Mul loop:<<Loop2:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<Loop1>>" != "<<Loop2>>"
+
+  /// CHECK-START-ARM64: void Main.$noinline$xorOrMul(int[], boolean) loop_optimization (after)
+  /// CHECK-DAG: VecXor loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-DAG: VecMul loop:<<Loop2:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<Loop1>>" != "<<Loop2>>"
+  static void $noinline$xorOrMul(int[] a, boolean flag) {
+    for (int i = 0; i < a.length; i++) {
+      if (flag) {
+        a[i] ^= 1;
+      } else {
+        a[i] *= 3;
+      }
+    }
+  }
+
+  /// CHECK-START: void Main.$noinline$notUnswitched(int[], boolean) loop_optimization (after)
+  /// CHECK-DAG: Xor                  loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: InvokeStaticOrDirect loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: Mul                  loop:<<Loop>>      outer_loop:none
+  static void $noinline$notUnswitched(int[] a, boolean flag) {
+    for (int i = 0; i < a.length; i++) {
+      if (flag) {
+        a[i] ^= 1;
+        $noinline$sideEffect();
+      } else {
+        a[i] *= 3;
+      }
+    }
+  }
+
+  static void $noinline$sideEffect() {
+    sideEffect++;
+  }
+
+  public static void main(String[] args) {
+    int[] a = new int[100];
+    for (int i = 0; i < a.length; i++) {
+      a[i] = i;
+    }
+    $noinline$xorOrMul(a, true);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i ^ 1, a[i]);
+    }
+    $noinline$xorOrMul(a, false);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals((i ^ 1) * 3, a[i]);
+    }
+    $noinline$notUnswitched(a, true);
+    expectEquals(a.length, sideEffect);
+    $noinline$notUnswitched(a, false);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals((((i ^ 1) * 3) ^ 1) * 3, a[i]);
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+public class Main {
+
+  /// CHECK-START: void Main.$noinline$conditionalMin(int[], int[], int[]) loop_optimization (before)
+  /// CHECK-DAG: Min loop:<<Loop:B\d+>> outer_loop:none
+
+  /// CHECK-START-{ARM,ARM64,X86_64}: void Main.$noinline$conditionalMin(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-DAG: VecMin loop:<<Loop:B\d+>> outer_loop:none
+  //
+  // The conditional is turned into a select and then a MIN by the simplifier.
+  static void $noinline$conditionalMin(int[] a, int[] b, int[] c) {
+    for (int i = 0; i < c.length; i++) {
+      int x = a[i];
+      int y = b[i];
+      c[i] = x < y ? x : y;
+    }
+  }
+
+  /// CHECK-START-{ARM,ARM64,X86_64}: void Main.$noinline$maxBytes(byte[], byte[]) loop_optimization (after)
+  /// CHECK-DAG: VecMax loop:<<Loop:B\d+>> outer_loop:none
+  static void $noinline$maxBytes(byte[] a, byte[] b) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = (byte) Math.max(a[i], b[i]);
+    }
+  }
+
+  /// CHECK-START-{ARM,ARM64,X86,X86_64}: int Main.$noinline$minReduction(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecMin    loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: VecReduce loop:none
+  //
+  // The 32-bit x86 code generator folds the lanes with pshufd and pminsd.
+  /// CHECK-START-X86: int Main.$noinline$minReduction(int[]) disassembly (after)
+  /// CHECK:     VecReduce loop:none
+  /// CHECK:     pshufd
+  /// CHECK:     pminsd
+  /// CHECK:     pshufd
+  /// CHECK:     pminsd
+  /// CHECK-NOT: pmaxsd
+  /// CHECK:     VecExtractScalar
+  static int $noinline$minReduction(int[] a) {
+    int min = Integer.MAX_VALUE;
+    for (int i = 0; i < a.length; i++) {
+      min = Math.min(min, a[i]);
+    }
+    return min;
+  }
+
+  /// CHECK-START-{ARM64,X86,X86_64}: int Main.$noinline$maxReduction(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecMax    loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: VecReduce loop:none
+  //
+  /// CHECK-START-X86: int Main.$noinline$maxReduction(int[]) disassembly (after)
+  /// CHECK:     VecReduce loop:none
+  /// CHECK:     pshufd
+  /// CHECK:     pmaxsd
+  /// CHECK:     pshufd
+  /// CHECK:     pmaxsd
+  /// CHECK-NOT: pminsd
+  /// CHECK:     VecExtractScalar
+  static int $noinline$maxReduction(int[] a) {
+    int max = Integer.MIN_VALUE;
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] > max) {
+        max = a[i];
+      }
+    }
+    return max;
+  }
+
+  /// CHECK-START-ARM64: int Main.$noinline$sumBytes(byte[]) loop_optimization (after)
+  /// CHECK-DAG: VecDotProd type:Int8 loop:<<Loop:B\d+>> outer_loop:none
+  static int $noinline$sumBytes(byte[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-{ARM64,X86_64}: int Main.$noinline$sumShorts(short[]) loop_optimization (after)
+  /// CHECK-DAG: VecDotProd type:Int16 loop:<<Loop:B\d+>> outer_loop:none
+  static int $noinline$sumShorts(short[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum = a[i] + sum;
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    int[] a = new int[97];
+    int[] b = new int[97];
+    int[] c = new int[97];
+    byte[] ba = new byte[97];
+    byte[] bb = new byte[97];
+    short[] sa = new short[97];
+    int expectedMin = Integer.MAX_VALUE;
+    int expectedMax = Integer.MIN_VALUE;
+    int expectedByteSum = 0;
+    int expectedShortSum = 0;
+    for (int i = 0; i < a.length; i++) {
+      a[i] = (i * 7919) % 101 - 50;
+      b[i] = (i * 104729) % 103 - 51;
+      ba[i] = (byte) (i * 37);
+      bb[i] = (byte) (i * 53);
+      sa[i] = (short) (i * 7001);
+      expectedMin = Math.min(expectedMin, a[i]);
+      expectedMax = Math.max(expectedMax, a[i]);
+      expectedByteSum += ba[i];
+      expectedShortSum += sa[i];
+    }
+
+    $noinline$conditionalMin(a, b, c);
+    for (int i = 0; i < c.length; i++) {
+      expectEquals(Math.min(a[i], b[i]), c[i]);
+    }
+    expectEquals(expectedByteSum, $noinline$sumBytes(ba));
+    expectEquals(expectedShortSum, $noinline$sumShorts(sa));
+    expectEquals(expectedMin, $noinline$minReduction(a));
+    expectEquals(expectedMax, $noinline$maxReduction(a));
+    expectEquals(Integer.MAX_VALUE, $noinline$minReduction(new int[0]));
+    $noinline$maxBytes(ba, bb);
+    for (int i = 0; i < ba.length; i++) {
+      expectEquals(Math.max((byte) (i * 37), (byte) (i * 53)), ba[i]);
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  int intField;
+
+  /// CHECK-START: int Main.$noinline$earlyReturn(boolean) code_sinking (before)
+  /// CHECK: <<New:l\d+>> NewInstance
+  /// CHECK:              InstanceFieldSet [<<New>>,{{i\d+}}]
+  /// CHECK:              If
+  /// CHECK:              begin_block
+
+  /// CHECK-START: int Main.$noinline$earlyReturn(boolean) code_sinking (after)
+  /// CHECK-NOT:          NewInstance
+  /// CHECK:              If
+  /// CHECK:              begin_block
+  /// CHECK: <<New:l\d+>> NewInstance
+  /// CHECK-NOT:          begin_block
+  /// CHECK:              InstanceFieldSet [<<New>>,{{i\d+}}]
+  /// CHECK-NOT:          begin_block
+  /// CHECK:              InvokeStaticOrDirect [<<New>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$get
+  static int $noinline$earlyReturn(boolean skip) {
+    Main m = new Main();
+    m.intField = 42;
+    if (skip) {
+      return 0;
+    }
+    return $noinline$get(m);
+  }
+
+  /// CHECK-START: int Main.$noinline$diamond(int) code_sinking (after)
+  /// CHECK-NOT:          NewArray
+  /// CHECK:              If
+  /// CHECK:              begin_block
+  /// CHECK: <<New:l\d+>> NewArray
+  /// CHECK-NOT:          begin_block
+  /// CHECK:              ArraySet [<<New>>,{{i\d+}},{{i\d+}}]
+  /// CHECK-NOT:          begin_block
+  /// CHECK:              InvokeStaticOrDirect [<<New>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$sum
+  static int $noinline$diamond(int x) {
+    int[] array = new int[2];
+    array[0] = x;
+    int result;
+    if (x > 0) {
+      result = $noinline$sum(array);
+    } else {
+      result = -1;
+    }
+    return result;
+  }
+
+  /// CHECK-START: int Main.$noinline$switchArm(int) code_sinking (after)
+  /// CHECK-NOT:          NewInstance
+  /// CHECK:              PackedSwitch
+  /// CHECK:              begin_block
+  /// CHECK: <<New:l\d+>> NewInstance
+  /// CHECK-NOT:          begin_block
+  /// CHECK:              InstanceFieldSet [<<New>>,{{i\d+}}]
+  /// CHECK-NOT:          begin_block
+  /// CHECK:              InvokeStaticOrDirect [<<New>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$get
+  static int $noinline$switchArm(int x) {
+    Main m = new Main();
+    m.intField = x;
+    switch (x) {
+      case 1: return $noinline$get(m);
+      case 2: return 20;
+      case 3: return 30;
+      case 4: return 40;
+      default: return 0;
+    }
+  }
+
+  // The allocation is used on both paths, there is nothing to gain.
+  /// CHECK-START: int Main.$noinline$usedOnBothPaths(boolean) code_sinking (after)
+  /// CHECK:              NewInstance
+  /// CHECK:              If
+  static int $noinline$usedOnBothPaths(boolean flag) {
+    Main m = new Main();
+    m.intField = 1;
+    if (flag) {
+      return $noinline$get(m) + 1;
+    }
+    return $noinline$get(m);
+  }
+
+  // Do not move the allocation into the loop.
+  /// CHECK-START: int Main.$noinline$usedInLoop(int) code_sinking (after)
+  /// CHECK:              NewInstance                                    loop:none
+  /// CHECK:              InvokeStaticOrDirect method_name:Main.$noinline$get loop:{{B\d+}}
+  static int $noinline$usedInLoop(int n) {
+    Main m = new Main();
+    m.intField = 3;
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += $noinline$get(m);
+    }
+    return sum;
+  }
+
+  static int $noinline$get(Main m) {
+    return m.intField;
+  }
+
+  static int $noinline$sum(int[] array) {
+    int sum = 0;
+    for (int value : array) {
+      sum += value;
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(0, $noinline$earlyReturn(true));
+    expectEquals(42, $noinline$earlyReturn(false));
+    expectEquals(7, $noinline$diamond(7));
+    expectEquals(-1, $noinline$diamond(-7));
+    expectEquals(1, $noinline$switchArm(1));
+    expectEquals(20, $noinline$switchArm(2));
+    expectEquals(0, $noinline$switchArm(5));
+    expectEquals(2, $noinline$usedOnBothPaths(true));
+    expectEquals(1, $noinline$usedOnBothPaths(false));
+    expectEquals(15, $noinline$usedInLoop(5));
+    expectEquals(0, $noinline$usedInLoop(0));
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
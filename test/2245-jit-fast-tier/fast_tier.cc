@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include "art_method-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "oat_quick_method_header.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "stack_map.h"
+
+namespace art {
+
+extern "C" JNIEXPORT jstring JNICALL Java_Main_getJitTier(JNIEnv* env,
+                                                         jclass,
+                                                         jobject java_method) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = ArtMethod::FromReflectedMethod(soa, java_method);
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  const char* tier = "interpreter";
+  if (jit != nullptr && jit->GetCodeCache()->ContainsPc(entry_point)) {
+    const uint8_t* code_info =
+        OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr();
+    if (CodeInfo::IsBaseline(code_info)) {
+      tier = "baseline";
+    } else if (CodeInfo::IsFastTier(code_info)) {
+      tier = "fast";
+    } else {
+      tier = "optimized";
+    }
+  }
+  return env->NewStringUTF(tier);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_Main_collectJitCodeCache(JNIEnv*, jclass) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  Thread* self = Thread::Current();
+  jit->WaitForCompilationToFinish(self);
+  ScopedObjectAccess soa(self);
+  jit->GetCodeCache()->GarbageCollectCache(self);
+}
+
+}  // namespace art
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      Method hot = Main.class.getDeclaredMethod("$noinline$hot", int.class);
+      Method cold = Main.class.getDeclaredMethod("$noinline$cold", int.class);
+
+      // Both methods get baseline compiled first, and fast tier compiled once their
+      // baseline code has run -Xjitfasttierthreshold times.
+      while (!getJitTier(hot).equals("fast")) {
+        for (int i = 0; i < 100; ++i) {
+          $noinline$hot(i);
+        }
+        waitForCompilation();
+      }
+      while (!getJitTier(cold).equals("fast")) {
+        for (int i = 0; i < 100; ++i) {
+          $noinline$cold(i);
+        }
+        waitForCompilation();
+      }
+
+      // The first collection starts polling the liveness of the fast tier code, the
+      // second one removes the code that did not run in between.
+      collectJitCodeCache();
+      $noinline$hot(0);
+      collectJitCodeCache();
+      assertEquals("fast", getJitTier(hot));
+      assertEquals("interpreter", getJitTier(cold));
+    }
+    System.out.println("Done");
+  }
+
+  public static int $noinline$hot(int value) {
+    return value * 31 + 7;
+  }
+
+  public static int $noinline$cold(int value) {
+    return value * 17 + 3;
+  }
+
+  public static void assertEquals(String expected, String actual) {
+    if (!expected.equals(actual)) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void waitForCompilation();
+  private static native String getJitTier(Method method);
+  private static native void collectJitCodeCache();
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include "art_method-inl.h"
+#include "jit/jit.h"
+#include "jit/profiling_info.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+extern "C" JNIEXPORT void JNICALL Java_Main_ensureProfilingInfo(JNIEnv* env,
+                                                                jclass,
+                                                                jobject java_method) {
+  if (Runtime::Current()->GetJit() == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = ArtMethod::FromReflectedMethod(soa, java_method);
+  ProfilingInfo::Create(soa.Self(), method, /* retry_allocation= */ true);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_getNumberOfDeoptimizations(JNIEnv* env,
+                                                                       jclass,
+                                                                       jobject java_method) {
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = ArtMethod::FromReflectedMethod(soa, java_method);
+  ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+  return (info != nullptr) ? info->GetNumberOfDeoptimizations() : 0;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isRecompilationQueued(JNIEnv* env,
+                                                                     jclass,
+                                                                     jobject java_method) {
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = ArtMethod::FromReflectedMethod(soa, java_method);
+  ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+  return (info != nullptr) && info->IsRecompilationQueued();
+}
+
+}  // namespace art
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+import java.util.concurrent.CountDownLatch;
+
+class Base {
+  int getValue() {
+    return 0;
+  }
+}
+
+class A extends Base {
+  int getValue() {
+    return 1;
+  }
+}
+
+class B extends Base {
+  int getValue() {
+    return 2;
+  }
+}
+
+public class Main {
+  static final int NUMBER_OF_THREADS = 4;
+
+  static Base sReceiver = new A();
+  static volatile boolean sStop = true;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      Method run = Main.class.getDeclaredMethod("$noinline$run", CountDownLatch.class);
+
+      // Fill the inline cache of the call in `$noinline$run` with A only, so that the
+      // compiled code speculates on the receiver type.
+      ensureProfilingInfo(run);
+      for (int i = 0; i < 10; ++i) {
+        $noinline$run(null);
+      }
+      ensureJitCompiled(Main.class, "$noinline$run");
+
+      // Stop the JIT workers, recompilations stay in the queue.
+      stopJit();
+      if (isRecompilationQueued(run)) {
+        throw new Error("Unexpected queued recompilation before deoptimizing");
+      }
+
+      sStop = false;
+      CountDownLatch started = new CountDownLatch(NUMBER_OF_THREADS);
+      Thread[] threads = new Thread[NUMBER_OF_THREADS];
+      for (int i = 0; i < NUMBER_OF_THREADS; ++i) {
+        threads[i] = new Thread(() -> $noinline$run(started));
+        threads[i].start();
+      }
+      started.await();
+      // Let the threads reach the loop of the compiled code.
+      Thread.sleep(100);
+
+      // Every thread running the compiled code deoptimizes on the type guard.
+      sReceiver = new B();
+      Thread.sleep(100);
+      sStop = true;
+      for (Thread thread : threads) {
+        thread.join();
+      }
+
+      if (getNumberOfDeoptimizations(run) == 0) {
+        throw new Error("Expected the compiled code to deoptimize");
+      }
+      // All deoptimizing threads share the one queued recompilation of `run`.
+      if (!isRecompilationQueued(run)) {
+        throw new Error("Expected a queued recompilation");
+      }
+      startJit();
+      waitForCompilation();
+      if (isRecompilationQueued(run)) {
+        throw new Error("Expected the queued recompilation to be done");
+      }
+    }
+    System.out.println("Done");
+  }
+
+  public static int $noinline$run(CountDownLatch started) {
+    if (started != null) {
+      started.countDown();
+    }
+    int sum = 0;
+    do {
+      sum += sReceiver.getValue();
+    } while (!sStop);
+    return sum;
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native void stopJit();
+  private static native void startJit();
+  private static native void waitForCompilation();
+  private static native void ensureProfilingInfo(Method method);
+  private static native int getNumberOfDeoptimizations(Method method);
+  private static native boolean isRecompilationQueued(Method method);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class Main {
+  static int sField = 0;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (hasJit()) {
+      Method loop = Main.class.getDeclaredMethod("$noinline$loop", int.class);
+      Method emptyLoop = Main.class.getDeclaredMethod("$noinline$emptyLoop", int.class);
+
+      // Get both methods baseline compiled, with loops too short for the interpreter to
+      // OSR compile them.
+      while (!getJitTier(loop).equals("baseline")) {
+        $noinline$loop(10);
+        waitForCompilation();
+      }
+      while (!getJitTier(emptyLoop).equals("baseline")) {
+        $noinline$emptyLoop(0);
+        waitForCompilation();
+      }
+
+      // The hotness count of the baseline code overflows at a back edge of the loop,
+      // which gets it OSR compiled. A later overflow moves the frame to the OSR code.
+      if ($noinline$loop(1 << 30) != 1) {
+        throw new Error("Expected the loop to move to OSR compiled code");
+      }
+
+      // The hotness count of the baseline code overflows at the method entry. The loop
+      // never runs, so the method must not get OSR compiled.
+      for (int i = 0; i < 0x20000; ++i) {
+        $noinline$emptyLoop(0);
+      }
+      waitForCompilation();
+      if (hasOsrCode(emptyLoop)) {
+        throw new Error("Unexpected OSR compilation of $noinline$emptyLoop");
+      }
+    }
+    System.out.println("Done");
+  }
+
+  // Returns 1 once the loop runs in OSR compiled code, 0 if it never does.
+  public static int $noinline$loop(int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+      if ((i & 0xffff) == 0 && isInOsrCode("$noinline$loop")) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  public static int $noinline$emptyLoop(int iterations) {
+    int sum = sField;
+    for (int i = 0; i < iterations; ++i) {
+      sum += i;
+    }
+    return sum;
+  }
+
+  private static native boolean hasJit();
+  private static native void waitForCompilation();
+  private static native String getJitTier(Method method);
+  private static native boolean isInOsrCode(String methodName);
+  private static native boolean hasOsrCode(Method method);
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.BufferedReader;
+import java.io.FileReader;
+import java.io.IOException;
+
+public class Main {
+
+  /// CHECK-START-X86_64: void Main.$noinline$addInts(int[], int[]) loop_optimization (after)
+  /// CHECK-DAG: <<Add:d\d+>> VecAdd packed_type:Int32 vector_length:8 loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:              VecStore [{{l\d+}},{{i\d+}},<<Add>>]         loop:<<Loop>>      outer_loop:none
+  static void $noinline$addInts(int[] a, int[] b) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] += b[i];
+    }
+  }
+
+  /// CHECK-START-X86_64: void Main.$noinline$maxBytes(byte[], byte[]) loop_optimization (after)
+  /// CHECK-DAG: VecMax packed_type:Int8 vector_length:32 loop:<<Loop:B\d+>> outer_loop:none
+  static void $noinline$maxBytes(byte[] a, byte[] b) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = (byte) Math.max(a[i], b[i]);
+    }
+  }
+
+  /// CHECK-START-X86_64: double Main.$noinline$mulDoubles(double[], double[]) loop_optimization (after)
+  /// CHECK-DAG: VecMul packed_type:Float64 vector_length:4 loop:<<Loop:B\d+>> outer_loop:none
+  static double $noinline$mulDoubles(double[] a, double[] b) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] *= b[i];
+    }
+    return a[a.length - 1];
+  }
+
+  // The reduction folds the upper 128-bit lane of the YMM register onto the lower one.
+  /// CHECK-START-X86_64: int Main.$noinline$sumInts(int[]) loop_optimization (after)
+  /// CHECK-DAG: VecAdd    packed_type:Int32 vector_length:8 loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: VecReduce packed_type:Int32 vector_length:8 loop:none
+  static int $noinline$sumInts(int[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) throws IOException {
+    if (!hasAvx2()) {
+      // The compiled code uses AVX2 instructions this CPU does not have.
+      System.out.println("passed");
+      return;
+    }
+    int[] a = new int[101];
+    int[] b = new int[101];
+    byte[] ba = new byte[101];
+    byte[] bb = new byte[101];
+    double[] da = new double[101];
+    double[] db = new double[101];
+    int expectedSum = 0;
+    for (int i = 0; i < a.length; i++) {
+      a[i] = i * 7;
+      b[i] = i - 50;
+      ba[i] = (byte) (i * 37);
+      bb[i] = (byte) (i * 53);
+      da[i] = i;
+      db[i] = 0.5;
+      expectedSum += i - 50;
+    }
+
+    $noinline$addInts(a, b);
+    for (int i = 0; i < a.length; i++) {
+      expectEquals(i * 7 + i - 50, a[i]);
+    }
+    $noinline$maxBytes(ba, bb);
+    for (int i = 0; i < ba.length; i++) {
+      expectEquals(Math.max((byte) (i * 37), (byte) (i * 53)), ba[i]);
+    }
+    if ($noinline$mulDoubles(da, db) != 50.0) {
+      throw new Error("Unexpected product " + da[da.length - 1]);
+    }
+    expectEquals(expectedSum, $noinline$sumInts(b));
+    System.out.println("passed");
+  }
+
+  private static boolean hasAvx2() throws IOException {
+    try (BufferedReader reader = new BufferedReader(new FileReader("/proc/cpuinfo"))) {
+      String line;
+      while ((line = reader.readLine()) != null) {
+        if (line.startsWith("flags") && line.contains(" avx2")) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    assertEquals(small(1) + medium(1) + large(1), $noinline$hot(2));
+    assertEquals(medium(2), $noinline$warm(2));
+    assertEquals(small(3) + medium(3), $noinline$cold(3));
+    System.out.println("Done");
+  }
+
+  // The loop of a method the profile marks hot doubles the callee size limit.
+
+  /// CHECK-START: int Main.$noinline$hot(int) inliner (before)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.large
+
+  /// CHECK-START: int Main.$noinline$hot(int) inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect method_name:Main.large
+  static int $noinline$hot(int n) {
+    int result = 0;
+    for (int i = 1; i < n; ++i) {
+      result += small(i) + medium(i) + large(i);
+    }
+    return result;
+  }
+
+  // Outside of a loop, the call sites of a hot method keep the default limits.
+
+  /// CHECK-START: int Main.$noinline$warm(int) inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect method_name:Main.medium
+
+  /// CHECK-START: int Main.$noinline$warm(int) inliner (after)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.large
+  static int $noinline$warm(int n) {
+    return (n == 0) ? large(n) : medium(n);
+  }
+
+  // Call sites of a method the profile does not mark hot only inline small methods.
+
+  /// CHECK-START: int Main.$noinline$cold(int) inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect method_name:Main.small
+
+  /// CHECK-START: int Main.$noinline$cold(int) inliner (after)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.medium
+  static int $noinline$cold(int n) {
+    return small(n) + medium(n);
+  }
+
+  // 3 code units, below the cold call site limit of 8.
+  static int small(int x) {
+    return x + 1;
+  }
+
+  // 19 code units, above the cold call site limit and below the default limit of 32.
+  static int medium(int x) {
+    x = x * 31 + 7;
+    x = x ^ 45;
+    x = x * 17 - 3;
+    x = x & 127;
+    x = x | 64;
+    x = x * 13;
+    return x + 5;
+  }
+
+  // 45 code units, above the default limit and below the hot call site limit of 64.
+  static int large(int x) {
+    x = x * 31 + 7;
+    x = x ^ 45;
+    x = x * 17 - 3;
+    x = x & 127;
+    x = x | 64;
+    x = x * 13 + 5;
+    x = x ^ 99;
+    x = x * 19 - 11;
+    x = x & 120;
+    x = x | 3;
+    x = x * 23 + 9;
+    x = x ^ 77;
+    x = x * 29 - 13;
+    x = x & 111;
+    x = x | 17;
+    return x + 1;
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
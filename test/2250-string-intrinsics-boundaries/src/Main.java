@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Covers two full 16-byte chunks of uncompressed chars and the tails after them.
+  static final int MAX_LENGTH = 40;
+
+  // The filler char of compressed strings, and of uncompressed ones.
+  static final char COMPRESSED_CHAR = 'a';
+  static final char UNCOMPRESSED_CHAR = '\u0101';
+
+  // Chars that differ from the fillers in the low byte only, and in the high byte only.
+  static final char[] OTHER_CHARS = { 'b', '\u0102', '\u0201' };
+
+  public static void main(String[] args) {
+    for (int length = 0; length <= MAX_LENGTH; ++length) {
+      testEquals(length, COMPRESSED_CHAR);
+      testEquals(length, UNCOMPRESSED_CHAR);
+      testIndexOf(length, COMPRESSED_CHAR);
+      testIndexOf(length, UNCOMPRESSED_CHAR);
+    }
+    testIndexOfSupplementary();
+    System.out.println("Done");
+  }
+
+  static void testEquals(int length, char filler) {
+    char[] chars = filled(length, filler);
+    String str = new String(chars);
+    assertEquals(true, $noinline$equals(str, new String(chars)));
+    assertEquals(false, $noinline$equals(str, new String(filled(length + 1, filler))));
+    if (length != 0) {
+      assertEquals(false, $noinline$equals(str, new String(filled(length - 1, filler))));
+    }
+    // A difference at any position, in particular in the last 8-byte word.
+    for (int i = 0; i < length; ++i) {
+      for (char other : OTHER_CHARS) {
+        char[] different = chars.clone();
+        different[i] = other;
+        String expected = new String(different);
+        assertEquals(false, $noinline$equals(str, expected));
+        assertEquals(false, $noinline$equals(expected, str));
+        assertEquals(true, $noinline$equals(expected, new String(different)));
+      }
+    }
+  }
+
+  static void testIndexOf(int length, char filler) {
+    char[] chars = filled(length, filler);
+    for (char other : OTHER_CHARS) {
+      String str = new String(chars);
+      assertEquals(-1, $noinline$indexOf(str, other));
+      assertEquals(length == 0 ? -1 : 0, $noinline$indexOf(str, filler));
+      // A single match at any position, in a 16-byte chunk or in the tail after them.
+      for (int i = 0; i < length; ++i) {
+        char[] withMatch = chars.clone();
+        withMatch[i] = other;
+        str = new String(withMatch);
+        assertEquals(i, $noinline$indexOf(str, other));
+        assertEquals(i, $noinline$indexOf(str, (int) other));
+        for (int from = -1; from <= length + 1; ++from) {
+          assertEquals(from <= i ? i : -1, $noinline$indexOf(str, other, from));
+        }
+      }
+      // The first of two matches.
+      if (length >= 3) {
+        char[] withMatches = chars.clone();
+        withMatches[length / 2] = other;
+        withMatches[length - 1] = other;
+        str = new String(withMatches);
+        assertEquals(length / 2, $noinline$indexOf(str, other));
+        assertEquals(length - 1, $noinline$indexOf(str, other, length / 2 + 1));
+      }
+    }
+  }
+
+  static void testIndexOfSupplementary() {
+    String str = "abc\uD801\uDC00def";
+    assertEquals(3, $noinline$indexOf(str, 0x10400));
+    assertEquals(-1, $noinline$indexOf(str, 0x10401));
+    assertEquals(-1, $noinline$indexOf(str, 0x10400, 4));
+  }
+
+  static char[] filled(int length, char filler) {
+    char[] chars = new char[length];
+    java.util.Arrays.fill(chars, filler);
+    return chars;
+  }
+
+  static boolean $noinline$equals(String str, Object other) {
+    return str.equals(other);
+  }
+
+  static int $noinline$indexOf(String str, char ch) {
+    return str.indexOf(ch);
+  }
+
+  static int $noinline$indexOf(String str, int ch) {
+    return str.indexOf(ch);
+  }
+
+  static int $noinline$indexOf(String str, char ch, int from) {
+    return str.indexOf(ch, from);
+  }
+
+  static int $noinline$indexOf(String str, int ch, int from) {
+    return str.indexOf(ch, from);
+  }
+
+  static void assertEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
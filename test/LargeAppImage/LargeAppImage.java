@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class LargeAppImage {
+    // Initialized at compile time, so that the app image contains more than a megabyte
+    // of objects referencing each other.
+    public static Object[] objects = new Object[65536];
+
+    static {
+        for (int i = 0; i != objects.length; ++i) {
+            objects[i] = new Object[] { objects };
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#!/bin/bash
+#
+# Copyright (C) 2020 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#
+# This script compares the app image size and the time to run a program on host
+# for each --image-format supported by dex2oat. It needs a built host ART
+# (see tools/art) and a profile for the jar, so that the app image is not empty.
+#
+
+if [[ "$#" -lt 3 ]]; then
+  echo "Usage $0 <jar> <profile> <main-class> [runs]"
+  echo "Example $0 app.jar app.prof Main 10"
+  exit 1
+fi
+
+JAR=$1
+PROFILE=$2
+MAIN=$3
+RUNS=${4:-5}
+ISA=x86_64
+ART="${ANDROID_BUILD_TOP}/art/tools/art --64"
+
+# The dex2oat flags of each configuration.
+CONFIGS=(
+  "--image-format=uncompressed"
+  "--image-format=lz4"
+  "--image-format=lz4hc"
+  "--image-format=zstd"
+  "--image-format=zstd --max-image-block-size=262144 --image-dictionary-size=65536"
+)
+
+WORK_DIR=$(mktemp -d)
+trap "rm -rf ${WORK_DIR}" EXIT
+
+printf "%-80s %12s %12s\n" "Configuration" "Image bytes" "Average ms"
+for i in "${!CONFIGS[@]}"; do
+  CONFIG=${CONFIGS[$i]}
+  DIR=${WORK_DIR}/${i}
+  mkdir -p ${DIR}/oat/${ISA}
+  cp ${JAR} ${DIR}/app.jar
+
+  COMPILER_OPTIONS=""
+  for FLAG in --compiler-filter=speed-profile --profile-file=${PROFILE} \
+              --app-image-file=${DIR}/oat/${ISA}/app.art ${CONFIG}; do
+    COMPILER_OPTIONS+=" -Xcompiler-option ${FLAG}"
+  done
+
+  # Compile once and keep the oat directory for the timed runs.
+  if ! ${ART} --no-clean ${COMPILER_OPTIONS} -cp ${DIR}/app.jar ${MAIN} > /dev/null; then
+    echo "Failed to compile and run with ${CONFIG}"
+    exit 1
+  fi
+  IMAGE_SIZE=$(stat -c %s ${DIR}/oat/${ISA}/app.art)
+
+  TOTAL_NS=0
+  for RUN in $(seq ${RUNS}); do
+    START_NS=$(date +%s%N)
+    ${ART} --no-clean --no-compile -cp ${DIR}/app.jar ${MAIN} > /dev/null
+    TOTAL_NS=$((TOTAL_NS + $(date +%s%N) - START_NS))
+  done
+  printf "%-80s %12d %12d\n" "${CONFIG}" ${IMAGE_SIZE} $((TOTAL_NS / RUNS / 1000000))
+done
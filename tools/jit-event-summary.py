@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2020 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Summarizes a JIT compilation event log (jit-events-PID.log), as written by the
+   JIT when running with -Xcompiler-option --dump-jit-events. See
+   compiler/jit/jit_logger.cc for the format of the file."""
+
+import argparse
+import collections
+import struct
+import sys
+
+_HEADER = struct.Struct('<IIIIQ')
+_MAGIC = 0x56454A41  # "AJEV"
+_VERSION = 1
+
+_RECORD_STRING = 1
+_RECORD_COMPILATION = 2
+
+# Must match the order of CompilationKind in runtime/compilation_kind.h.
+_COMPILATION_KINDS = ['osr', 'baseline', 'fast', 'optimized']
+
+
+class FormatError(Exception):
+  pass
+
+
+class Reader(object):
+  def __init__(self, data):
+    self._data = data
+    self._pos = 0
+
+  def done(self):
+    return self._pos >= len(self._data)
+
+  def byte(self):
+    if self._pos >= len(self._data):
+      raise FormatError('Unexpected end of file')
+    value = self._data[self._pos]
+    self._pos += 1
+    return value
+
+  def uleb128(self):
+    result = 0
+    shift = 0
+    while True:
+      byte = self.byte()
+      result |= (byte & 0x7f) << shift
+      if byte & 0x80 == 0:
+        return result
+      shift += 7
+
+  def bytes(self, size):
+    if self._pos + size > len(self._data):
+      raise FormatError('Unexpected end of file')
+    value = self._data[self._pos:self._pos + size]
+    self._pos += size
+    return value
+
+
+Pass = collections.namedtuple('Pass', ['name', 'duration_ns'])
+Inlining = collections.namedtuple('Inlining', ['depth', 'inlined', 'callee', 'reason'])
+Compilation = collections.namedtuple(
+    'Compilation',
+    ['time_stamp_ns', 'tid', 'method', 'kind', 'success', 'queue_wait_ns', 'compile_time_ns',
+     'code_size', 'deoptimizations', 'passes', 'inlinings'])
+
+
+def ParseLog(data):
+  if len(data) < _HEADER.size:
+    raise FormatError('File too small')
+  magic, version, pid, _, _ = _HEADER.unpack_from(data)
+  if magic != _MAGIC:
+    raise FormatError('Not a JIT event log')
+  if version != _VERSION:
+    raise FormatError('Unsupported version %d' % version)
+  reader = Reader(data[_HEADER.size:])
+  strings = {0: None}
+  compilations = []
+  while not reader.done():
+    kind = reader.byte()
+    if kind == _RECORD_STRING:
+      string_id = reader.uleb128()
+      strings[string_id] = reader.bytes(reader.uleb128()).decode('utf-8', 'replace')
+    elif kind == _RECORD_COMPILATION:
+      time_stamp_ns = reader.uleb128()
+      tid = reader.uleb128()
+      method = strings[reader.uleb128()]
+      compilation_kind = reader.uleb128()
+      success = reader.uleb128() != 0
+      queue_wait_ns = reader.uleb128()
+      compile_time_ns = reader.uleb128()
+      code_size = reader.uleb128()
+      deoptimizations = reader.uleb128()
+      passes = []
+      for _ in range(reader.uleb128()):
+        passes.append(Pass(strings[reader.uleb128()], reader.uleb128()))
+      inlinings = []
+      for _ in range(reader.uleb128()):
+        depth = reader.uleb128()
+        inlined = reader.uleb128() != 0
+        callee = strings[reader.uleb128()]
+        reason = strings[reader.uleb128()]
+        inlinings.append(Inlining(depth, inlined, callee, reason))
+      if compilation_kind < len(_COMPILATION_KINDS):
+        kind_name = _COMPILATION_KINDS[compilation_kind]
+      else:
+        kind_name = 'kind%d' % compilation_kind
+      compilations.append(Compilation(time_stamp_ns, tid, method, kind_name, success,
+                                      queue_wait_ns, compile_time_ns, code_size,
+                                      deoptimizations, passes, inlinings))
+    else:
+      raise FormatError('Unknown record kind %d' % kind)
+  return pid, compilations
+
+
+def Ms(ns):
+  return '%.3fms' % (ns / 1e6)
+
+
+def PrintSummary(pid, compilations, top):
+  print('JIT event log of pid %d: %d compilations' % (pid, len(compilations)))
+
+  print('\nPer compilation kind:')
+  by_kind = collections.defaultdict(list)
+  for c in compilations:
+    by_kind[c.kind].append(c)
+  for kind, entries in sorted(by_kind.items()):
+    successes = [c for c in entries if c.success]
+    total_time = sum(c.compile_time_ns for c in entries)
+    total_wait = sum(c.queue_wait_ns for c in entries)
+    total_size = sum(c.code_size for c in successes)
+    print('  %-10s %6d compilations (%d failed), compile time %s (mean %s), '
+          'queue wait mean %s, code size %d bytes (mean %d)' % (
+              kind, len(entries), len(entries) - len(successes), Ms(total_time),
+              Ms(total_time / len(entries)), Ms(total_wait / len(entries)), total_size,
+              total_size / max(len(successes), 1)))
+
+  print('\nSlowest compilations:')
+  for c in sorted(compilations, key=lambda c: c.compile_time_ns, reverse=True)[:top]:
+    print('  %s %s (%s, waited %s, %d bytes)' % (
+        Ms(c.compile_time_ns), c.method, c.kind, Ms(c.queue_wait_ns), c.code_size))
+
+  print('\nLongest queue waits:')
+  for c in sorted(compilations, key=lambda c: c.queue_wait_ns, reverse=True)[:top]:
+    print('  %s %s (%s)' % (Ms(c.queue_wait_ns), c.method, c.kind))
+
+  print('\nTime per pass:')
+  pass_times = collections.Counter()
+  for c in compilations:
+    for p in c.passes:
+      pass_times[p.name] += p.duration_ns
+  for name, duration in pass_times.most_common(top):
+    print('  %s %s' % (Ms(duration), name))
+
+  print('\nReasons for not inlining:')
+  reasons = collections.Counter()
+  for c in compilations:
+    for i in c.inlinings:
+      if not i.inlined:
+        reasons[i.reason or 'unknown'] += 1
+  for reason, count in reasons.most_common(top):
+    print('  %6d %s' % (count, reason))
+
+  deoptimized = {}
+  for c in compilations:
+    if c.deoptimizations != 0:
+      deoptimized[c.method] = max(deoptimized.get(c.method, 0), c.deoptimizations)
+  if deoptimized:
+    print('\nMethods recompiled after deoptimizations:')
+    for method, count in sorted(deoptimized.items(), key=lambda e: e[1], reverse=True)[:top]:
+      print('  %6d %s' % (count, method))
+
+
+def PrintMethod(compilations, method):
+  matches = [c for c in compilations if method in c.method]
+  if not matches:
+    print('No compilation of %s' % method)
+    return
+  for c in matches:
+    print('%s at %s: %s, %s, compile time %s, queue wait %s, %d bytes, %d deoptimizations' % (
+        c.method, Ms(c.time_stamp_ns), c.kind, 'succeeded' if c.success else 'failed',
+        Ms(c.compile_time_ns), Ms(c.queue_wait_ns), c.code_size, c.deoptimizations))
+    print('  Passes:')
+    for p in c.passes:
+      print('    %s %s' % (Ms(p.duration_ns), p.name))
+    print('  Inlining:')
+    for i in c.inlinings:
+      status = 'inlined' if i.inlined else 'not inlined (%s)' % (i.reason or 'unknown')
+      print('    %s%s: %s' % ('  ' * i.depth, i.callee, status))
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__)
+  parser.add_argument('log', help='jit-events-PID.log file')
+  parser.add_argument('--method', help='show the compilations of methods containing METHOD')
+  parser.add_argument('--top', type=int, default=10, help='number of entries in each list')
+  args = parser.parse_args()
+
+  with open(args.log, 'rb') as f:
+    data = f.read()
+  try:
+    pid, compilations = ParseLog(data)
+  except FormatError as e:
+    sys.exit('%s: %s' % (args.log, e))
+
+  if args.method:
+    PrintMethod(compilations, args.method)
+  else:
+    PrintSummary(pid, compilations, args.top)
+
+
+if __name__ == '__main__':
+  main()
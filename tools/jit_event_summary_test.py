@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2020 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Tests for jit-event-summary.py."""
+
+import contextlib
+import importlib.util
+import io
+import os
+import struct
+import unittest
+
+_SPEC = importlib.util.spec_from_file_location(
+    'jit_event_summary', os.path.join(os.path.dirname(__file__), 'jit-event-summary.py'))
+jit_event_summary = importlib.util.module_from_spec(_SPEC)
+_SPEC.loader.exec_module(jit_event_summary)
+
+
+def Uleb128(value):
+  result = bytearray()
+  while True:
+    byte = value & 0x7f
+    value >>= 7
+    if value != 0:
+      result.append(byte | 0x80)
+    else:
+      result.append(byte)
+      return bytes(result)
+
+
+class LogWriter(object):
+  """Writes a log in the format of compiler/jit/jit_logger.cc."""
+
+  def __init__(self, pid=1234, magic=0x56454A41, version=1):
+    self._data = bytearray(struct.pack('<IIIIQ', magic, version, pid, 0, 0))
+    self._strings = {}
+
+  def String(self, value):
+    if value is None:
+      return 0
+    if value not in self._strings:
+      self._strings[value] = len(self._strings) + 1
+      encoded = value.encode('utf-8')
+      self._data += bytes([1]) + Uleb128(self._strings[value]) + Uleb128(len(encoded)) + encoded
+    return self._strings[value]
+
+  def Compilation(self, method, kind, success, queue_wait_ns, compile_time_ns, code_size,
+                  deoptimizations, passes=(), inlinings=()):
+    fields = [0, 42, self.String(method), kind, 1 if success else 0, queue_wait_ns,
+              compile_time_ns, code_size, deoptimizations, len(passes)]
+    for name, duration_ns in passes:
+      fields += [self.String(name), duration_ns]
+    fields.append(len(inlinings))
+    for depth, inlined, callee, reason in inlinings:
+      fields += [depth, 1 if inlined else 0, self.String(callee), self.String(reason)]
+    self._data += bytes([2]) + b''.join(Uleb128(field) for field in fields)
+
+  def Data(self):
+    return bytes(self._data)
+
+
+class JitEventSummaryTest(unittest.TestCase):
+
+  def WriteLog(self):
+    writer = LogWriter()
+    writer.Compilation('int Main.foo(int)', 3, True, 1000, 300000, 200, 2,
+                       passes=[('GVN', 150), ('dead_code_elimination', 10)],
+                       inlinings=[(0, True, 'int Main.bar()', None),
+                                  (1, False, 'int Main.baz()', 'NotInlinedInstructionBudget')])
+    writer.Compilation('int Main.foo(int)', 1, False, 5, 7, 0, 0)
+    writer.Compilation('void Main.loop()', 0, True, 0, 1 << 40, 64, 0)
+    return writer.Data()
+
+  def testParseLog(self):
+    pid, compilations = jit_event_summary.ParseLog(self.WriteLog())
+    self.assertEqual(1234, pid)
+    self.assertEqual(3, len(compilations))
+
+    first = compilations[0]
+    self.assertEqual('int Main.foo(int)', first.method)
+    self.assertEqual('optimized', first.kind)
+    self.assertEqual(42, first.tid)
+    self.assertTrue(first.success)
+    self.assertEqual(1000, first.queue_wait_ns)
+    self.assertEqual(300000, first.compile_time_ns)
+    self.assertEqual(200, first.code_size)
+    self.assertEqual(2, first.deoptimizations)
+    self.assertEqual([('GVN', 150), ('dead_code_elimination', 10)],
+                     [(p.name, p.duration_ns) for p in first.passes])
+    self.assertEqual([(0, True, 'int Main.bar()', None),
+                      (1, False, 'int Main.baz()', 'NotInlinedInstructionBudget')],
+                     [tuple(i) for i in first.inlinings])
+
+    second = compilations[1]
+    self.assertEqual('int Main.foo(int)', second.method)
+    self.assertEqual('baseline', second.kind)
+    self.assertFalse(second.success)
+    self.assertEqual([], second.passes)
+    self.assertEqual([], second.inlinings)
+
+    third = compilations[2]
+    self.assertEqual('osr', third.kind)
+    self.assertEqual(1 << 40, third.compile_time_ns)
+
+  def testBadMagic(self):
+    with self.assertRaises(jit_event_summary.FormatError):
+      jit_event_summary.ParseLog(LogWriter(magic=0).Data())
+
+  def testBadVersion(self):
+    with self.assertRaises(jit_event_summary.FormatError):
+      jit_event_summary.ParseLog(LogWriter(version=2).Data())
+
+  def testTruncatedLog(self):
+    with self.assertRaises(jit_event_summary.FormatError):
+      jit_event_summary.ParseLog(self.WriteLog()[:-1])
+
+  def testUnknownRecord(self):
+    with self.assertRaises(jit_event_summary.FormatError):
+      jit_event_summary.ParseLog(LogWriter().Data() + bytes([3]))
+
+  def testPrintSummary(self):
+    pid, compilations = jit_event_summary.ParseLog(self.WriteLog())
+    output = io.StringIO()
+    with contextlib.redirect_stdout(output):
+      jit_event_summary.PrintSummary(pid, compilations, top=10)
+    text = output.getvalue()
+    self.assertIn('JIT event log of pid 1234: 3 compilations', text)
+    self.assertIn('baseline        1 compilations (1 failed)', text)
+    self.assertIn('1 NotInlinedInstructionBudget', text)
+    self.assertIn('2 int Main.foo(int)', text)
+
+  def testPrintMethod(self):
+    _, compilations = jit_event_summary.ParseLog(self.WriteLog())
+    output = io.StringIO()
+    with contextlib.redirect_stdout(output):
+      jit_event_summary.PrintMethod(compilations, 'Main.foo')
+    text = output.getvalue()
+    self.assertIn('optimized, succeeded', text)
+    self.assertIn('baseline, failed', text)
+    self.assertIn('    int Main.bar(): inlined', text)
+    self.assertIn('      int Main.baz(): not inlined (NotInlinedInstructionBudget)', text)
+
+
+if __name__ == '__main__':
+  unittest.main()